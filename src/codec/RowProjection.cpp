@@ -0,0 +1,102 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "codec/RowProjection.h"
+#include "codec/RowReaderV2.h"
+
+namespace nebula {
+
+RowProjection::RowProjection(const meta::SchemaProviderIf* schema,
+                             const std::vector<std::string>& props)
+        : schema_(schema)
+        , ver_(schema->getVersion()) {
+    size_t numNullables = schema_->getNumNullableFields();
+    size_t numNullBytes = numNullables > 0 ? ((numNullables - 1) >> 3) + 1 : 0;
+    minLen_ = numNullBytes;
+    columns_.resize(props.size());
+    for (size_t i = 0; i < props.size(); i++) {
+        auto index = schema_->getFieldIndex(props[i]);
+        if (index < 0) {
+            continue;
+        }
+        auto field = schema_->field(index);
+        auto& col = columns_[i];
+        col.exist = true;
+        col.type = field->type();
+        col.offset = numNullBytes + field->offset();
+        col.size = field->size();
+        if (field->nullable()) {
+            auto pos = field->nullFlagPos();
+            col.nullByte = pos >> 3;
+            col.nullMask = 0x80 >> (pos & 0x07);
+        }
+        minLen_ = std::max(minLen_, col.offset + col.size);
+    }
+}
+
+bool RowProjection::check(folly::StringPiece row) const {
+    if (row.empty() || (row[0] & 0x18) != 0x08) {
+        return false;
+    }
+    size_t numVerBytes = row[0] & 0x07;
+    if (row.size() < numVerBytes + 1 + minLen_) {
+        return false;
+    }
+    SchemaVer ver = 0;
+    if (numVerBytes > 0) {
+        memcpy(reinterpret_cast<void*>(&ver), row.data() + 1, numVerBytes);
+    }
+    return ver == ver_;
+}
+
+bool RowProjection::decode(folly::StringPiece row, std::vector<Value>& values) const {
+    if (!check(row)) {
+        return false;
+    }
+    size_t headerLen = (row[0] & 0x07) + 1;
+    values.resize(columns_.size());
+    for (size_t i = 0; i < columns_.size(); i++) {
+        const auto& col = columns_[i];
+        if (!col.exist) {
+            values[i] = Value(NullType::UNKNOWN_PROP);
+        } else if (isNull(row, headerLen, col)) {
+            values[i] = Value(NullType::__NULL__);
+        } else {
+            values[i] = RowReaderV2::decodeValue(row, headerLen + col.offset, col.type, col.size);
+        }
+    }
+    return true;
+}
+
+bool RowProjection::getStr(folly::StringPiece row, size_t idx, folly::StringPiece& str) const {
+    DCHECK_LT(idx, columns_.size());
+    const auto& col = columns_[idx];
+    size_t headerLen = (row[0] & 0x07) + 1;
+    if (!col.exist || isNull(row, headerLen, col)) {
+        return false;
+    }
+    size_t offset = headerLen + col.offset;
+    if (col.type == meta::cpp2::PropertyType::FIXED_STRING) {
+        str = row.subpiece(offset, col.size);
+        return true;
+    }
+    if (col.type != meta::cpp2::PropertyType::STRING) {
+        return false;
+    }
+    int32_t strOffset;
+    int32_t strLen;
+    memcpy(reinterpret_cast<void*>(&strOffset), row.data() + offset, sizeof(int32_t));
+    memcpy(reinterpret_cast<void*>(&strLen), row.data() + offset + sizeof(int32_t),
+           sizeof(int32_t));
+    if (strOffset < 0 || strLen < 0 ||
+        static_cast<size_t>(strOffset) + static_cast<size_t>(strLen) > row.size()) {
+        return false;
+    }
+    str = folly::StringPiece(row.data() + strOffset, strLen);
+    return true;
+}
+
+}  // namespace nebula
@@ -0,0 +1,72 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef CODEC_ROWPROJECTION_H_
+#define CODEC_ROWPROJECTION_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+#include "common/meta/SchemaProviderIf.h"
+
+namespace nebula {
+
+/**
+ * RowProjection decodes a list of props from the rows encoded by RowWriterV2 with one schema.
+ * The offsets, types and null flags of the props are resolved once when it is built, instead of
+ * looking up the field by name and asking the schema for each prop of each row like RowReader.
+ * So it is supposed to be built once for each (schema version, prop list), and used for all rows
+ * of the schema.
+ * */
+class RowProjection final {
+public:
+    RowProjection(const meta::SchemaProviderIf* schema, const std::vector<std::string>& props);
+
+    const meta::SchemaProviderIf* schema() const {
+        return schema_;
+    }
+
+    size_t size() const {
+        return columns_.size();
+    }
+
+    // Check whether the row is encoded by RowWriterV2 with the schema of the projection
+    bool check(folly::StringPiece row) const;
+
+    // Decode the props of the row into values in order, the values are owned by the caller, so
+    // they could be reused for all rows. The prop not in the schema is NullType::UNKNOWN_PROP,
+    // the same as RowReader. Return false if the row could not be decoded by the projection.
+    bool decode(folly::StringPiece row, std::vector<Value>& values) const;
+
+    // Return the STRING or FIXED_STRING prop at idx as a view of the row, instead of copying it
+    // into a Value. Return false if the prop is null, or not a string. The row must have passed
+    // the check.
+    bool getStr(folly::StringPiece row, size_t idx, folly::StringPiece& str) const;
+
+private:
+    struct Column {
+        bool                        exist{false};
+        meta::cpp2::PropertyType    type{meta::cpp2::PropertyType::UNKNOWN};
+        // offset of the field after the header, the null flags are counted in
+        size_t                      offset{0};
+        size_t                      size{0};
+        // the null flag is in the byte at nullByte after the header, mask is 0 if not nullable
+        size_t                      nullByte{0};
+        uint8_t                     nullMask{0};
+    };
+
+    bool isNull(folly::StringPiece row, size_t headerLen, const Column& col) const {
+        return col.nullMask != 0 && (row[headerLen + col.nullByte] & col.nullMask) != 0;
+    }
+
+    const meta::SchemaProviderIf*   schema_;
+    SchemaVer                       ver_;
+    std::vector<Column>             columns_;
+    // the row should be at least this long after the header
+    size_t                          minLen_{0};
+};
+
+}  // namespace nebula
+#endif  // CODEC_ROWPROJECTION_H_
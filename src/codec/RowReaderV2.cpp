@@ -65,92 +65,100 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
         return NullType::__NULL__;
     }
 
-    switch (field->type()) {
+    return decodeValue(data_, offset, field->type(), field->size());
+}
+
+
+Value RowReaderV2::decodeValue(folly::StringPiece data,
+                               size_t offset,
+                               meta::cpp2::PropertyType type,
+                               size_t size) noexcept {
+    switch (type) {
         case meta::cpp2::PropertyType::BOOL: {
-            if (data_[offset]) {
+            if (data[offset]) {
                 return true;
             } else {
                 return false;
             }
         }
         case meta::cpp2::PropertyType::INT8: {
-            return static_cast<int8_t>(data_[offset]);
+            return static_cast<int8_t>(data[offset]);
         }
         case meta::cpp2::PropertyType::INT16: {
             int16_t val;
-            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int16_t));
+            memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int16_t));
             return val;
         }
         case meta::cpp2::PropertyType::INT32: {
             int32_t val;
-            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int32_t));
+            memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int32_t));
             return val;
         }
         case meta::cpp2::PropertyType::INT64: {
             int64_t val;
-            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(int64_t));
+            memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(int64_t));
             return val;
         }
         case meta::cpp2::PropertyType::VID: {
             // This is to be compatible with V1, so we treat it as
             // 8-byte long string
-            return std::string(&data_[offset], sizeof(int64_t));
+            return std::string(&data[offset], sizeof(int64_t));
         }
         case meta::cpp2::PropertyType::FLOAT: {
             float val;
-            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(float));
+            memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(float));
             return val;
         }
         case meta::cpp2::PropertyType::DOUBLE: {
             double val;
-            memcpy(reinterpret_cast<void*>(&val), &data_[offset], sizeof(double));
+            memcpy(reinterpret_cast<void*>(&val), &data[offset], sizeof(double));
             return val;
         }
         case meta::cpp2::PropertyType::STRING: {
             int32_t strOffset;
             int32_t strLen;
-            memcpy(reinterpret_cast<void*>(&strOffset), &data_[offset], sizeof(int32_t));
+            memcpy(reinterpret_cast<void*>(&strOffset), &data[offset], sizeof(int32_t));
             memcpy(reinterpret_cast<void*>(&strLen),
-                   &data_[offset + sizeof(int32_t)],
+                   &data[offset + sizeof(int32_t)],
                    sizeof(int32_t));
-            if (static_cast<size_t>(strOffset) == data_.size() && strLen == 0) {
+            if (static_cast<size_t>(strOffset) == data.size() && strLen == 0) {
                 return std::string();
             }
-            CHECK_LT(strOffset, data_.size());
-            return std::string(&data_[strOffset], strLen);
+            CHECK_LT(strOffset, data.size());
+            return std::string(&data[strOffset], strLen);
         }
         case meta::cpp2::PropertyType::FIXED_STRING: {
-            return std::string(&data_[offset], field->size());
+            return std::string(&data[offset], size);
         }
         case meta::cpp2::PropertyType::TIMESTAMP: {
             Timestamp ts;
-            memcpy(reinterpret_cast<void*>(&ts), &data_[offset], sizeof(Timestamp));
+            memcpy(reinterpret_cast<void*>(&ts), &data[offset], sizeof(Timestamp));
             return ts;
         }
         case meta::cpp2::PropertyType::DATE: {
             Date dt;
-            memcpy(reinterpret_cast<void*>(&dt.year), &data_[offset], sizeof(int16_t));
+            memcpy(reinterpret_cast<void*>(&dt.year), &data[offset], sizeof(int16_t));
             memcpy(reinterpret_cast<void*>(&dt.month),
-                   &data_[offset + sizeof(int16_t)],
+                   &data[offset + sizeof(int16_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&dt.day),
-                   &data_[offset + sizeof(int16_t) + sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + sizeof(int8_t)],
                    sizeof(int8_t));
             return dt;
         }
         case meta::cpp2::PropertyType::TIME: {
             Time t;
             memcpy(reinterpret_cast<void*>(&t.hour),
-                   &data_[offset],
+                   &data[offset],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&t.minute),
-                   &data_[offset + sizeof(int8_t)],
+                   &data[offset + sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&t.sec),
-                   &data_[offset + 2 * sizeof(int8_t)],
+                   &data[offset + 2 * sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&t.microsec),
-                   &data_[offset + 3 * sizeof(int8_t)],
+                   &data[offset + 3 * sizeof(int8_t)],
                    sizeof(int32_t));
             return t;
         }
@@ -163,24 +171,24 @@ Value RowReaderV2::getValueByIndex(const int64_t index) const noexcept {
             int8_t minute;
             int8_t sec;
             int32_t microsec;
-            memcpy(reinterpret_cast<void*>(&year), &data_[offset], sizeof(int16_t));
+            memcpy(reinterpret_cast<void*>(&year), &data[offset], sizeof(int16_t));
             memcpy(reinterpret_cast<void*>(&month),
-                   &data_[offset + sizeof(int16_t)],
+                   &data[offset + sizeof(int16_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&day),
-                   &data_[offset + sizeof(int16_t) + sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&hour),
-                   &data_[offset + sizeof(int16_t) + 2 * sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + 2 * sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&minute),
-                   &data_[offset + sizeof(int16_t) + 3 * sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + 3 * sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&sec),
-                   &data_[offset + sizeof(int16_t) + 4 * sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + 4 * sizeof(int8_t)],
                    sizeof(int8_t));
             memcpy(reinterpret_cast<void*>(&microsec),
-                   &data_[offset + sizeof(int16_t) + 5 * sizeof(int8_t)],
+                   &data[offset + sizeof(int16_t) + 5 * sizeof(int8_t)],
                    sizeof(int32_t));
             dt.year = year;
             dt.month = month;
@@ -40,6 +40,13 @@ public:
         return headerLen_;
     }
 
+    // Decode the field of `type' at `offset' of the row, the null flag of the field should have
+    // been checked by the caller. `size' is only used by FIXED_STRING.
+    static Value decodeValue(folly::StringPiece data,
+                             size_t offset,
+                             meta::cpp2::PropertyType type,
+                             size_t size) noexcept;
+
 protected:
     bool resetImpl(meta::SchemaProviderIf const* schema, folly::StringPiece row)
         noexcept override;
@@ -11,12 +11,14 @@
 #include "codec/test/RowWriterV1.h"
 #include "codec/RowWriterV2.h"
 #include "codec/RowReaderWrapper.h"
+#include "codec/RowProjection.h"
 
 using nebula::SchemaWriter;
 using nebula::RowWriterV1;
 using nebula::RowWriterV2;
 using nebula::RowReader;
 using nebula::RowReaderWrapper;
+using nebula::RowProjection;
 using nebula::meta::cpp2::PropertyType;
 
 SchemaWriter schemaShort;
@@ -30,6 +32,11 @@ std::string dataLongV2;     // NOLINT
 std::vector<size_t> shortRandom;
 std::vector<size_t> longRandom;
 
+// a few columns of the wide schema, which is what a query usually asks for
+const std::vector<std::string> projectedCols = {  // NOLINT
+    "col02", "col06", "col75", "col140", "col144"
+};
+
 const double e = 2.71828182845904523536028747135266249775724709369995;
 const float pi = 3.14159265358979;
 const std::string str = "Hello world!"; // NOLINT
@@ -166,6 +173,48 @@ void randomTest(SchemaWriter* schema,
 }
 
 
+void projectByName(SchemaWriter* schema, const std::string& encoded, size_t iters) {
+    for (size_t i = 0; i < iters; i++) {
+        auto reader = RowReaderWrapper::getRowReader(schema, encoded);
+        for (const auto& col : projectedCols) {
+            auto v = reader->getValueByName(col);
+            folly::doNotOptimizeAway(v);
+        }
+    }
+}
+
+
+void projectByProjection(SchemaWriter* schema, const std::string& encoded, size_t iters) {
+    RowProjection projection(schema, projectedCols);
+    std::vector<nebula::Value> values;
+    for (size_t i = 0; i < iters; i++) {
+        projection.decode(encoded, values);
+        folly::doNotOptimizeAway(values);
+    }
+}
+
+
+void projectStrByName(SchemaWriter* schema, const std::string& encoded, size_t iters) {
+    for (size_t i = 0; i < iters; i++) {
+        auto reader = RowReaderWrapper::getRowReader(schema, encoded);
+        auto v = reader->getValueByName("col144");
+        folly::doNotOptimizeAway(v);
+    }
+}
+
+
+void projectStrView(SchemaWriter* schema, const std::string& encoded, size_t iters) {
+    RowProjection projection(schema, {"col144"});
+    folly::StringPiece v;
+    for (size_t i = 0; i < iters; i++) {
+        if (projection.check(encoded)) {
+            projection.getStr(encoded, 0, v);
+        }
+        folly::doNotOptimizeAway(v);
+    }
+}
+
+
 /*************************
  * Begining of Tests
  ************************/
@@ -184,6 +233,22 @@ TEST(RowReader, RandomShort) {
 TEST(RowReader, RandomLong) {
     randomTest(&schemaLong, dataLongV1, dataLongV2, longRandom);
 }
+
+TEST(RowReader, ProjectionLong) {
+    auto reader = RowReaderWrapper::getRowReader(&schemaLong, dataLongV2);
+    RowProjection projection(&schemaLong, projectedCols);
+    std::vector<nebula::Value> values;
+    ASSERT_TRUE(projection.decode(dataLongV2, values));
+    ASSERT_EQ(projectedCols.size(), values.size());
+    for (size_t i = 0; i < projectedCols.size(); i++) {
+        EXPECT_EQ(reader->getValueByName(projectedCols[i]), values[i]);
+    }
+    folly::StringPiece view;
+    ASSERT_TRUE(projection.getStr(dataLongV2, 4, view));
+    EXPECT_EQ(str, view);
+    // the projection is only for rows encoded by RowWriterV2
+    EXPECT_FALSE(projection.decode(dataLongV1, values));
+}
 /*************************
  * End of Tests
  ************************/
@@ -225,6 +290,24 @@ BENCHMARK(random_read_long_v1, iters) {
 BENCHMARK_RELATIVE(random_read_long_v2, iters) {
     randomRead(&schemaLong, dataLongV2, longRandom, iters);
 }
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(project_long_by_name, iters) {
+    projectByName(&schemaLong, dataLongV2, iters);
+}
+BENCHMARK_RELATIVE(project_long_by_projection, iters) {
+    projectByProjection(&schemaLong, dataLongV2, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(project_str_by_name, iters) {
+    projectStrByName(&schemaLong, dataLongV2, iters);
+}
+BENCHMARK_RELATIVE(project_str_view, iters) {
+    projectStrView(&schemaLong, dataLongV2, iters);
+}
 /*************************
  * End of benchmarks
  ************************/
@@ -8,6 +8,8 @@
 #include "common/datatypes/Value.h"
 #include <gtest/gtest.h>
 #include "codec/RowReaderWrapper.h"
+#include "codec/RowProjection.h"
+#include "codec/RowWriterV2.h"
 #include "codec/test/SchemaWriter.h"
 
 namespace nebula {
@@ -346,6 +348,56 @@ TEST(RowReaderV2, iterator) {
     EXPECT_EQ(64, index);
 }
 
+
+TEST(RowReaderV2, projection) {
+    SchemaWriter schema(3);
+    schema.appendCol("int_col", PropertyType::INT64);
+    schema.appendCol("str_col", PropertyType::STRING, 0, true);
+    schema.appendCol("fixed_str_col", PropertyType::FIXED_STRING, 8);
+    schema.appendCol("double_col", PropertyType::DOUBLE, 0, true);
+
+    RowWriterV2 writer(&schema);
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.set(0, 100L));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.set(1, std::string("Hello World!")));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.set(2, std::string("Welcome")));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.setNull(3));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+    auto encoded = writer.moveEncodedStr();
+
+    RowProjection projection(&schema, {"double_col", "not_exist", "str_col", "int_col",
+                                       "fixed_str_col"});
+    std::vector<Value> values;
+    ASSERT_TRUE(projection.decode(encoded, values));
+    ASSERT_EQ(5, values.size());
+    EXPECT_EQ(Value(NullType::__NULL__), values[0]);
+    EXPECT_EQ(Value(NullType::UNKNOWN_PROP), values[1]);
+    EXPECT_EQ("Hello World!", values[2].getStr());
+    EXPECT_EQ(100, values[3].getInt());
+
+    // the same as what RowReader gets
+    auto reader = RowReaderWrapper::getRowReader(&schema, encoded);
+    ASSERT_TRUE(!!reader);
+    EXPECT_EQ(reader->getValueByName("fixed_str_col"), values[4]);
+
+    folly::StringPiece view;
+    ASSERT_TRUE(projection.getStr(encoded, 2, view));
+    EXPECT_EQ("Hello World!", view);
+    ASSERT_TRUE(projection.getStr(encoded, 4, view));
+    EXPECT_EQ(values[4].getStr(), view);
+    EXPECT_FALSE(projection.getStr(encoded, 0, view));
+    EXPECT_FALSE(projection.getStr(encoded, 1, view));
+    EXPECT_FALSE(projection.getStr(encoded, 3, view));
+
+    // the row of another schema version could not be decoded by the projection
+    SchemaWriter newSchema(4);
+    newSchema.appendCol("int_col", PropertyType::INT64);
+    RowWriterV2 newWriter(&newSchema);
+    ASSERT_EQ(WriteResult::SUCCEEDED, newWriter.set(0, 100L));
+    ASSERT_EQ(WriteResult::SUCCEEDED, newWriter.finish());
+    EXPECT_FALSE(projection.decode(newWriter.getEncodedStr(), values));
+    EXPECT_FALSE(projection.decode("", values));
+}
+
 }  // namespace nebula
 
 
@@ -33,6 +33,13 @@ public:
 using KV = std::pair<std::string, std::string>;
 using KVCallback = folly::Function<void(nebula::cpp2::ErrorCode code)>;
 using NewLeaderCallback = folly::Function<void(HostAddr nLeader)>;
+// Invoked after a batch has been applied to the engine of a part, with all keys it has put or
+// removed. If `all` is true, the batch touched data which could not be listed by key (range
+// removal, snapshot, ingestion), so everything in the part should be regarded as changed.
+using CommitCallback = std::function<void(GraphSpaceID spaceId,
+                                          PartitionID partId,
+                                          const std::vector<std::string>& keys,
+                                          bool all)>;
 
 inline rocksdb::Slice toSlice(const folly::StringPiece& str) {
     return rocksdb::Slice(str.begin(), str.size());
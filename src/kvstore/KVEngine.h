@@ -25,6 +25,10 @@ public:
 
     virtual nebula::cpp2::ErrorCode remove(folly::StringPiece key) = 0;
 
+    // Merge the operand into the value of key, by the merge operator of engine
+    virtual nebula::cpp2::ErrorCode
+    merge(folly::StringPiece key, folly::StringPiece operand) = 0;
+
     // Remove all keys in the range [start, end)
     virtual nebula::cpp2::ErrorCode
     removeRange(folly::StringPiece start, folly::StringPiece end) = 0;
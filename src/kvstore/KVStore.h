@@ -47,6 +47,11 @@ struct KVOptions {
 
     // Custom CompactionFilter used in compaction.
     std::unique_ptr<CompactionFilterFactoryBuilder> cffBuilder_{nullptr};
+
+    // Called by every part after the committed logs have been written into engine,
+    // used by the storage layer to keep its caches in sync with raft. It is called with
+    // all set as well when a part or a space is removed.
+    CommitCallback commitCb_{nullptr};
 };
 
 struct StoreCapability {
@@ -156,6 +161,14 @@ public:
                                std::vector<KV>&& keyValues,
                                KVCallback cb) = 0;
 
+    // Merge the operand into the value of key, the operand will be folded into the value by the
+    // merge operator in KVOptions lazily, so the caller doesn't need to read the value first.
+    virtual void asyncMerge(GraphSpaceID spaceId,
+                            PartitionID partId,
+                            const std::string& key,
+                            const std::string& operand,
+                            KVCallback cb) = 0;
+
     // Asynchronous version of remove methods
     virtual void asyncRemove(GraphSpaceID spaceId,
                              PartitionID partId,
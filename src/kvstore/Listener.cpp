@@ -130,7 +130,7 @@ void Listener::doApply() {
     if (isStopped()) {
         return;
     }
-    // todo(doodle): only put is handled, all remove is ignored for now
+    // todo(doodle): only put and merge are handled, all remove is ignored for now
     folly::via(executor_.get(), [this] {
         SCOPE_EXIT {
             bgWorkers_->addDelayTask(FLAGS_listener_commit_interval_secs * 1000,
@@ -149,32 +149,41 @@ void Listener::doApply() {
         LogID lastApplyId = -1;
         // the kv pair which can sync to remote safely
         std::vector<KV> data;
+        // the merge operands, which must be applied after the data put before them
+        std::vector<KV> merges;
         while (iter->valid()) {
-            lastApplyId = iter->logId();
-
             auto log = iter->logMsg();
             if (log.empty()) {
                 // skip the heartbeat
+                lastApplyId = iter->logId();
                 ++(*iter);
                 continue;
             }
 
+            std::vector<KV> logData;
+            std::vector<KV> logMerges;
             DCHECK_GE(log.size(), sizeof(int64_t) + 1 + sizeof(uint32_t));
             switch (log[sizeof(int64_t)]) {
                 case OP_PUT: {
                     auto pieces = decodeMultiValues(log);
                     DCHECK_EQ(2, pieces.size());
-                    data.emplace_back(pieces[0], pieces[1]);
+                    logData.emplace_back(pieces[0], pieces[1]);
                     break;
                 }
                 case OP_MULTI_PUT: {
                     auto kvs = decodeMultiValues(log);
                     DCHECK_EQ((kvs.size() + 1) / 2, kvs.size() / 2);
                     for (size_t i = 0; i < kvs.size(); i += 2) {
-                        data.emplace_back(kvs[i], kvs[i + 1]);
+                        logData.emplace_back(kvs[i], kvs[i + 1]);
                     }
                     break;
                 }
+                case OP_MERGE: {
+                    auto pieces = decodeMultiValues(log);
+                    DCHECK_EQ(2, pieces.size());
+                    logMerges.emplace_back(pieces[0], pieces[1]);
+                    break;
+                }
                 case OP_REMOVE:
                 case OP_REMOVE_RANGE:
                 case OP_MULTI_REMOVE: {
@@ -183,9 +192,11 @@ void Listener::doApply() {
                 case OP_BATCH_WRITE: {
                     auto batch = decodeBatchValue(log);
                     for (auto& op : batch) {
-                        // OP_BATCH_PUT and OP_BATCH_REMOVE_RANGE is igored
+                        // OP_BATCH_REMOVE and OP_BATCH_REMOVE_RANGE is igored
                         if (op.first == BatchLogType::OP_BATCH_PUT) {
-                            data.emplace_back(op.second.first, op.second.second);
+                            logData.emplace_back(op.second.first, op.second.second);
+                        } else if (op.first == BatchLogType::OP_BATCH_MERGE) {
+                            logMerges.emplace_back(op.second.first, op.second.second);
                         }
                     }
                     break;
@@ -201,14 +212,25 @@ void Listener::doApply() {
                 }
             }
 
-            if (static_cast<int32_t>(data.size()) > FLAGS_listener_commit_batch_size) {
+            // The data are applied before the merges of a round, so the log is left to the next
+            // round if it would put after the merges of the previous logs, or merge after their
+            // data. The merges of a batch are always applied after its data.
+            if ((!logData.empty() && !merges.empty()) || (!logMerges.empty() && !data.empty())) {
+                break;
+            }
+            lastApplyId = iter->logId();
+            std::move(logData.begin(), logData.end(), std::back_inserter(data));
+            std::move(logMerges.begin(), logMerges.end(), std::back_inserter(merges));
+
+            if (static_cast<int32_t>(data.size() + merges.size()) >
+                    FLAGS_listener_commit_batch_size) {
                 break;
             }
             ++(*iter);
         }
 
         // apply to state machine
-        if (apply(data)) {
+        if (apply(data) && (merges.empty() || applyMerge(merges))) {
             std::lock_guard<std::mutex> guard(raftLock_);
             lastApplyLogId_ = lastApplyId;
             persist(committedLogId_, term_, lastApplyLogId_);
@@ -79,6 +79,10 @@ derived class.
     // apply the kv to state machine
     bool apply(const std::vector<KV>& data)
 
+    // apply the merge operands (key, operand) to state machine, they are always applied after the
+    // kv put by the logs before them
+    bool applyMerge(const std::vector<KV>& operands)
+
     // persist last commit log id/term and lastApplyId
     bool persist(LogID, TermID, LogID)
 
@@ -129,6 +133,8 @@ protected:
 
     virtual bool apply(const std::vector<KV>& data) = 0;
 
+    virtual bool applyMerge(const std::vector<KV>& operands) = 0;
+
     virtual bool persist(LogID, TermID, LogID) = 0;
 
     void onLostLeadership(TermID) override {
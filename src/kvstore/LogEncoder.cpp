@@ -15,6 +15,7 @@ namespace nebula {
 namespace kvstore {
 
 constexpr auto kHeadLen = sizeof(int64_t) + 1 + sizeof(uint32_t);
+constexpr folly::StringPiece kSstChunkMagic("\0\0\0\0", 4);
 
 std::string encodeKV(const folly::StringPiece& key,
                      const folly::StringPiece& val) {
@@ -37,6 +38,34 @@ std::pair<folly::StringPiece, folly::StringPiece> decodeKV(const std::string& da
     return std::make_pair(key, val);
 }
 
+std::string encodeSstChunk(const std::string& file, int64_t offset, folly::StringPiece chunk) {
+    std::string key;
+    key.reserve(kSstChunkMagic.size() + sizeof(int64_t) + file.size());
+    key.append(kSstChunkMagic.data(), kSstChunkMagic.size());
+    key.append(reinterpret_cast<const char*>(&offset), sizeof(int64_t));
+    key.append(file);
+    return encodeKV(key, chunk);
+}
+
+bool decodeSstChunk(const std::string& row,
+                    std::string& file,
+                    int64_t& offset,
+                    folly::StringPiece& chunk) {
+    if (row.size() < sizeof(uint32_t) * 2) {
+        return false;
+    }
+    auto kv = decodeKV(row);
+    auto key = kv.first;
+    if (key.size() <= kSstChunkMagic.size() + sizeof(int64_t) || !key.startsWith(kSstChunkMagic)) {
+        return false;
+    }
+    memcpy(reinterpret_cast<void*>(&offset), key.data() + kSstChunkMagic.size(), sizeof(int64_t));
+    file.assign(key.data() + kSstChunkMagic.size() + sizeof(int64_t),
+                key.size() - kSstChunkMagic.size() - sizeof(int64_t));
+    chunk = kv.second;
+    return true;
+}
+
 std::string encodeSingleValue(LogType type, folly::StringPiece val) {
     std::string encoded;
     encoded.reserve(val.size() + kHeadLen);
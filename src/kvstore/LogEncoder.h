@@ -23,12 +23,14 @@ enum LogType : char {
     OP_ADD_PEER       = 0x09,
     OP_REMOVE_PEER    = 0x10,
     OP_BATCH_WRITE    = 0x11,
+    OP_MERGE          = 0x12,
 };
 
 enum BatchLogType : char {
     OP_BATCH_PUT            = 0x1,
     OP_BATCH_REMOVE         = 0x2,
     OP_BATCH_REMOVE_RANGE   = 0x3,
+    OP_BATCH_MERGE          = 0x4,
 };
 
 std::string encodeKV(const folly::StringPiece& key,
@@ -36,6 +38,16 @@ std::string encodeKV(const folly::StringPiece& key,
 
 std::pair<folly::StringPiece, folly::StringPiece> decodeKV(const std::string& data);
 
+// When the snapshot is sent in sst files, each row of the snapshot carries a chunk of the file
+// starting at offset. The key of the row starts with 4 zero bytes, which is not a valid key.
+std::string encodeSstChunk(const std::string& file, int64_t offset, folly::StringPiece chunk);
+
+// Return false if the row is a normal key-value pair
+bool decodeSstChunk(const std::string& row,
+                    std::string& file,
+                    int64_t& offset,
+                    folly::StringPiece& chunk);
+
 std::string encodeSingleValue(LogType type, folly::StringPiece val);
 folly::StringPiece decodeSingleValue(folly::StringPiece encoded);
 
@@ -84,6 +96,13 @@ public:
         batch_.emplace_back(std::move(op));
     }
 
+    void merge(std::string&& key, std::string&& operand) {
+        auto op = std::make_tuple(BatchLogType::OP_BATCH_MERGE,
+                                  std::forward<std::string>(key),
+                                  std::forward<std::string>(operand));
+        batch_.emplace_back(std::move(op));
+    }
+
     void clear() {
         batch_.clear();
     }
@@ -14,6 +14,7 @@
 #include "common/network/NetworkUtils.h"
 #include "kvstore/RocksEngine.h"
 #include "kvstore/SnapshotManagerImpl.h"
+#include "kvstore/StartupProgress.h"
 
 DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
 DEFINE_int32(custom_filter_interval_secs, 24 * 3600,
@@ -21,6 +22,9 @@ DEFINE_int32(custom_filter_interval_secs, 24 * 3600,
 DEFINE_int32(num_workers, 4, "Number of worker threads");
 DEFINE_int32(clean_wal_interval_secs, 600, "inerval to trigger clean expired wal");
 DEFINE_bool(auto_remove_invalid_space, false, "whether remove data of invalid space when restart");
+DEFINE_int32(num_load_threads, 8,
+             "Number of threads to open the engines and the parts concurrently when starting, "
+             "which also bounds the memory used by loading");
 
 DECLARE_bool(rocksdb_disable_wal);
 DECLARE_int32(rocksdb_backup_interval_secs);
@@ -77,100 +81,143 @@ bool NebulaStore::init() {
     return true;
 }
 
+namespace {
+
+// Call func with each index in [0, num), by at most concurrency threads
+void runConcurrently(size_t num, int32_t concurrency, const std::function<void(size_t)>& func) {
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    auto numThreads = std::min<size_t>(num, std::max(concurrency, 1));
+    for (size_t i = 0; i < numThreads; i++) {
+        threads.emplace_back([&next, num, &func] {
+            for (auto idx = next.fetch_add(1); idx < num; idx = next.fetch_add(1)) {
+                func(idx);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+}  // namespace
+
 void NebulaStore::loadPartFromDataPath() {
     CHECK(!!options_.partMan_);
     LOG(INFO) << "Scan the local path, and init the spaces_";
-    std::unordered_set<std::pair<GraphSpaceID, PartitionID>> spacePartIdSet;
+    auto& progress = StartupProgress::instance();
+
+    // the space and the data path of each engine to open
+    std::vector<std::pair<GraphSpaceID, std::string>> spacePaths;
+    progress.begin(StartupProgress::kScanPaths);
     for (auto& path : options_.dataPaths_) {
         auto rootPath = folly::stringPrintf("%s/nebula", path.c_str());
         auto dirs = fs::FileUtils::listAllDirsInDir(rootPath.c_str());
         for (auto& dir : dirs) {
             LOG(INFO) << "Scan path \"" << rootPath << "/" << dir << "\"";
+            GraphSpaceID spaceId;
             try {
-                GraphSpaceID spaceId;
-                try {
-                    spaceId = folly::to<GraphSpaceID>(dir);
-                } catch (const std::exception& ex) {
-                    LOG(ERROR) << "Data path invalid: " << ex.what();
-                    continue;
-                }
-
-                if (!options_.partMan_->spaceExist(storeSvcAddr_, spaceId).ok()) {
-                    if (FLAGS_auto_remove_invalid_space) {
-                        auto spaceDir = folly::stringPrintf("%s/%s", rootPath.c_str(), dir.c_str());
-                        removeSpaceDir(spaceDir);
-                    }
-                    continue;
-                }
+                spaceId = folly::to<GraphSpaceID>(dir);
+            } catch (const std::exception& ex) {
+                LOG(ERROR) << "Data path invalid: " << ex.what();
+                continue;
+            }
 
-                KVEngine* enginePtr = nullptr;
-                {
-                    folly::RWSpinLock::WriteHolder wh(&lock_);
-                    auto engine = newEngine(spaceId, path, options_.walPath_);
-                    auto spaceIt = this->spaces_.find(spaceId);
-                    if (spaceIt == this->spaces_.end()) {
-                        LOG(INFO) << "Load space " << spaceId << " from disk";
-                        spaceIt = this->spaces_.emplace(
-                            spaceId,
-                            std::make_unique<SpacePartInfo>()).first;
-                    }
-                    spaceIt->second->engines_.emplace_back(std::move(engine));
-                    enginePtr = spaceIt->second->engines_.back().get();
+            if (!options_.partMan_->spaceExist(storeSvcAddr_, spaceId).ok()) {
+                if (FLAGS_auto_remove_invalid_space) {
+                    auto spaceDir = folly::stringPrintf("%s/%s", rootPath.c_str(), dir.c_str());
+                    removeSpaceDir(spaceDir);
                 }
+                continue;
+            }
+            spacePaths.emplace_back(spaceId, path);
+            progress.advance(StartupProgress::kScanPaths);
+        }
+    }
+    progress.end(StartupProgress::kScanPaths);
+
+    // Open the engines of all data paths concurrently, which are added to spaces_ in the order
+    // of the data paths as before
+    std::vector<std::unique_ptr<KVEngine>> engines(spacePaths.size());
+    progress.begin(StartupProgress::kOpenEngines, spacePaths.size());
+    runConcurrently(spacePaths.size(), FLAGS_num_load_threads, [&] (size_t idx) {
+        const auto& [spaceId, path] = spacePaths[idx];
+        try {
+            engines[idx] = newEngine(spaceId, path, options_.walPath_);
+        } catch (std::exception& e) {
+            LOG(FATAL) << "Invalid data directory \"" << path << "/nebula/" << spaceId << "\"";
+        }
+        LOG(INFO) << "Open the engine of space " << spaceId << " in " << path;
+        progress.advance(StartupProgress::kOpenEngines);
+    });
+    progress.end(StartupProgress::kOpenEngines);
 
-                // partIds is the partition in this host waiting to open
-                std::vector<PartitionID> partIds;
-                for (auto& partId : enginePtr->allParts()) {
-                    if (!options_.partMan_->partExist(storeSvcAddr_, spaceId, partId).ok()) {
-                        LOG(INFO) << "Part " << partId
-                                    << " does not exist any more, remove it!";
-                        enginePtr->removePart(partId);
-                        continue;
-                    } else {
-                        auto spacePart = std::make_pair(spaceId, partId);
-                        if (spacePartIdSet.find(spacePart) == spacePartIdSet.end()) {
-                            spacePartIdSet.emplace(spacePart);
-                            partIds.emplace_back(partId);
-                        }
-                    }
-                }
-                if (partIds.empty()) {
-                    continue;
-                }
+    // partsToLoad is the partition in this host waiting to open
+    std::vector<std::tuple<GraphSpaceID, PartitionID, KVEngine*>> partsToLoad;
+    std::unordered_set<std::pair<GraphSpaceID, PartitionID>> spacePartIdSet;
+    for (size_t i = 0; i < spacePaths.size(); i++) {
+        auto spaceId = spacePaths[i].first;
+        KVEngine* enginePtr = nullptr;
+        {
+            folly::RWSpinLock::WriteHolder wh(&lock_);
+            auto spaceIt = this->spaces_.find(spaceId);
+            if (spaceIt == this->spaces_.end()) {
+                LOG(INFO) << "Load space " << spaceId << " from disk";
+                spaceIt = this->spaces_.emplace(
+                    spaceId,
+                    std::make_unique<SpacePartInfo>()).first;
+            }
+            spaceIt->second->engines_.emplace_back(std::move(engines[i]));
+            enginePtr = spaceIt->second->engines_.back().get();
+        }
 
-                std::atomic<size_t> counter(partIds.size());
-                folly::Baton<true, std::atomic> baton;
-                LOG(INFO) << "Need to open " << partIds.size() << " parts of space " << spaceId;
-                for (auto& partId : partIds) {
-                    bgWorkers_->addTask([
-                            spaceId, partId, enginePtr, &counter, &baton, this] () mutable {
-                        auto part = newPart(spaceId, partId, enginePtr, false, {});
-                        LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
-
-                        {
-                            folly::RWSpinLock::WriteHolder holder(&lock_);
-                            auto iter = spaces_.find(spaceId);
-                            CHECK(iter != spaces_.end());
-                            iter->second->parts_.emplace(partId, part);
-                        }
-                        counter.fetch_sub(1);
-                        if (counter.load() == 0) {
-                            baton.post();
-                        }
-                    });
+        for (auto& partId : enginePtr->allParts()) {
+            if (!options_.partMan_->partExist(storeSvcAddr_, spaceId, partId).ok()) {
+                LOG(INFO) << "Part " << partId
+                            << " does not exist any more, remove it!";
+                enginePtr->removePart(partId);
+                continue;
+            } else {
+                auto spacePart = std::make_pair(spaceId, partId);
+                if (spacePartIdSet.find(spacePart) == spacePartIdSet.end()) {
+                    spacePartIdSet.emplace(spacePart);
+                    partsToLoad.emplace_back(spaceId, partId, enginePtr);
                 }
-                baton.wait();
-                LOG(INFO) << "Load space " << spaceId << " complete";
-            } catch (std::exception& e) {
-                LOG(FATAL) << "Invalid data directory \"" << dir << "\"";
             }
         }
     }
+
+    // Start the parts of all spaces concurrently, the wal of each part is scanned when the part
+    // is created. The number of threads bounds the memory used by replaying the wal.
+    LOG(INFO) << "Need to open " << partsToLoad.size() << " parts";
+    progress.begin(StartupProgress::kLoadParts, partsToLoad.size());
+    runConcurrently(partsToLoad.size(), FLAGS_num_load_threads, [&] (size_t idx) {
+        auto [spaceId, partId, enginePtr] = partsToLoad[idx];
+        auto part = newPart(spaceId, partId, enginePtr, false, {});
+        LOG(INFO) << "Load part " << spaceId << ", " << partId << " from disk";
+        {
+            folly::RWSpinLock::WriteHolder holder(&lock_);
+            auto iter = spaces_.find(spaceId);
+            CHECK(iter != spaces_.end());
+            iter->second->parts_.emplace(partId, part);
+        }
+        progress.advance(StartupProgress::kLoadParts);
+    });
+    progress.end(StartupProgress::kLoadParts);
 }
 
 void NebulaStore::loadPartFromPartManager() {
     LOG(INFO) << "Init data from partManager for " << storeSvcAddr_;
+    auto& progress = StartupProgress::instance();
     auto partsMap = options_.partMan_->parts(storeSvcAddr_);
+    size_t numParts = 0;
+    for (const auto& entry : partsMap) {
+        numParts += entry.second.size();
+    }
+    progress.begin(StartupProgress::kLoadFromMeta, numParts);
+    SCOPE_EXIT {
+        progress.end(StartupProgress::kLoadFromMeta);
+    };
     for (auto& entry : partsMap) {
         auto spaceId = entry.first;
         addSpace(spaceId);
@@ -181,6 +228,7 @@ void NebulaStore::loadPartFromPartManager() {
         std::sort(partIds.begin(), partIds.end());
         for (auto& partId : partIds) {
             addPart(spaceId, partId, false);
+            progress.advance(StartupProgress::kLoadFromMeta);
         }
     }
 }
@@ -350,6 +398,9 @@ std::shared_ptr<Part> NebulaStore::newPart(GraphSpaceID spaceId,
                                        snapshot_,
                                        clientMan_,
                                        diskMan_);
+    if (options_.commitCb_ != nullptr) {
+        part->registerCommitCb(options_.commitCb_);
+    }
     std::vector<HostAddr> peers;
     if (defaultPeers.empty()) {
         // pull the information from meta
@@ -391,6 +442,9 @@ void NebulaStore::removeSpace(GraphSpaceID spaceId, bool isListener) {
                 auto parts = engine->allParts();
                 for (auto& partId : parts) {
                     engine->removePart(partId);
+                    if (options_.commitCb_ != nullptr) {
+                        options_.commitCb_(spaceId, partId, {}, true);
+                    }
                 }
                 CHECK_EQ(0, engine->totalPartsNum());
             }
@@ -435,6 +489,10 @@ void NebulaStore::removePart(GraphSpaceID spaceId, PartitionID partId) {
             partIt->second->resetPart();
             spaceIt->second->parts_.erase(partId);
             e->removePart(partId);
+            if (options_.commitCb_ != nullptr) {
+                // The part may be added back later, nothing cached for it is valid any more
+                options_.commitCb_(spaceId, partId, {}, true);
+            }
         }
     }
     LOG(INFO) << "Space " << spaceId << ", part " << partId << " has been removed!";
@@ -712,6 +770,21 @@ void NebulaStore::asyncMultiPut(GraphSpaceID spaceId,
 }
 
 
+void NebulaStore::asyncMerge(GraphSpaceID spaceId,
+                             PartitionID partId,
+                             const std::string& key,
+                             const std::string& operand,
+                             KVCallback cb) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        cb(error(ret));
+        return;
+    }
+    auto part = nebula::value(ret);
+    part->asyncMerge(key, operand, std::move(cb));
+}
+
+
 void NebulaStore::asyncRemove(GraphSpaceID spaceId,
                               PartitionID partId,
                               const std::string& key,
@@ -810,6 +883,9 @@ nebula::cpp2::ErrorCode NebulaStore::ingest(GraphSpaceID spaceId) {
                     return code;
                 }
             }
+            if (options_.commitCb_ != nullptr) {
+                options_.commitCb_(spaceId, part, {}, true);
+            }
         }
     }
     return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -1073,7 +1149,8 @@ int32_t NebulaStore::allLeader(
     return count;
 }
 
-bool NebulaStore::checkLeader(std::shared_ptr<Part> part, bool canReadFromFollower) const {
+bool NebulaStore::checkLeader(const std::shared_ptr<Part>& part,
+                              bool canReadFromFollower) const {
     return canReadFromFollower || (part->isLeader() && part->leaseValid());
 }
 
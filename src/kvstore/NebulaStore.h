@@ -195,6 +195,12 @@ public:
                        std::vector<KV>&& keyValues,
                        KVCallback cb) override;
 
+    void asyncMerge(GraphSpaceID spaceId,
+                    PartitionID partId,
+                    const std::string& key,
+                    const std::string& operand,
+                    KVCallback cb) override;
+
     void asyncRemove(GraphSpaceID spaceId,
                      PartitionID partId,
                      const std::string& key,
@@ -333,7 +339,7 @@ private:
     ErrorOr<nebula::cpp2::ErrorCode, KVEngine*>
     engine(GraphSpaceID spaceId, PartitionID partId);
 
-    bool checkLeader(std::shared_ptr<Part> part, bool canReadFromFollower = false) const;
+    bool checkLeader(const std::shared_ptr<Part>& part, bool canReadFromFollower = false) const;
 
     void cleanWAL();
 
@@ -5,6 +5,7 @@
  */
 
 #include "kvstore/Part.h"
+#include "common/fs/FileUtils.h"
 #include "kvstore/LogEncoder.h"
 #include "kvstore/RocksEngineConfig.h"
 #include "utils/NebulaKeyUtils.h"
@@ -72,6 +73,15 @@ void Part::asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback
         });
 }
 
+void Part::asyncMerge(folly::StringPiece key, folly::StringPiece operand, KVCallback cb) {
+    std::string log = encodeMultiValues(OP_MERGE, key, operand);
+
+    appendAsync(FLAGS_cluster_id, std::move(log))
+        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
+            callback(this->toResultCode(res));
+        });
+}
+
 void Part::asyncAppendBatch(std::string&& batch, KVCallback cb) {
     appendAsync(FLAGS_cluster_id, std::move(batch))
         .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
@@ -199,6 +209,10 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
     auto batch = engine_->startBatchWrite();
     LogID lastId = -1;
     TermID lastTerm = -1;
+    // Keys touched by this batch, only collected when someone cares about them
+    bool trackKeys = commitCb_ != nullptr;
+    std::vector<std::string> committedKeys;
+    bool rangeRemoved = false;
     while (iter->valid()) {
         lastId = iter->logId();
         lastTerm = iter->logTerm();
@@ -219,6 +233,22 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
                 return code;
             }
+            if (trackKeys) {
+                committedKeys.emplace_back(pieces[0].str());
+            }
+            break;
+        }
+        case OP_MERGE: {
+            auto pieces = decodeMultiValues(log);
+            DCHECK_EQ(2, pieces.size());
+            auto code = batch->merge(pieces[0], pieces[1]);
+            if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                LOG(ERROR) << idStr_ << "Failed to call WriteBatch::merge()";
+                return code;
+            }
+            if (trackKeys) {
+                committedKeys.emplace_back(pieces[0].str());
+            }
             break;
         }
         case OP_MULTI_PUT: {
@@ -231,6 +261,9 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
                     return code;
                 }
+                if (trackKeys) {
+                    committedKeys.emplace_back(kvs[i].str());
+                }
             }
             break;
         }
@@ -241,6 +274,9 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
                 return code;
             }
+            if (trackKeys) {
+                committedKeys.emplace_back(key.str());
+            }
             break;
         }
         case OP_MULTI_REMOVE: {
@@ -251,6 +287,9 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
                     return code;
                 }
+                if (trackKeys) {
+                    committedKeys.emplace_back(k.str());
+                }
             }
             break;
         }
@@ -262,6 +301,7 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::removeRange()";
                 return code;
             }
+            rangeRemoved = true;
             break;
         }
         case OP_BATCH_WRITE: {
@@ -274,11 +314,17 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
                     code = batch->remove(op.second.first);
                 } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
                     code = batch->removeRange(op.second.first, op.second.second);
+                    rangeRemoved = true;
+                } else if (op.first == BatchLogType::OP_BATCH_MERGE) {
+                    code = batch->merge(op.second.first, op.second.second);
                 }
                 if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
                     LOG(ERROR) << idStr_ << "Failed to call WriteBatch";
                     return code;
                 }
+                if (trackKeys && op.first != BatchLogType::OP_BATCH_REMOVE_RANGE) {
+                    committedKeys.emplace_back(op.second.first.str());
+                }
             }
             break;
         }
@@ -325,8 +371,14 @@ cpp2::ErrorCode Part::commitLogs(std::unique_ptr<LogIterator> iter, bool wait) {
             return code;
         }
     }
-    return engine_->commitBatchWrite(
+    auto code = engine_->commitBatchWrite(
         std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, wait);
+    if (code == nebula::cpp2::ErrorCode::SUCCEEDED &&
+        trackKeys &&
+        (rangeRemoved || !committedKeys.empty())) {
+        commitCb_(spaceId_, partId_, committedKeys, rangeRemoved);
+    }
+    return code;
 }
 
 std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>& rows,
@@ -336,16 +388,33 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
     auto batch = engine_->startBatchWrite();
     int64_t count = 0;
     int64_t size = 0;
+    std::string file;
+    int64_t offset = 0;
+    folly::StringPiece chunk;
     for (auto& row : rows) {
+        if (decodeSstChunk(row, file, offset, chunk)) {
+            bool received = false;
+            if (!writeSnapshotChunk(file, offset, chunk, received)) {
+                return std::make_pair(0, 0);
+            }
+            if (received) {
+                // Counted when it was received at the first time
+                continue;
+            }
+        } else {
+            auto kv = decodeKV(row);
+            if (nebula::cpp2::ErrorCode::SUCCEEDED != batch->put(kv.first, kv.second)) {
+                LOG(ERROR) << idStr_ << "Put failed in commit";
+                return std::make_pair(0, 0);
+            }
+        }
         count++;
         size += row.size();
-        auto kv = decodeKV(row);
-        if (nebula::cpp2::ErrorCode::SUCCEEDED != batch->put(kv.first, kv.second)) {
-            LOG(ERROR) << idStr_ << "Put failed in commit";
-            return std::make_pair(0, 0);
-        }
     }
     if (finished) {
+        if (ingestSnapshotFiles() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            return std::make_pair(0, 0);
+        }
         auto retCode = putCommitMsg(batch.get(), committedLogId, committedLogTerm);
         if (nebula::cpp2::ErrorCode::SUCCEEDED != retCode) {
             LOG(ERROR) << idStr_ << "Put failed in commit";
@@ -359,6 +428,9 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
         LOG(ERROR) << idStr_ << "Put failed in commit";
         return std::make_pair(0, 0);
     }
+    if (commitCb_ != nullptr) {
+        commitCb_(spaceId_, partId_, {}, true);
+    }
     return std::make_pair(count, size);
 }
 
@@ -371,6 +443,97 @@ Part::putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogT
     return batch->put(NebulaKeyUtils::systemCommitKey(partId_), commitMsg);
 }
 
+std::string Part::snapshotPath() const {
+    return folly::stringPrintf("%s/snapshot/recv/%d", engine_->getDataRoot(), partId_);
+}
+
+bool Part::writeSnapshotChunk(const std::string& file,
+                              int64_t offset,
+                              folly::StringPiece chunk,
+                              bool& received) {
+    auto pos = file.find('.');
+    if (pos == 0 || pos == std::string::npos || file.find('/') != std::string::npos) {
+        LOG(ERROR) << idStr_ << "Invalid snapshot file " << file;
+        return false;
+    }
+    auto dir = snapshotPath();
+    auto ts = file.substr(0, pos);
+    if (ts != snapshotTs_) {
+        // A new sending begins, the files of the previous one are useless
+        if (fs::FileUtils::exist(dir) && !fs::FileUtils::remove(dir.c_str(), true)) {
+            LOG(ERROR) << idStr_ << "Remove " << dir << " failed";
+            return false;
+        }
+        LOG(INFO) << idStr_ << "Receive the sst files of the snapshot sent at " << ts;
+        snapshotTs_ = std::move(ts);
+    }
+    if (!fs::FileUtils::exist(dir) && !fs::FileUtils::makeDir(dir)) {
+        LOG(ERROR) << idStr_ << "Make dir " << dir << " failed";
+        return false;
+    }
+    auto path = folly::stringPrintf("%s/%s", dir.c_str(), file.c_str());
+    int fd = ::open(path.c_str(), O_CREAT | O_WRONLY, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << idStr_ << "Open " << path << " failed, error: " << strerror(errno);
+        return false;
+    }
+    SCOPE_EXIT {
+        ::close(fd);
+    };
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        LOG(ERROR) << idStr_ << "Stat " << path << " failed, error: " << strerror(errno);
+        return false;
+    }
+    if (offset + static_cast<int64_t>(chunk.size()) <= st.st_size) {
+        received = true;
+        return true;
+    }
+    if (offset > st.st_size) {
+        LOG(ERROR) << idStr_ << "Missing chunks of " << path << ", received " << st.st_size
+                   << " bytes, but the chunk starts at " << offset;
+        return false;
+    }
+    // The chunk is rewritten if it was written partially
+    size_t written = 0;
+    while (written < chunk.size()) {
+        auto len = ::pwrite(fd, chunk.data() + written, chunk.size() - written, offset + written);
+        if (len < 0) {
+            LOG(ERROR) << idStr_ << "Write " << path << " failed, error: " << strerror(errno);
+            return false;
+        }
+        written += len;
+    }
+    received = false;
+    return true;
+}
+
+nebula::cpp2::ErrorCode Part::ingestSnapshotFiles() {
+    auto dir = snapshotPath();
+    if (!fs::FileUtils::exist(dir)) {
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    // Only the files of the current sending, in case any others are left
+    auto pattern = folly::stringPrintf("%s.*.sst", snapshotTs_.c_str());
+    auto files = snapshotTs_.empty()
+        ? std::vector<std::string>()
+        : fs::FileUtils::listAllFilesInDir(dir.c_str(), true, pattern.c_str());
+    if (!files.empty()) {
+        LOG(INFO) << idStr_ << "Ingest " << files.size() << " sst files of snapshot";
+        auto code = engine_->ingest(files);
+        if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            LOG(ERROR) << idStr_ << "Ingest snapshot failed, error "
+                       << static_cast<int32_t>(code);
+            return code;
+        }
+    }
+    if (!fs::FileUtils::remove(dir.c_str(), true)) {
+        LOG(WARNING) << idStr_ << "Remove " << dir << " failed";
+    }
+    snapshotTs_.clear();
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
 bool Part::preProcessLog(LogID logId,
                          TermID termId,
                          ClusterID clusterId,
@@ -447,6 +610,12 @@ void Part::cleanup() {
         LOG(WARNING) << idStr_ << "Remove the committedLogId failed, error "
                      << static_cast<int32_t>(res);
     }
+    // Drop the sst files left by a snapshot which was not finished
+    auto dir = snapshotPath();
+    if (fs::FileUtils::exist(dir) && !fs::FileUtils::remove(dir.c_str(), true)) {
+        LOG(WARNING) << idStr_ << "Remove " << dir << " failed";
+    }
+    snapshotTs_.clear();
     return;
 }
 
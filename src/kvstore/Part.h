@@ -46,6 +46,8 @@ public:
     void asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback cb);
     void asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb);
 
+    void asyncMerge(folly::StringPiece key, folly::StringPiece operand, KVCallback cb);
+
     void asyncRemove(folly::StringPiece key, KVCallback cb);
     void asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb);
     void asyncRemoveRange(folly::StringPiece start,
@@ -77,6 +79,10 @@ public:
         newLeaderCb_ = nullptr;
     }
 
+    void registerCommitCb(CommitCallback cb) {
+        commitCb_ = std::move(cb);
+    }
+
     // clean up all data about this part.
     void resetPart() {
         std::lock_guard<std::mutex> g(raftLock_);
@@ -110,6 +116,21 @@ private:
     nebula::cpp2::ErrorCode
     putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogTerm);
 
+    // The sst files of snapshot received are kept in this dir until all of them are received
+    std::string snapshotPath() const;
+
+    // Write the chunk into the sst file at offset. If the chunk has been written before, e.g.
+    // the leader retried the request, it is skipped and `received' is set to true. The files are
+    // named by the start time of the sending, the files left by another sending (e.g. an aborted
+    // one) are dropped when the first chunk of a new sending arrives.
+    bool writeSnapshotChunk(const std::string& file,
+                            int64_t offset,
+                            folly::StringPiece chunk,
+                            bool& received);
+
+    // Ingest the files of the current sending
+    nebula::cpp2::ErrorCode ingestSnapshotFiles();
+
     void cleanup() override;
 
     nebula::cpp2::ErrorCode toResultCode(raftex::AppendLogResult res);
@@ -119,9 +140,12 @@ protected:
     PartitionID partId_;
     std::string walPath_;
     NewLeaderCallback newLeaderCb_ = nullptr;
+    CommitCallback commitCb_ = nullptr;
 
 private:
     KVEngine* engine_ = nullptr;
+    // The start time of the sending whose sst files are being received
+    std::string snapshotTs_;
 };
 
 }  // namespace kvstore
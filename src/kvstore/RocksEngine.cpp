@@ -6,6 +6,7 @@
 
 #include "kvstore/RocksEngine.h"
 #include <folly/String.h>
+#include <numeric>
 #include <rocksdb/convenience.h>
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
@@ -55,6 +56,15 @@ public:
         }
     }
 
+    nebula::cpp2::ErrorCode
+    merge(folly::StringPiece key, folly::StringPiece operand) override {
+        if (batch_.Merge(toSlice(key), toSlice(operand)).ok()) {
+            return nebula::cpp2::ErrorCode::SUCCEEDED;
+        } else {
+            return nebula::cpp2::ErrorCode::E_UNKNOWN;
+        }
+    }
+
     // Remove all keys in the range [start, end)
     nebula::cpp2::ErrorCode
     removeRange(folly::StringPiece start, folly::StringPiece end) override {
@@ -182,23 +192,38 @@ nebula::cpp2::ErrorCode RocksEngine::get(const std::string& key, std::string* va
 
 std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
                                           std::vector<std::string>* values) {
-    rocksdb::ReadOptions options;
+    // The keys are looked up in sorted order by the batched MultiGet, which reads each block
+    // of the memtables and sst files only once for the keys in it, then the results are put
+    // back in the order of the input
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+        return keys[a] < keys[b];
+    });
     std::vector<rocksdb::Slice> slices;
-    for (size_t index = 0; index < keys.size(); index++) {
+    slices.reserve(keys.size());
+    for (auto index : order) {
         slices.emplace_back(keys[index]);
     }
 
-    auto status = db_->MultiGet(options, slices, values);
-    std::vector<Status> ret;
-    std::transform(status.begin(), status.end(), std::back_inserter(ret), [](const auto& s) {
-        if (s.ok()) {
-            return Status::OK();
-        } else if (s.IsNotFound()) {
-            return Status::KeyNotFound();
+    rocksdb::ReadOptions options;
+    std::vector<rocksdb::PinnableSlice> pinned(keys.size());
+    std::vector<rocksdb::Status> status(keys.size());
+    db_->MultiGet(options, db_->DefaultColumnFamily(), slices.size(), slices.data(),
+                  pinned.data(), status.data(), true);
+
+    values->resize(keys.size());
+    std::vector<Status> ret(keys.size(), Status::OK());
+    for (size_t i = 0; i < order.size(); i++) {
+        auto index = order[i];
+        if (status[i].ok()) {
+            (*values)[index].assign(pinned[i].data(), pinned[i].size());
+        } else if (status[i].IsNotFound()) {
+            ret[index] = Status::KeyNotFound();
         } else {
-            return Status::Error();
+            ret[index] = Status::Error();
         }
-    });
+    }
     return ret;
 }
 
@@ -5,20 +5,75 @@
  */
 
 #include "kvstore/SnapshotManagerImpl.h"
+#include "common/fs/FileUtils.h"
+#include "common/time/WallClock.h"
 #include "utils/NebulaKeyUtils.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/Part.h"
+#include <rocksdb/sst_file_writer.h>
 
 DEFINE_int32(snapshot_batch_size, 1024 * 1024 * 10, "batch size for snapshot");
+DEFINE_bool(snapshot_send_files, false,
+            "Build sst files of the part and send them in chunks of snapshot_batch_size, "
+            "the receiver ingests the files instead of writing the rows one by one");
 
 namespace nebula {
 namespace kvstore {
 
+namespace {
+
+// Write all rows of the table into one sst file, returns the number of rows written
+ErrorOr<nebula::cpp2::ErrorCode, int64_t> writeSstFile(KVEngine* engine,
+                                                      const std::string& prefix,
+                                                      const std::string& path) {
+    std::unique_ptr<KVIterator> iter;
+    auto code = engine->prefix(prefix, &iter);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return code;
+    }
+    if (!iter->valid()) {
+        return 0;
+    }
+
+    rocksdb::Options options;
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+    auto s = writer.Open(path);
+    if (!s.ok()) {
+        LOG(ERROR) << "Open sst file " << path << " failed, error: " << s.ToString();
+        return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    int64_t count = 0;
+    for (; iter->valid(); iter->next()) {
+        auto key = iter->key();
+        auto val = iter->val();
+        s = writer.Put(rocksdb::Slice(key.data(), key.size()),
+                       rocksdb::Slice(val.data(), val.size()));
+        if (!s.ok()) {
+            LOG(ERROR) << "Write sst file " << path << " failed, error: " << s.ToString();
+            return nebula::cpp2::ErrorCode::E_UNKNOWN;
+        }
+        count++;
+    }
+    s = writer.Finish();
+    if (!s.ok()) {
+        LOG(ERROR) << "Finish sst file " << path << " failed, error: " << s.ToString();
+        return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    return count;
+}
+
+}  // namespace
+
 const int32_t kReserveNum = 1024 * 4;
 void SnapshotManagerImpl::accessAllRowsInSnapshot(GraphSpaceID spaceId,
                                                   PartitionID partId,
                                                   raftex::SnapshotCallback cb) {
     CHECK_NOTNULL(store_);
     auto tables = NebulaKeyUtils::snapshotPrefix(partId);
+    if (FLAGS_snapshot_send_files) {
+        accessAllFilesInSnapshot(spaceId, partId, tables, cb);
+        return;
+    }
     std::vector<std::string> data;
     int64_t totalSize = 0;
     int64_t totalCount = 0;
@@ -72,6 +127,105 @@ bool SnapshotManagerImpl::accessTable(GraphSpaceID spaceId,
     return true;
 }
 
+void SnapshotManagerImpl::accessAllFilesInSnapshot(GraphSpaceID spaceId,
+                                                   PartitionID partId,
+                                                   const std::vector<std::string>& tables,
+                                                   raftex::SnapshotCallback& cb) {
+    std::vector<std::string> data;
+    int64_t totalSize = 0;
+    int64_t totalCount = 0;
+    auto ret = store_->part(spaceId, partId);
+    if (!ok(ret)) {
+        LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId << "] get part failed"
+                  << ", error code:" << static_cast<int32_t>(error(ret));
+        cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+        return;
+    }
+    auto* engine = value(ret)->engine();
+
+    // The files of each sending are named by its start time, so the receiver won't mix up the
+    // chunks of two sendings
+    auto ts = time::WallClock::fastNowInMicroSec();
+    auto dir = folly::stringPrintf("%s/snapshot/send/%d.%ld", engine->getDataRoot(), partId, ts);
+    if (!fs::FileUtils::makeDir(dir)) {
+        LOG(ERROR) << "[spaceId:" << spaceId << ", partId:" << partId << "] make dir "
+                   << dir << " failed";
+        cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+        return;
+    }
+    SCOPE_EXIT {
+        fs::FileUtils::remove(dir.c_str(), true);
+    };
+
+    for (size_t i = 0; i < tables.size(); i++) {
+        auto file = folly::stringPrintf("%ld.%zu.sst", ts, i);
+        auto path = folly::stringPrintf("%s/%s", dir.c_str(), file.c_str());
+        auto written = writeSstFile(engine, tables[i], path);
+        if (!ok(written)) {
+            LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId << "] build sst failed"
+                      << ", error code:" << static_cast<int32_t>(error(written));
+            cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+            return;
+        }
+        if (value(written) == 0) {
+            continue;
+        }
+        // Only one table is kept on disk at the same time
+        auto sent = sendFile(spaceId, partId, path, file, cb, totalCount, totalSize);
+        fs::FileUtils::remove(path.c_str());
+        if (!sent) {
+            return;
+        }
+    }
+    cb(data, totalCount, totalSize, raftex::SnapshotStatus::DONE);
+}
+
+bool SnapshotManagerImpl::sendFile(GraphSpaceID spaceId,
+                                   PartitionID partId,
+                                   const std::string& path,
+                                   const std::string& file,
+                                   raftex::SnapshotCallback& cb,
+                                   int64_t& totalCount,
+                                   int64_t& totalSize) {
+    std::vector<std::string> data;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "[spaceId:" << spaceId << ", partId:" << partId << "] open " << path
+                   << " failed, error: " << strerror(errno);
+        cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+        return false;
+    }
+    SCOPE_EXIT {
+        ::close(fd);
+    };
+
+    std::string buffer(FLAGS_snapshot_batch_size, '\0');
+    int64_t offset = 0;
+    while (true) {
+        auto len = ::pread(fd, &buffer[0], buffer.size(), offset);
+        if (len < 0) {
+            LOG(ERROR) << "[spaceId:" << spaceId << ", partId:" << partId << "] read " << path
+                       << " failed, error: " << strerror(errno);
+            cb(data, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+            return false;
+        }
+        if (len == 0) {
+            break;
+        }
+        data.clear();
+        data.emplace_back(encodeSstChunk(file, offset, folly::StringPiece(buffer.data(), len)));
+        totalSize += data.back().size();
+        totalCount++;
+        if (!cb(data, totalCount, totalSize, raftex::SnapshotStatus::IN_PROGRESS)) {
+            LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId
+                      << "] send snapshot failed";
+            return false;
+        }
+        offset += len;
+    }
+    return true;
+}
+
 }   // namespace kvstore
 }  // namespace nebula
 
@@ -31,6 +31,20 @@ private:
                      int64_t& totalCount,
                      int64_t& totalSize);
 
+    // Build one sst file for each table, and send the files in chunks of snapshot_batch_size
+    void accessAllFilesInSnapshot(GraphSpaceID spaceId,
+                                  PartitionID partId,
+                                  const std::vector<std::string>& tables,
+                                  raftex::SnapshotCallback& cb);
+
+    bool sendFile(GraphSpaceID spaceId,
+                  PartitionID partId,
+                  const std::string& path,
+                  const std::string& file,
+                  raftex::SnapshotCallback& cb,
+                  int64_t& totalCount,
+                  int64_t& totalSize);
+
     KVStore* store_;
 };
 
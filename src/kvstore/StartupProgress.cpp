@@ -0,0 +1,93 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "kvstore/StartupProgress.h"
+#include "common/time/WallClock.h"
+
+namespace nebula {
+namespace kvstore {
+
+StartupProgress& StartupProgress::instance() {
+    static StartupProgress progress;
+    return progress;
+}
+
+const char* StartupProgress::name(Phase phase) {
+    switch (phase) {
+        case kScanPaths:
+            return "scan_paths";
+        case kOpenEngines:
+            return "open_engines";
+        case kLoadParts:
+            return "load_parts";
+        case kLoadFromMeta:
+            return "load_from_meta";
+        default:
+            LOG(FATAL) << "Unknown phase " << static_cast<int32_t>(phase);
+    }
+    return "";
+}
+
+void StartupProgress::begin(Phase phase, size_t total) {
+    auto now = time::WallClock::fastNowInMilliSec();
+    int64_t notStarted = 0;
+    startMs_.compare_exchange_strong(notStarted, now);
+    auto& info = phases_[phase];
+    info.total.store(total, std::memory_order_relaxed);
+    info.done.store(0, std::memory_order_relaxed);
+    info.endMs.store(0, std::memory_order_relaxed);
+    info.startMs.store(now, std::memory_order_relaxed);
+}
+
+void StartupProgress::advance(Phase phase) {
+    phases_[phase].done.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StartupProgress::end(Phase phase) {
+    auto& info = phases_[phase];
+    info.endMs.store(time::WallClock::fastNowInMilliSec(), std::memory_order_relaxed);
+    LOG(INFO) << "Startup phase " << name(phase) << " finished, "
+              << info.done.load(std::memory_order_relaxed) << " done, took "
+              << info.endMs.load(std::memory_order_relaxed) -
+                 info.startMs.load(std::memory_order_relaxed) << "ms";
+}
+
+void StartupProgress::setReady() {
+    readyMs_.store(time::WallClock::fastNowInMilliSec(), std::memory_order_relaxed);
+    ready_.store(true, std::memory_order_release);
+}
+
+folly::dynamic StartupProgress::toJson() const {
+    auto now = time::WallClock::fastNowInMilliSec();
+    auto startMs = startMs_.load(std::memory_order_relaxed);
+    auto readyMs = readyMs_.load(std::memory_order_relaxed);
+    folly::dynamic progress = folly::dynamic::object();
+    progress["ready"] = ready();
+    progress["elapsed_ms"] = startMs == 0 ? 0 : (readyMs == 0 ? now : readyMs) - startMs;
+    auto phases = folly::dynamic::array();
+    for (size_t i = 0; i < phases_.size(); i++) {
+        const auto& info = phases_[i];
+        auto phaseStart = info.startMs.load(std::memory_order_relaxed);
+        auto phaseEnd = info.endMs.load(std::memory_order_relaxed);
+        folly::dynamic phase = folly::dynamic::object();
+        phase["name"] = name(static_cast<Phase>(i));
+        if (phaseStart == 0) {
+            phase["state"] = "pending";
+            phase["elapsed_ms"] = 0;
+        } else {
+            phase["state"] = phaseEnd == 0 ? "running" : "finished";
+            phase["elapsed_ms"] = (phaseEnd == 0 ? now : phaseEnd) - phaseStart;
+        }
+        phase["total"] = info.total.load(std::memory_order_relaxed);
+        phase["done"] = info.done.load(std::memory_order_relaxed);
+        phases.push_back(std::move(phase));
+    }
+    progress["phases"] = std::move(phases);
+    return progress;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
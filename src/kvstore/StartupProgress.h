@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_STARTUPPROGRESS_H_
+#define KVSTORE_STARTUPPROGRESS_H_
+
+#include "common/base/Base.h"
+#include <folly/dynamic.h>
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * StartupProgress records the phases of loading the data when the store starts: how many
+ * engines and parts are there to load, how many of them are done, and how long each phase
+ * takes. It is updated by the loading threads and read by the web service, so that how far a
+ * restarting storaged is from ready could be watched.
+ * */
+class StartupProgress final {
+public:
+    enum Phase : uint8_t {
+        kScanPaths      = 0,    // list the spaces in the data paths
+        kOpenEngines    = 1,    // open the engine of each space and data path
+        kLoadParts      = 2,    // start the parts found in the engines, replaying their wal
+        kLoadFromMeta   = 3,    // add the parts assigned by meta but not found on disk
+        kNumPhases      = 4,
+    };
+
+    static StartupProgress& instance();
+
+    static const char* name(Phase phase);
+
+    void begin(Phase phase, size_t total = 0);
+
+    // One more engine or part of the phase is done
+    void advance(Phase phase);
+
+    void end(Phase phase);
+
+    // The store is ready to serve
+    void setReady();
+
+    bool ready() const {
+        return ready_.load(std::memory_order_acquire);
+    }
+
+    folly::dynamic toJson() const;
+
+private:
+    StartupProgress() = default;
+
+    struct PhaseInfo {
+        std::atomic<int64_t>    startMs{0};
+        std::atomic<int64_t>    endMs{0};
+        std::atomic<size_t>     total{0};
+        std::atomic<size_t>     done{0};
+    };
+
+    std::array<PhaseInfo, kNumPhases>   phases_;
+    std::atomic<int64_t>                startMs_{0};
+    std::atomic<int64_t>                readyMs_{0};
+    std::atomic<bool>                   ready_{false};
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+
+#endif  // KVSTORE_STARTUPPROGRESS_H_
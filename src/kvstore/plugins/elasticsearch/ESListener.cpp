@@ -65,6 +65,11 @@ bool ESListener::apply(const std::vector<KV>& data) {
     return true;
 }
 
+bool ESListener::applyMerge(const std::vector<KV>&) {
+    // Only the integer props are updated by merging, which have no full-text index
+    return true;
+}
+
 bool ESListener::persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) {
     if (!writeAppliedId(lastId, lastTerm, lastApplyLogId)) {
         LOG(FATAL) << "last apply ids write failed";
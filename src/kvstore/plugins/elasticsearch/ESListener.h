@@ -41,6 +41,8 @@ protected:
 
     bool apply(const std::vector<KV>& data) override;
 
+    bool applyMerge(const std::vector<KV>& operands) override;
+
     bool persist(LogID lastId, TermID lastTerm, LogID lastApplyLogId) override;
 
     std::pair<LogID, TermID> lastCommittedLogId() override;
@@ -147,6 +147,14 @@ public:
                        std::vector<KV> keyValues,
                        KVCallback cb) override;
 
+    void asyncMerge(GraphSpaceID,
+                    PartitionID,
+                    const std::string&,
+                    const std::string&,
+                    KVCallback) override {
+        LOG(FATAL) << "Not supportted yet!";
+    }
+
     void asyncRemove(GraphSpaceID spaceId,
                      PartitionID partId,
                      const std::string& key,
@@ -17,6 +17,9 @@ DEFINE_uint32(max_appendlog_batch_size, 128,
 DEFINE_uint32(max_outstanding_requests, 1024,
               "The max number of outstanding appendLog requests");
 DEFINE_int32(raft_rpc_timeout_ms, 500, "rpc timeout for raft client");
+DEFINE_uint32(max_inflight_appendlog_requests, 1,
+              "Max number of AppendLog requests in flight to one follower, "
+              "a larger window helps the followers with a long round trip time");
 
 DECLARE_bool(trace_raft);
 DECLARE_uint32(raft_heartbeat_interval_secs);
@@ -97,7 +100,8 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
     VLOG(3) << idStr_ << "Entering Host::appendLogs()";
 
     auto ret = folly::Future<cpp2::AppendLogResponse>::makeEmpty();
-    std::shared_ptr<cpp2::AppendLogRequest> req;
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+    uint64_t epoch = 0;
     {
         std::lock_guard<std::mutex> g(lock_);
 
@@ -150,13 +154,14 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
         cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
         ret = promise_.getFuture();
 
-        requestOnGoing_ = true;
-
-        req = prepareAppendLogRequest();
+        replicating_ = true;
+        reqs = nextRequests();
+        epoch = epoch_;
     }
 
-    // Get a new promise
-    appendLogsInternal(eb, std::move(req));
+    for (auto& req : reqs) {
+        appendLogsInternal(eb, std::move(req), epoch);
+    }
 
     return ret;
 }
@@ -167,226 +172,258 @@ void Host::setResponse(const cpp2::AppendLogResponse& r) {
     cachingPromise_.setValue(r);
     cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
     pendingReq_ = std::make_tuple(0, 0, 0);
-    requestOnGoing_ = false;
+    replicating_ = false;
+    // the requests still in flight have nothing to do with the next one
+    ++epoch_;
 }
 
-void Host::appendLogsInternal(folly::EventBase* eb,
-                              std::shared_ptr<cpp2::AppendLogRequest> req) {
-    sendAppendLogRequest(eb, std::move(req)).via(eb).then(
-            [eb, self = shared_from_this()] (folly::Try<cpp2::AppendLogResponse>&& t) {
-        VLOG(3) << self->idStr_ << "appendLogs() call got response";
-        if (t.hasException()) {
-            VLOG(2) << self->idStr_ << t.exception().what();
+void Host::rollback() {
+    CHECK(!lock_.try_lock());
+    ++epoch_;
+    sentLogId_ = lastLogIdSent_;
+    sentLogTerm_ = lastLogTermSent_;
+}
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>> Host::nextRequests() {
+    CHECK(!lock_.try_lock());
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+    if (!replicating_) {
+        if (inflight_ > 0) {
+            // wait for the requests of the previous epochs, they may still change the follower
+        } else if (noRequest()) {
+            VLOG(2) << idStr_ << "No request any more!";
+        } else if (checkStatus() != cpp2::ErrorCode::SUCCEEDED) {
             cpp2::AppendLogResponse r;
-            r.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
-            {
-                std::lock_guard<std::mutex> g(self->lock_);
-                self->setResponse(r);
-                self->lastLogIdSent_ = self->logIdToSend_ - 1;
+            r.set_error_code(checkStatus());
+            cachingPromise_.setValue(r);
+            cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+            pendingReq_ = std::make_tuple(0, 0, 0);
+        } else {
+            auto& tup = pendingReq_;
+            logTermToSend_ = std::get<0>(tup);
+            logIdToSend_ = std::get<1>(tup);
+            committedLogId_ = std::get<2>(tup);
+            VLOG(2) << idStr_
+                    << "Sending the pending request in the queue"
+                    << ", from " << lastLogIdSent_ + 1
+                    << " to " << logIdToSend_;
+            promise_ = std::move(cachingPromise_);
+            cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+            pendingReq_ = std::make_tuple(0, 0, 0);
+            replicating_ = true;
+        }
+    }
+
+    if (replicating_) {
+        if (inflight_ == 0) {
+            // Nothing in flight, start from the last log acknowledged
+            sentLogId_ = lastLogIdSent_;
+            sentLogTerm_ = lastLogTermSent_;
+        }
+        size_t window = std::max(FLAGS_max_inflight_appendlog_requests, 1U);
+        while (inflight_ < window && sentLogId_ < logIdToSend_) {
+            auto req = prepareAppendLogRequest();
+            if (req->get_log_str_list().empty()) {
+                // Nothing to send or sending the snapshot, the response of the request tells us
+                // what to do next, so don't send more than one of it
+                if (inflight_ == 0) {
+                    ++inflight_;
+                    reqs.emplace_back(std::move(req));
+                }
+                break;
             }
+            ++inflight_;
+            reqs.emplace_back(std::move(req));
+        }
+    }
+    requestOnGoing_ = replicating_ || inflight_ > 0;
+    return reqs;
+}
+
+void Host::appendLogsInternal(folly::EventBase* eb,
+                              std::shared_ptr<cpp2::AppendLogRequest> req,
+                              uint64_t epoch) {
+    sendAppendLogRequest(eb, req).via(eb).then(
+            [eb, req, epoch, self = shared_from_this()]
+            (folly::Try<cpp2::AppendLogResponse>&& t) {
+        VLOG(3) << self->idStr_ << "appendLogs() call got response";
+        std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+        uint64_t newEpoch = 0;
+        bool noMoreRequest = false;
+        {
+            std::lock_guard<std::mutex> g(self->lock_);
+            self->handleAppendLogResponse(*req, epoch, std::move(t));
+            newReqs = self->nextRequests();
+            newEpoch = self->epoch_;
+            noMoreRequest = !self->requestOnGoing_;
+        }
+        for (auto& newReq : newReqs) {
+            self->appendLogsInternal(eb, std::move(newReq), newEpoch);
+        }
+        if (noMoreRequest) {
             self->noMoreRequestCV_.notify_all();
-            return;
         }
+    });
+}
+
+void Host::handleAppendLogResponse(const cpp2::AppendLogRequest& req,
+                                   uint64_t epoch,
+                                   folly::Try<cpp2::AppendLogResponse>&& t) {
+    CHECK(!lock_.try_lock());
+    CHECK_GT(inflight_, 0);
+    --inflight_;
+    if (epoch != epoch_) {
+        VLOG(2) << idStr_ << "Ignore the response of the request sent before rollback";
+        return;
+    }
+    if (t.hasException()) {
+        VLOG(2) << idStr_ << t.exception().what();
+        cpp2::AppendLogResponse r;
+        r.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
+        setResponse(r);
+        lastLogIdSent_ = logIdToSend_ - 1;
+        return;
+    }
 
-        cpp2::AppendLogResponse resp = std::move(t).value();
-        LOG_IF(INFO, FLAGS_trace_raft)
-            << self->idStr_ << "AppendLogResponse "
-            << "code " << apache::thrift::util::enumNameSafe(resp.get_error_code())
-            << ", currTerm " << resp.get_current_term()
-            << ", lastLogId " << resp.get_last_log_id()
-            << ", lastLogTerm " << resp.get_last_log_term()
-            << ", commitLogId " << resp.get_committed_log_id()
-            << ", lastLogIdSent_ " << self->lastLogIdSent_
-            << ", lastLogTermSent_ " << self->lastLogTermSent_;
-        switch (resp.get_error_code()) {
-            case cpp2::ErrorCode::SUCCEEDED: {
-                VLOG(2) << self->idStr_
-                        << "AppendLog request sent successfully";
-
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " just return";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ >= resp.get_last_log_id()) {
-                        VLOG(2) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        if (self->lastLogIdSent_ < self->logIdToSend_) {
-                            // More to send
-                            VLOG(2) << self->idStr_
-                                    << "There are more logs to send";
-                            newReq = self->prepareAppendLogRequest();
-                        } else {
-                            VLOG(2) << self->idStr_
-                                    << "Fulfill the promise, size = " << self->promise_.size();
-                            // Fulfill the promise
-                            self->promise_.setValue(resp);
-
-                            if (self->noRequest()) {
-                                VLOG(2) << self->idStr_ << "No request any more!";
-                                self->requestOnGoing_ = false;
-                            } else {
-                                auto& tup = self->pendingReq_;
-                                self->logTermToSend_ = std::get<0>(tup);
-                                self->logIdToSend_ = std::get<1>(tup);
-                                self->committedLogId_ = std::get<2>(tup);
-                                VLOG(2) << self->idStr_
-                                        << "Sending the pending request in the queue"
-                                        << ", from " << self->lastLogIdSent_ + 1
-                                        << " to " << self->logIdToSend_;
-                                newReq = self->prepareAppendLogRequest();
-                                self->promise_ = std::move(self->cachingPromise_);
-                                self->cachingPromise_
-                                    = folly::SharedPromise<cpp2::AppendLogResponse>();
-                                self->pendingReq_ = std::make_tuple(0, 0, 0);
-                            }  // self->noRequest()
-                        }  // self->lastLogIdSent_ < self->logIdToSend_
-                    }  // else
+    // The logs in the request are [last_log_id_sent + 1, reqLastLogId]
+    bool sentNothing = req.get_log_str_list().empty();
+    LogID reqLastLogId = req.get_last_log_id_sent() + req.get_log_str_list().size();
+    cpp2::AppendLogResponse resp = std::move(t).value();
+    LOG_IF(INFO, FLAGS_trace_raft)
+        << idStr_ << "AppendLogResponse "
+        << "code " << apache::thrift::util::enumNameSafe(resp.get_error_code())
+        << ", currTerm " << resp.get_current_term()
+        << ", lastLogId " << resp.get_last_log_id()
+        << ", lastLogTerm " << resp.get_last_log_term()
+        << ", commitLogId " << resp.get_committed_log_id()
+        << ", lastLogIdSent_ " << lastLogIdSent_
+        << ", lastLogTermSent_ " << lastLogTermSent_
+        << ", inflight " << inflight_;
+
+    auto res = checkStatus();
+    switch (resp.get_error_code()) {
+        case cpp2::ErrorCode::SUCCEEDED: {
+            VLOG(2) << idStr_ << "AppendLog request sent successfully";
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_ << "The host is not in a proper status, just return";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (lastLogIdSent_ >= resp.get_last_log_id()) {
+                if (!sentNothing && reqLastLogId <= lastLogIdSent_) {
+                    VLOG(2) << idStr_ << "The logs have been acknowledged by a later request";
+                    return;
                 }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                if (inflight_ == 0) {
+                    VLOG(2) << idStr_
+                            << "We send nothing in the last request"
+                            << ", so we don't send the same logs again";
+                    cpp2::AppendLogResponse r;
+                    r.set_error_code(res);
+                    setResponse(r);
                 }
-                return;
-            }
-            case cpp2::ErrorCode::E_LOG_GAP: {
-                VLOG(2) << self->idStr_
-                        << "The host's log is behind, need to catch up";
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip catching up the gap";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ == resp.get_last_log_id()) {
-                        VLOG(2) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = std::min(resp.get_last_log_id(),
-                                                        self->logIdToSend_ - 1);
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
+            } else {
+                lastLogIdSent_ = resp.get_last_log_id();
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                if (sentLogId_ < lastLogIdSent_) {
+                    sentLogId_ = lastLogIdSent_;
+                    sentLogTerm_ = lastLogTermSent_;
                 }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
+                if (lastLogIdSent_ >= logIdToSend_) {
+                    VLOG(2) << idStr_
+                            << "Fulfill the promise, size = " << promise_.size();
+                    promise_.setValue(resp);
+                    replicating_ = false;
+                    ++epoch_;
                 } else {
-                    self->noMoreRequestCV_.notify_all();
+                    VLOG(2) << idStr_ << "There are more logs to send";
                 }
-                return;
             }
-            case cpp2::ErrorCode::E_WAITING_SNAPSHOT: {
-                LOG(INFO) << self->idStr_
-                          << "The host is waiting for the snapshot, so we need to send log from "
-                          << "current committedLogId " << self->committedLogId_;
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = self->committedLogId_;
-                        self->lastLogTermSent_ = self->logTermToSend_;
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+            return;
+        }
+        case cpp2::ErrorCode::E_LOG_GAP: {
+            VLOG(2) << idStr_ << "The host's log is behind, need to catch up";
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status, skip catching up the gap";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (req.get_last_log_id_sent() == lastLogIdSent_ &&
+                       lastLogIdSent_ == resp.get_last_log_id()) {
+                VLOG(2) << idStr_
+                        << "We send nothing in the last request"
+                        << ", so we don't send the same logs again";
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                cpp2::AppendLogResponse r;
+                r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                setResponse(r);
+            } else {
+                // The requests after it are out of order as well, send from the gap again
+                lastLogIdSent_ = std::min(resp.get_last_log_id(), logIdToSend_ - 1);
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                rollback();
             }
-            case cpp2::ErrorCode::E_LOG_STALE: {
-                VLOG(2) << self->idStr_ << "Log stale, reset lastLogIdSent " << self->lastLogIdSent_
-                        << " to the followers lastLodId " << resp.get_last_log_id();
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->logIdToSend_ <= resp.get_last_log_id()) {
-                        VLOG(2) << self->idStr_
-                                << "It means the request has been received by follower";
-                        self->lastLogIdSent_ = self->logIdToSend_ - 1;
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = std::min(resp.get_last_log_id(),
-                                                        self->logIdToSend_ - 1);
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+            return;
+        }
+        case cpp2::ErrorCode::E_WAITING_SNAPSHOT: {
+            LOG(INFO) << idStr_
+                      << "The host is waiting for the snapshot, so we need to send log from "
+                      << "current committedLogId " << committedLogId_;
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status, skip waiting the snapshot";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else {
+                lastLogIdSent_ = committedLogId_;
+                lastLogTermSent_ = logTermToSend_;
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                rollback();
             }
-            default: {
-                LOG_EVERY_N(ERROR, 100)
-                           << self->idStr_
-                           << "Failed to append logs to the host (Err: "
-                           << apache::thrift::util::enumNameSafe(resp.get_error_code())
-                           << ")";
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    self->setResponse(resp);
-                    self->lastLogIdSent_ = self->logIdToSend_ - 1;
-                }
-                self->noMoreRequestCV_.notify_all();
-                return;
+            return;
+        }
+        case cpp2::ErrorCode::E_LOG_STALE: {
+            VLOG(2) << idStr_ << "Log stale, reset lastLogIdSent " << lastLogIdSent_
+                    << " to the followers lastLodId " << resp.get_last_log_id();
+            if (res != cpp2::ErrorCode::SUCCEEDED) {
+                VLOG(2) << idStr_
+                        << "The host is not in a proper status, skip waiting the snapshot";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(res);
+                setResponse(r);
+            } else if (logIdToSend_ <= resp.get_last_log_id()) {
+                VLOG(2) << idStr_ << "It means the request has been received by follower";
+                lastLogIdSent_ = logIdToSend_ - 1;
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                cpp2::AppendLogResponse r;
+                r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                setResponse(r);
+            } else {
+                lastLogIdSent_ = std::min(resp.get_last_log_id(), logIdToSend_ - 1);
+                lastLogTermSent_ = resp.get_last_log_term();
+                followerCommittedLogId_ = resp.get_committed_log_id();
+                rollback();
             }
+            return;
         }
-    });
+        default: {
+            LOG_EVERY_N(ERROR, 100)
+                       << idStr_
+                       << "Failed to append logs to the host (Err: "
+                       << apache::thrift::util::enumNameSafe(resp.get_error_code())
+                       << ")";
+            setResponse(resp);
+            lastLogIdSent_ = logIdToSend_ - 1;
+            return;
+        }
+    }
 }
 
 
@@ -401,18 +438,19 @@ Host::prepareAppendLogRequest() {
     req->set_leader_addr(part_->address().host);
     req->set_leader_port(part_->address().port);
     req->set_committed_log_id(committedLogId_);
-    req->set_last_log_term_sent(lastLogTermSent_);
-    req->set_last_log_id_sent(lastLogIdSent_);
+    // The logs are sent after the ones still in flight, which are acknowledged later
+    req->set_last_log_term_sent(sentLogTerm_);
+    req->set_last_log_id_sent(sentLogId_);
 
     VLOG(2) << idStr_ << "Prepare AppendLogs request from Log "
-                      << lastLogIdSent_ + 1 << " to " << logIdToSend_;
-    if (lastLogIdSent_ + 1 > part_->wal()->lastLogId()) {
+                      << sentLogId_ + 1 << " to " << logIdToSend_;
+    if (sentLogId_ + 1 > part_->wal()->lastLogId()) {
         LOG(INFO) << idStr_ << "My lastLogId in wal is " << part_->wal()->lastLogId()
-                  << ", but you are seeking " << lastLogIdSent_ + 1
+                  << ", but you are seeking " << sentLogId_ + 1
                   << ", so i have nothing to send.";
         return req;
     }
-    auto it = part_->wal()->iterator(lastLogIdSent_ + 1, logIdToSend_);
+    auto it = part_->wal()->iterator(sentLogId_ + 1, logIdToSend_);
     if (it->valid()) {
         VLOG(2) << idStr_ << "Prepare the list of log entries to send";
 
@@ -430,12 +468,14 @@ Host::prepareAppendLogRequest() {
             le.set_log_str(it->logMsg().toString());
             logs.emplace_back(std::move(le));
         }
+        sentLogId_ += logs.size();
+        sentLogTerm_ = term;
         req->set_log_str_list(std::move(logs));
         req->set_sending_snapshot(false);
     } else {
         req->set_sending_snapshot(true);
         if (!sendingSnapshot_) {
-            LOG(INFO) << idStr_ << "Can't find log " << lastLogIdSent_ + 1
+            LOG(INFO) << idStr_ << "Can't find log " << sentLogId_ + 1
                       << " in wal, send the snapshot"
                       << ", logIdToSend = " << logIdToSend_
                       << ", firstLogId in wal = " << part_->wal()->firstLogId()
@@ -12,6 +12,7 @@
 #include "common/interface/gen-cpp2/RaftexServiceAsyncClient.h"
 #include "common/thrift/ThriftClientManager.h"
 #include <folly/futures/Future.h>
+#include <gtest/gtest_prod.h>
 
 namespace folly {
 class EventBase;
@@ -25,6 +26,7 @@ class RaftPart;
 
 class Host final : public std::enable_shared_from_this<Host> {
     friend class RaftPart;
+    FRIEND_TEST(LogAppend, PipelineRollback);
 public:
     Host(const HostAddr& addr, std::shared_ptr<RaftPart> part, bool isLearner = false);
 
@@ -60,6 +62,8 @@ public:
         logTermToSend_ = 0;
         lastLogIdSent_ = 0;
         lastLogTermSent_ = 0;
+        sentLogId_ = 0;
+        sentLogTerm_ = 0;
         committedLogId_ = 0;
         sendingSnapshot_ = false;
         followerCommittedLogId_ = 0;
@@ -109,7 +113,20 @@ private:
 
     void appendLogsInternal(
         folly::EventBase* eb,
-        std::shared_ptr<cpp2::AppendLogRequest> req);
+        std::shared_ptr<cpp2::AppendLogRequest> req,
+        uint64_t epoch);
+
+    // Update the progress of the follower by the response of a request sent in epoch
+    void handleAppendLogResponse(const cpp2::AppendLogRequest& req,
+                                 uint64_t epoch,
+                                 folly::Try<cpp2::AppendLogResponse>&& t);
+
+    // Return the requests to send to fill the window of in-flight requests, a pending request is
+    // started if the previous one has finished
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> nextRequests();
+
+    // Discard the in-flight requests, and send from the last acknowledged log again
+    void rollback();
 
     folly::Future<cpp2::HeartbeatResponse> sendHeartbeatRequest(
         folly::EventBase* eb,
@@ -135,7 +152,14 @@ private:
     bool paused_{false};
     bool stopped_{false};
 
+    // Whether the logs up to logIdToSend_ are being replicated, or any request is in flight
     bool requestOnGoing_{false};
+    // Whether the logs up to logIdToSend_ are being replicated, promise_ is fulfilled when done
+    bool replicating_{false};
+    // Number of AppendLogRequest in flight, at most FLAGS_max_inflight_appendlog_requests
+    size_t inflight_{0};
+    // Increased on rollback, the responses of requests sent in previous epochs are ignored
+    uint64_t epoch_{0};
     std::condition_variable noMoreRequestCV_;
     folly::SharedPromise<cpp2::AppendLogResponse> promise_;
     folly::SharedPromise<cpp2::AppendLogResponse> cachingPromise_;
@@ -146,10 +170,14 @@ private:
     LogID logIdToSend_{0};
     TermID logTermToSend_{0};
 
-    // The previous log before this batch
+    // The last log acknowledged by the follower
     LogID lastLogIdSent_{0};
     TermID lastLogTermSent_{0};
 
+    // The last log in the requests in flight, the next request starts after it
+    LogID sentLogId_{0};
+    TermID sentLogTerm_{0};
+
     LogID committedLogId_{0};
     std::atomic_bool sendingSnapshot_{false};
 
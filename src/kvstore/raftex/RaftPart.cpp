@@ -12,6 +12,7 @@
 #include "common/thread/NamedThread.h"
 #include "common/time/WallClock.h"
 #include "common/base/SlowOpTracker.h"
+#include "common/stats/StatsManager.h"
 #include <folly/io/async/EventBaseManager.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/gen/Base.h>
@@ -30,6 +31,21 @@ DEFINE_uint32(max_batch_size, 256, "The max number of logs in a batch");
 
 DEFINE_bool(trace_raft, false, "Enable trace one raft request");
 
+DEFINE_uint32(raft_append_queue_max_logs, 16384,
+              "The max number of logs of a part waiting for the appendLog buffer, "
+              "more logs are rejected with E_BUFFER_OVERFLOW");
+DEFINE_uint64(raft_append_queue_max_bytes, 256 * 1024 * 1024,
+              "The max bytes of logs of a part waiting for the appendLog buffer");
+DEFINE_uint64(raft_append_queue_space_max_bytes, 0,
+              "The max bytes of logs of all parts in a space waiting for the appendLog buffer, "
+              "0 means no limit");
+DEFINE_uint64(raft_append_queue_total_max_bytes, 1024 * 1024 * 1024,
+              "The max bytes of logs of all parts in the process waiting for the appendLog "
+              "buffer, 0 means no limit");
+DEFINE_bool(raft_append_queue_part_stats, false,
+            "Expose the depth and wait time of the append queue of each part besides those of "
+            "each space, it registers a pair of histograms for every part");
+
 DECLARE_int32(wal_ttl);
 DECLARE_int64(wal_file_size);
 DECLARE_int32(wal_buffer_size);
@@ -46,6 +62,32 @@ using nebula::wal::FileBasedWalInfo;
 
 using OpProcessor = folly::Function<folly::Optional<std::string>(AtomicOp op)>;
 
+namespace {
+
+stats::CounterId kNumAppendQueueRejections;
+stats::CounterId kAppendQueueDepth;
+stats::CounterId kAppendQueueWaitUs;
+
+// The bytes of logs queued by the parts of each space
+std::shared_ptr<std::atomic<int64_t>> spaceQueuedBytes(GraphSpaceID spaceId) {
+    static std::mutex lock;
+    static std::unordered_map<GraphSpaceID, std::shared_ptr<std::atomic<int64_t>>> spaces;
+    std::lock_guard<std::mutex> g(lock);
+    auto& bytes = spaces[spaceId];
+    if (bytes == nullptr) {
+        bytes = std::make_shared<std::atomic<int64_t>>(0);
+    }
+    return bytes;
+}
+
+// The bytes of logs queued by all parts in the process
+std::atomic<int64_t>& totalQueuedBytes() {
+    static std::atomic<int64_t> bytes{0};
+    return bytes;
+}
+
+}  // namespace
+
 class AppendLogsIterator final : public LogIterator {
 public:
     AppendLogsIterator(LogID firstLogId,
@@ -244,7 +286,33 @@ RaftPart::RaftPart(
         },
         diskMan);
     logs_.reserve(FLAGS_max_batch_size);
+    spaceQueuedBytes_ = spaceQueuedBytes(spaceId_);
     CHECK(!!executor_) << idStr_ << "Should not be nullptr";
+
+    static std::once_flag statsFlag;
+    std::call_once(statsFlag, [] {
+        kNumAppendQueueRejections =
+            stats::StatsManager::registerStats("num_raft_append_rejections", "rate, sum");
+        kAppendQueueDepth = stats::StatsManager::registerHisto(
+            "raft_append_queue_depth", 100, 0, 10000, "avg, p75, p95, p99");
+        kAppendQueueWaitUs = stats::StatsManager::registerHisto(
+            "raft_append_queue_wait_us", 1000, 0, 100000, "avg, p75, p95, p99");
+    });
+    // Registering an existing name returns its id, so the parts of a space share the histograms
+    spaceQueueDepth_ = stats::StatsManager::registerHisto(
+        folly::stringPrintf("raft_append_queue_depth_space_%d", spaceId_),
+        100, 0, 10000, "avg, p75, p95, p99");
+    spaceQueueWaitUs_ = stats::StatsManager::registerHisto(
+        folly::stringPrintf("raft_append_queue_wait_us_space_%d", spaceId_),
+        1000, 0, 100000, "avg, p75, p95, p99");
+    if (FLAGS_raft_append_queue_part_stats) {
+        partQueueDepth_ = stats::StatsManager::registerHisto(
+            folly::stringPrintf("raft_append_queue_depth_space_%d_part_%d", spaceId_, partId_),
+            100, 0, 10000, "avg, p75, p95, p99");
+        partQueueWaitUs_ = stats::StatsManager::registerHisto(
+            folly::stringPrintf("raft_append_queue_wait_us_space_%d_part_%d", spaceId_, partId_),
+            1000, 0, 100000, "avg, p75, p95, p99");
+    }
 }
 
 
@@ -311,6 +379,7 @@ void RaftPart::start(std::vector<HostAddr>&& peers, bool asLearner) {
         auto hostPtr = std::make_shared<Host>(addr, shared_from_this());
         hosts_.emplace_back(hostPtr);
     }
+    noPeers_ = hosts_.empty();
 
     // Change the status
     status_ = Status::RUNNING;
@@ -389,6 +458,7 @@ void RaftPart::addLearner(const HostAddr& addr) {
     });
     if (it == hosts_.end()) {
         hosts_.emplace_back(std::make_shared<Host>(addr, shared_from_this(), true));
+        noPeers_ = false;
         LOG(INFO) << idStr_ << "Add learner " << addr;
     } else {
         LOG(INFO) << idStr_ << "The host " << addr << " has been existed as "
@@ -487,6 +557,7 @@ void RaftPart::addPeer(const HostAddr& peer) {
     });
     if (it == hosts_.end()) {
         hosts_.emplace_back(std::make_shared<Host>(peer, shared_from_this()));
+        noPeers_ = false;
         updateQuorum();
         LOG(INFO) << idStr_ << "Add peer " << peer;
     } else {
@@ -517,9 +588,11 @@ void RaftPart::removePeer(const HostAddr& peer) {
         if ((*it)->isLearner()) {
             LOG(INFO) << idStr_ << "The peer is learner, remove it directly!";
             hosts_.erase(it);
+            noPeers_ = hosts_.empty();
             return;
         }
         hosts_.erase(it);
+        noPeers_ = hosts_.empty();
         updateQuorum();
         LOG(INFO) << idStr_ << "Remove peer " << peer;
     }
@@ -550,6 +623,7 @@ void RaftPart::addListenerPeer(const HostAddr& listener) {
     if (it == hosts_.end()) {
         // Add listener as a raft learner
         hosts_.emplace_back(std::make_shared<Host>(listener, shared_from_this(), true));
+        noPeers_ = false;
         listeners_.emplace(listener);
         LOG(INFO) << idStr_ << "Add listener " << listener;
     } else {
@@ -570,6 +644,7 @@ void RaftPart::removeListenerPeer(const HostAddr& listener) {
         LOG(INFO) << idStr_ << "The listener " << listener << " not found";
     } else {
         hosts_.erase(it);
+        noPeers_ = hosts_.empty();
         listeners_.erase(listener);
         LOG(INFO) << idStr_ << "Remove listener " << listener;
     }
@@ -631,11 +706,17 @@ folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
     LogCache swappedOutLogs;
     auto retFuture = folly::Future<AppendLogResult>::makeEmpty();
 
+    // bufferOverFlow_ is set when the queue rejects a log, and it rejects all logs without
+    // consulting the queue until the queue has room again: admitQueuedLogs() resets it once some
+    // queued logs are moved into the buffer, and so does failQueuedLogs() which empties the queue.
+    // A part whose queue is rejected by the space or process limit has queued logs, so it is
+    // replicating and will admit them later.
     if (bufferOverFlow_) {
         LOG_EVERY_N(WARNING, 100) << idStr_
                      << "The appendLog buffer is full."
                         " Please slow down the log appending rate."
                      << "replicatingLogs_ :" << replicatingLogs_;
+        stats::StatsManager::addValue(kNumAppendQueueRejections);
         return AppendLogResult::E_BUFFER_OVERFLOW;
     }
     {
@@ -643,37 +724,34 @@ folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
 
         VLOG(2) << idStr_ << "Checking whether buffer overflow";
 
-        if (logs_.size() >= FLAGS_max_batch_size) {
-            // Buffer is full
-            LOG(WARNING) << idStr_
-                         << "The appendLog buffer is full."
-                            " Please slow down the log appending rate."
-                         << "replicatingLogs_ :" << replicatingLogs_;
-            bufferOverFlow_ = true;
-            return AppendLogResult::E_BUFFER_OVERFLOW;
-        }
-
-        VLOG(2) << idStr_ << "Appending logs to the buffer";
+        if (!queuedLogs_.empty() || logs_.size() >= FLAGS_max_batch_size) {
+            // Buffer is full, wait in the queue until the logs being replicated are done. The
+            // logs after the queued ones have to wait as well to keep the order.
+            if (!queueLog(source, logType, log, op, retFuture)) {
+                LOG_EVERY_N(WARNING, 100) << idStr_
+                             << "The appendLog buffer and queue are full."
+                                " Please slow down the log appending rate."
+                             << "replicatingLogs_ :" << replicatingLogs_;
+                bufferOverFlow_ = true;
+                stats::StatsManager::addValue(kNumAppendQueueRejections);
+                return AppendLogResult::E_BUFFER_OVERFLOW;
+            }
+        } else {
+            VLOG(2) << idStr_ << "Appending logs to the buffer";
 
-        // Append new logs to the buffer
-        DCHECK_GE(source, 0);
-        logs_.emplace_back(source, logType, std::move(log), std::move(op));
-        switch (logType) {
-            case LogType::ATOMIC_OP:
-                retFuture = cachingPromise_.getSingleFuture();
-                break;
-            case LogType::COMMAND:
-                retFuture = cachingPromise_.getAndRollSharedFuture();
-                break;
-            case LogType::NORMAL:
-                retFuture = cachingPromise_.getSharedFuture();
-                break;
+            // Append new logs to the buffer
+            DCHECK_GE(source, 0);
+            retFuture = bufferLog(source, logType, std::move(log), std::move(op));
         }
 
+        // A queued log starts the sending as well if no replication is ongoing, otherwise the
+        // queue would never be drained
         bool expected = false;
         if (replicatingLogs_.compare_exchange_strong(expected, true)) {
             // We need to send logs to all followers
             VLOG(2) << idStr_ << "Preparing to send AppendLog request";
+            // The queued logs go before those buffered afterwards
+            admitQueuedLogs();
             sendingPromise_ = std::move(cachingPromise_);
             cachingPromise_.reset();
             std::swap(swappedOutLogs, logs_);
@@ -725,6 +803,148 @@ folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
     return retFuture;
 }
 
+folly::Future<AppendLogResult> RaftPart::bufferLog(ClusterID source,
+                                                   LogType logType,
+                                                   std::string log,
+                                                   AtomicOp op) {
+    CHECK(!logsLock_.try_lock());
+    logs_.emplace_back(source, logType, std::move(log), std::move(op));
+    switch (logType) {
+        case LogType::ATOMIC_OP:
+            return cachingPromise_.getSingleFuture();
+        case LogType::COMMAND:
+            return cachingPromise_.getAndRollSharedFuture();
+        case LogType::NORMAL:
+        default:
+            return cachingPromise_.getSharedFuture();
+    }
+}
+
+bool RaftPart::queueLog(ClusterID source,
+                        LogType logType,
+                        std::string& log,
+                        AtomicOp& op,
+                        folly::Future<AppendLogResult>& future) {
+    CHECK(!logsLock_.try_lock());
+    auto bytes = log.size();
+    // A log larger than the limit is still accepted by an empty queue
+    if (!queuedLogs_.empty()) {
+        if (queuedLogs_.size() >= FLAGS_raft_append_queue_max_logs ||
+            queuedBytes_ + bytes > FLAGS_raft_append_queue_max_bytes) {
+            return false;
+        }
+        if (FLAGS_raft_append_queue_space_max_bytes > 0 &&
+            spaceQueuedBytes_->load() + static_cast<int64_t>(bytes) >
+                static_cast<int64_t>(FLAGS_raft_append_queue_space_max_bytes)) {
+            return false;
+        }
+        if (FLAGS_raft_append_queue_total_max_bytes > 0 &&
+            totalQueuedBytes().load() + static_cast<int64_t>(bytes) >
+                static_cast<int64_t>(FLAGS_raft_append_queue_total_max_bytes)) {
+            return false;
+        }
+    }
+
+    addQueueStats(kAppendQueueDepth, spaceQueueDepth_, partQueueDepth_, queuedLogs_.size());
+    queuedBytes_ += bytes;
+    spaceQueuedBytes_->fetch_add(bytes);
+    totalQueuedBytes().fetch_add(bytes);
+    queuedLogs_.emplace_back(QueuedLog{source,
+                                       logType,
+                                       std::move(log),
+                                       std::move(op),
+                                       folly::Promise<AppendLogResult>(),
+                                       time::WallClock::fastNowInMicroSec()});
+    future = queuedLogs_.back().promise.getFuture();
+    return true;
+}
+
+void RaftPart::admitQueuedLogs() {
+    CHECK(!logsLock_.try_lock());
+    auto now = time::WallClock::fastNowInMicroSec();
+    bool admitted = false;
+    while (!queuedLogs_.empty() && logs_.size() < FLAGS_max_batch_size) {
+        auto& queued = queuedLogs_.front();
+        auto bytes = queued.log.size();
+        addQueueStats(kAppendQueueWaitUs, spaceQueueWaitUs_, partQueueWaitUs_,
+                      now - queued.enqueueTime);
+        bufferLog(queued.source, queued.logType, std::move(queued.log), std::move(queued.op))
+            .thenValue([promise = std::move(queued.promise)] (AppendLogResult res) mutable {
+                promise.setValue(res);
+            });
+        queuedBytes_ -= bytes;
+        spaceQueuedBytes_->fetch_sub(bytes);
+        totalQueuedBytes().fetch_sub(bytes);
+        queuedLogs_.pop_front();
+        admitted = true;
+    }
+    if (admitted) {
+        // The queue has room again
+        bufferOverFlow_ = false;
+    }
+}
+
+void RaftPart::addQueueStats(stats::CounterId total,
+                             stats::CounterId space,
+                             stats::CounterId part,
+                             int64_t value) {
+    stats::StatsManager::addValue(total, value);
+    stats::StatsManager::addValue(space, value);
+    if (FLAGS_raft_append_queue_part_stats) {
+        stats::StatsManager::addValue(part, value);
+    }
+}
+
+bool RaftPart::prepareNextLogs(AppendLogsIterator& iter, LogID firstLogId, TermID termId) {
+    CHECK(!logsLock_.try_lock());
+    CHECK(replicatingLogs_);
+    // The logs admitted from the queue are replicated if the new iter is empty
+    while (iter.empty()) {
+        admitQueuedLogs();
+        if (logs_.empty()) {
+            break;
+        }
+        VLOG(2) << idStr_ << "logs size " << logs_.size();
+        // continue to replicate the logs
+        sendingPromise_ = std::move(cachingPromise_);
+        cachingPromise_.reset();
+        iter = AppendLogsIterator(
+            firstLogId,
+            termId,
+            std::move(logs_),
+            [this] (AtomicOp op) -> folly::Optional<std::string> {
+                auto opRet = op();
+                if (!opRet.hasValue()) {
+                    // Failed
+                    sendingPromise_.setOneSingleValue(AppendLogResult::E_ATOMIC_OP_FAILURE);
+                }
+                return opRet;
+            });
+        logs_.clear();
+        bufferOverFlow_ = false;
+    }
+    // Reset replicatingLogs_ if there is no log left, neither buffered nor queued. The new iter
+    // might be empty again if all logs in it are atomic ops and all of them failed.
+    if (iter.empty()) {
+        replicatingLogs_ = false;
+        VLOG(2) << idStr_ << "No more log to be replicated";
+        return false;
+    }
+    return true;
+}
+
+void RaftPart::failQueuedLogs(AppendLogResult res) {
+    CHECK(!logsLock_.try_lock());
+    for (auto& queued : queuedLogs_) {
+        queued.promise.setValue(res);
+    }
+    spaceQueuedBytes_->fetch_sub(queuedBytes_);
+    totalQueuedBytes().fetch_sub(queuedBytes_);
+    queuedBytes_ = 0;
+    queuedLogs_.clear();
+    bufferOverFlow_ = false;
+}
+
 void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
     TermID currTerm = 0;
     LogID prevLogId = 0;
@@ -737,7 +957,14 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
                 << currTerm << ")";
     } else {
         LOG(ERROR) << idStr_ << "Only happend when Atomic op failed";
-        replicatingLogs_ = false;
+        // Go on with the logs buffered or queued meanwhile, nobody else would send them
+        {
+            std::lock_guard<std::mutex> lck(logsLock_);
+            if (!prepareNextLogs(iter, iter.firstLogId(), termId)) {
+                return;
+            }
+        }
+        appendLogsInternal(std::move(iter), termId);
         return;
     }
     AppendLogResult res = AppendLogResult::SUCCEEDED;
@@ -925,8 +1152,8 @@ void RaftPart::processAppendLogResponses(
                 std::lock_guard<std::mutex> g(raftLock_);
                 committedLogId_ = lastLogId;
                 firstLogId = lastLogId_ + 1;
-                lastMsgAcceptedCostMs_ = lastMsgSentDur_.elapsedInMSec();
-                lastMsgAcceptedTime_ = time::WallClock::fastNowInMilliSec();
+                lastAcceptedMsgSentTime_ = time::WallClock::fastNowInMilliSec()
+                                         - lastMsgSentDur_.elapsedInMSec();
                 commitInThisTerm_ = true;
             } else {
                 LOG(FATAL) << idStr_ << "Failed to commit logs";
@@ -954,37 +1181,8 @@ void RaftPart::processAppendLogResponses(
             // Continue to process the original AppendLogsIterator if necessary
             iter.resume();
             // If no more valid logs to be replicated in iter, create a new one if we have new log
-            if (iter.empty()) {
-                VLOG(2) << idStr_ << "logs size " << logs_.size();
-                if (logs_.size() > 0) {
-                    // continue to replicate the logs
-                    sendingPromise_ = std::move(cachingPromise_);
-                    cachingPromise_.reset();
-                    iter = AppendLogsIterator(
-                        firstLogId,
-                        currTerm,
-                        std::move(logs_),
-                        [this] (AtomicOp op) -> folly::Optional<std::string> {
-                            auto opRet = op();
-                            if (!opRet.hasValue()) {
-                                // Failed
-                                sendingPromise_.setOneSingleValue(
-                                    AppendLogResult::E_ATOMIC_OP_FAILURE);
-                            }
-                            return opRet;
-                        });
-                    logs_.clear();
-                    bufferOverFlow_ = false;
-                }
-                // Reset replicatingLogs_ one of the following is true:
-                // 1. old iter is empty && logs_.size() == 0
-                // 2. old iter is empty && logs_.size() > 0, but all logs in new iter is atomic op,
-                //    and all of them failed, which would make iter is empty again
-                if (iter.empty()) {
-                    replicatingLogs_ = false;
-                    VLOG(2) << idStr_ << "No more log to be replicated";
-                    return;
-                }
+            if (!prepareNextLogs(iter, firstLogId, currTerm)) {
+                return;
             }
         }
         this->appendLogsInternal(std::move(iter), currTerm);
@@ -1233,7 +1431,7 @@ bool RaftPart::leaderElection() {
                                        term = voteReq.get_term()] {
                         self->onElected(term);
                     });
-                    lastMsgAcceptedTime_ = 0;
+                    lastAcceptedMsgSentTime_ = 0;
                 }
                 weight_ = 1;
                 commitInThisTerm_ = false;
@@ -1961,9 +2159,7 @@ void RaftPart::sendHeartbeat() {
         if (numSucceeded >= replica) {
             VLOG(2) << idStr_ << "Heartbeat is accepted by quorum";
             std::lock_guard<std::mutex> g(raftLock_);
-            auto now = time::WallClock::fastNowInMilliSec();
-            lastMsgAcceptedCostMs_ = now - startMs;
-            lastMsgAcceptedTime_ = now;
+            lastAcceptedMsgSentTime_ = startMs;
         }
     });
 }
@@ -2004,6 +2200,7 @@ bool RaftPart::checkAppendLogResult(AppendLogResult res) {
             logs_.clear();
             cachingPromise_.setValue(res);
             cachingPromise_.reset();
+            failQueuedLogs(res);
             bufferOverFlow_ = false;
         }
         sendingPromise_.setValue(res);
@@ -2093,18 +2290,19 @@ void RaftPart::checkRemoteListeners(const std::set<HostAddr>& expected) {
 }
 
 bool RaftPart::leaseValid() {
-    std::lock_guard<std::mutex> g(raftLock_);
-    if (hosts_.empty()) {
+    // Lock free, the fields are atomic and only modified with raftLock_ held.
+    if (noPeers_) {
         return true;
     }
     if (!commitInThisTerm_) {
         return false;
     }
     // When majority has accepted a log, leader obtains a lease which last for heartbeat.
-    // However, we need to take off the net io time. On the left side of the inequality is
-    // the time duration since last time leader send a log (the log has been accepted as well)
-    return time::WallClock::fastNowInMilliSec() - lastMsgAcceptedTime_
-        < FLAGS_raft_heartbeat_interval_secs * 1000 - lastMsgAcceptedCostMs_;
+    // However, we need to take off the net io time, so the lease starts from the time when
+    // the log was sent rather than accepted.
+    int64_t sentTime = lastAcceptedMsgSentTime_.load();
+    int64_t now = time::WallClock::fastNowInMilliSec();
+    return now - sentTime < static_cast<int64_t>(FLAGS_raft_heartbeat_interval_secs) * 1000;
 }
 
 }  // namespace raftex
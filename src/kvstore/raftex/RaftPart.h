@@ -8,6 +8,7 @@
 #define RAFTEX_RAFTPART_H_
 
 #include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
 #include "common/interface/gen-cpp2/raftex_types.h"
 #include "common/interface/gen-cpp2/RaftexServiceAsyncClient.h"
 #include "common/time/Duration.h"
@@ -93,8 +94,8 @@ public:
         return status_ == Status::STOPPED;
     }
 
+    // Lock free, it is on the read path of every request
     bool isLeader() const {
-        std::lock_guard<std::mutex> g(raftLock_);
         return role_ == Role::LEADER;
     }
 
@@ -334,6 +335,17 @@ private:
                    std::string,
                    AtomicOp>>;
 
+    // A log waiting for the room in logs_, which is full while the previous logs are replicated
+    struct QueuedLog {
+        ClusterID source;
+        LogType logType;
+        std::string log;
+        AtomicOp op;
+        folly::Promise<AppendLogResult> promise;
+        // in us
+        int64_t enqueueTime;
+    };
+
 
     /****************************************************
      *
@@ -396,6 +408,39 @@ private:
                                                   std::string log,
                                                   AtomicOp cb = nullptr);
 
+    // Add the log into logs_, and return the future of its result.
+    // Pre-condition: The caller needs to hold the logsLock_
+    folly::Future<AppendLogResult> bufferLog(ClusterID source,
+                                             LogType logType,
+                                             std::string log,
+                                             AtomicOp op);
+
+    // Queue the log when logs_ is full, return false if the queue is full as well.
+    // Pre-condition: The caller needs to hold the logsLock_
+    bool queueLog(ClusterID source,
+                  LogType logType,
+                  std::string& log,
+                  AtomicOp& op,
+                  folly::Future<AppendLogResult>& future);
+
+    // Move the queued logs into logs_ until it is full.
+    // Pre-condition: The caller needs to hold the logsLock_
+    void admitQueuedLogs();
+
+    // Pre-condition: The caller needs to hold the logsLock_
+    void failQueuedLogs(AppendLogResult res);
+
+    // Replace the exhausted iter with the logs buffered meanwhile, admitting the queued ones
+    // first. replicatingLogs_ is reset and false is returned if there is no log left.
+    // Pre-condition: The caller needs to hold the logsLock_
+    bool prepareNextLogs(AppendLogsIterator& iter, LogID firstLogId, TermID termId);
+
+    // Add the value into the histogram of all parts, of the space and of the part
+    void addQueueStats(stats::CounterId total,
+                       stats::CounterId space,
+                       stats::CounterId part,
+                       int64_t value);
+
     void appendLogsInternal(AppendLogsIterator iter, TermID termId);
 
     void replicateLogs(
@@ -522,6 +567,17 @@ protected:
     std::atomic_bool bufferOverFlow_{false};
     PromiseSet<AppendLogResult> cachingPromise_;
     LogCache logs_;
+    // The logs waiting for the room in logs_, and their total bytes, also protected by logsLock_
+    std::deque<QueuedLog> queuedLogs_;
+    size_t queuedBytes_{0};
+    // The total bytes of logs queued by all parts in the space
+    std::shared_ptr<std::atomic<int64_t>> spaceQueuedBytes_;
+    // The histograms of the queue depth and wait time of the space, and of the part if
+    // FLAGS_raft_append_queue_part_stats
+    stats::CounterId spaceQueueDepth_;
+    stats::CounterId spaceQueueWaitUs_;
+    stats::CounterId partQueueDepth_;
+    stats::CounterId partQueueWaitUs_;
 
     // Partition level lock to synchronize the access of the partition
     mutable std::mutex raftLock_;
@@ -529,7 +585,9 @@ protected:
     PromiseSet<AppendLogResult> sendingPromise_;
 
     Status status_;
-    Role role_;
+    // role_ and the lease related fields below are only modified with raftLock_ held, but they
+    // are atomic so that leaseValid() and isLeader() could be checked without the lock
+    std::atomic<Role> role_;
 
     // When the partition is the leader, the leader_ is same as addr_
     HostAddr leader_;
@@ -567,17 +625,19 @@ protected:
     time::Duration lastMsgRecvDur_;
     // To record how long ago when the last log message or heartbeat was sent
     time::Duration lastMsgSentDur_;
-    // To record when the last message was accepted by majority peers
-    uint64_t lastMsgAcceptedTime_{0};
-    // How long between last message was sent and was accepted by majority peers
-    uint64_t lastMsgAcceptedCostMs_{0};
+    // To record when the last message accepted by majority peers was sent, i.e. the time it was
+    // accepted minus the net io time. It is a single field rather than the accepted time and the
+    // cost, otherwise leaseValid() could read the time of one message with the cost of another
+    std::atomic<int64_t> lastAcceptedMsgSentTime_{0};
     // Make sure only one election is in progress
     std::atomic_bool inElection_{false};
     // Speed up first election when I don't know who is leader
     bool isBlindFollower_{true};
     // Check leader has commit log in this term (accepted by majority is not enough),
     // leader is not allowed to service until it is true.
-    bool commitInThisTerm_{false};
+    std::atomic_bool commitInThisTerm_{false};
+    // Whether hosts_ is empty, i.e. the only replica of the partition
+    std::atomic_bool noPeers_{true};
 
     // Write-ahead Log
     std::shared_ptr<wal::FileBasedWal> wal_;
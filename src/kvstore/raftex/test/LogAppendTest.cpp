@@ -9,14 +9,19 @@
 #include "common/fs/FileUtils.h"
 #include "common/thread/GenericThreadPool.h"
 #include "common/network/NetworkUtils.h"
+#include "kvstore/raftex/Host.h"
 #include "kvstore/raftex/RaftexService.h"
 #include "kvstore/raftex/test/RaftexTestBase.h"
 #include "kvstore/raftex/test/TestShard.h"
+#include "kvstore/wal/FileBasedWal.h"
 #include <gtest/gtest.h>
 #include <folly/String.h>
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_uint32(max_batch_size);
+DECLARE_uint32(max_appendlog_batch_size);
+DECLARE_uint32(max_inflight_appendlog_requests);
+DECLARE_uint64(raft_append_queue_total_max_bytes);
 
 namespace nebula {
 namespace raftex {
@@ -135,6 +140,257 @@ TEST(LogAppend, MultiThreadAppend) {
     finishRaft(services, copies, workers, leader);
 }
 
+TEST(LogAppend, PipelinedAppend) {
+    // Small batches, so the logs are sent to each follower by several requests in flight
+    auto batchSize = FLAGS_max_appendlog_batch_size;
+    auto inflight = FLAGS_max_inflight_appendlog_requests;
+    FLAGS_max_appendlog_batch_size = 4;
+    FLAGS_max_inflight_appendlog_requests = 4;
+
+    fs::TempDir walRoot("/tmp/pipelined_append.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 199, leader, msgs);
+    checkConsensus(copies, 0, 199, msgs);
+
+    finishRaft(services, copies, workers, leader);
+
+    FLAGS_max_appendlog_batch_size = batchSize;
+    FLAGS_max_inflight_appendlog_requests = inflight;
+}
+
+TEST(LogAppend, PipelineRollback) {
+    auto batchSize = FLAGS_max_appendlog_batch_size;
+    auto inflight = FLAGS_max_inflight_appendlog_requests;
+    FLAGS_max_appendlog_batch_size = 4;
+    FLAGS_max_inflight_appendlog_requests = 4;
+
+    fs::TempDir walRoot("/tmp/pipeline_rollback.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(1, walRoot, workers, wals, allHosts, services, copies, leader);
+    checkLeadership(copies, leader);
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 99, leader, msgs);
+    checkConsensus(copies, 0, 99, msgs);
+
+    // The requests to this follower are never sent, the responses are made up below, so they
+    // could be reordered or dropped
+    auto host = std::make_shared<Host>(HostAddr("127.0.0.1", 0), leader);
+    LogID lastLogId = leader->wal()->lastLogId();
+    TermID term = leader->wal()->lastLogTerm();
+    LogID base = lastLogId - 16;
+    auto response = [&] (cpp2::ErrorCode code, LogID followerLogId) {
+        cpp2::AppendLogResponse resp;
+        resp.set_error_code(code);
+        resp.set_current_term(term);
+        resp.set_last_log_id(followerLogId);
+        resp.set_last_log_term(term);
+        resp.set_committed_log_id(followerLogId);
+        return folly::Try<cpp2::AppendLogResponse>(std::move(resp));
+    };
+
+    {
+        std::lock_guard<std::mutex> g(host->lock_);
+        host->logTermToSend_ = term;
+        host->logIdToSend_ = lastLogId;
+        host->committedLogId_ = lastLogId;
+        host->lastLogIdSent_ = base;
+        host->lastLogTermSent_ = term;
+        host->replicating_ = true;
+
+        // The window is filled by 4 requests of 4 logs
+        auto reqs = host->nextRequests();
+        ASSERT_EQ(4, reqs.size());
+        for (LogID i = 0; i < 4; i++) {
+            EXPECT_EQ(base + 4 * i, reqs[i]->get_last_log_id_sent());
+            EXPECT_EQ(4, reqs[i]->get_log_str_list().size());
+        }
+        EXPECT_EQ(4, host->inflight_);
+        EXPECT_EQ(lastLogId, host->sentLogId_);
+        auto epoch = host->epoch_;
+
+        // The first request is acknowledged
+        host->handleAppendLogResponse(*reqs[0], epoch,
+                                      response(cpp2::ErrorCode::SUCCEEDED, base + 4));
+        EXPECT_EQ(base + 4, host->lastLogIdSent_);
+
+        // The second request is dropped, so the third one meets a gap, the logs after the last
+        // acknowledged one are sent again
+        host->handleAppendLogResponse(*reqs[2], epoch,
+                                      response(cpp2::ErrorCode::E_LOG_GAP, base + 4));
+        EXPECT_EQ(base + 4, host->lastLogIdSent_);
+        EXPECT_EQ(base + 4, host->sentLogId_);
+        EXPECT_EQ(epoch + 1, host->epoch_);
+        EXPECT_TRUE(host->replicating_);
+
+        // The window has room for two requests, sent from the last acknowledged log
+        auto pending = host->nextRequests();
+        ASSERT_EQ(2, pending.size());
+        EXPECT_EQ(base + 4, pending[0]->get_last_log_id_sent());
+        EXPECT_EQ(base + 8, pending[1]->get_last_log_id_sent());
+
+        // The responses of the requests before the rollback come back late and out of order,
+        // they are ignored
+        host->handleAppendLogResponse(*reqs[3], epoch,
+                                      response(cpp2::ErrorCode::SUCCEEDED, lastLogId));
+        host->handleAppendLogResponse(
+            *reqs[1], epoch,
+            folly::Try<cpp2::AppendLogResponse>(
+                folly::make_exception_wrapper<std::runtime_error>("dropped")));
+        EXPECT_EQ(base + 4, host->lastLogIdSent_);
+        EXPECT_TRUE(host->replicating_);
+        EXPECT_EQ(2, host->inflight_);
+
+        // Only the last 4 logs are left to send
+        auto more = host->nextRequests();
+        ASSERT_EQ(1, more.size());
+        EXPECT_EQ(base + 12, more[0]->get_last_log_id_sent());
+        EXPECT_EQ(4, more[0]->get_log_str_list().size());
+        pending.insert(pending.end(), more.begin(), more.end());
+
+        // The requests sent again are acknowledged in order, and the promise is fulfilled by
+        // the last one
+        auto future = host->promise_.getFuture();
+        for (size_t i = 0; i < pending.size(); i++) {
+            LogID acked = pending[i]->get_last_log_id_sent() + 4;
+            host->handleAppendLogResponse(*pending[i], epoch + 1,
+                                          response(cpp2::ErrorCode::SUCCEEDED, acked));
+            EXPECT_EQ(acked, host->lastLogIdSent_);
+        }
+        EXPECT_EQ(lastLogId, host->lastLogIdSent_);
+        EXPECT_FALSE(host->replicating_);
+        EXPECT_EQ(0, host->inflight_);
+        ASSERT_TRUE(future.isReady());
+        EXPECT_EQ(cpp2::ErrorCode::SUCCEEDED, std::move(future).get().get_error_code());
+        EXPECT_TRUE(host->nextRequests().empty());
+        EXPECT_FALSE(host->requestOnGoing_);
+    }
+    host.reset();
+
+    finishRaft(services, copies, workers, leader);
+
+    FLAGS_max_appendlog_batch_size = batchSize;
+    FLAGS_max_inflight_appendlog_requests = inflight;
+}
+
+TEST(LogAppend, QueueWhenBufferFull) {
+    fs::TempDir walRoot("/tmp/queue_when_buffer_full.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    // The buffer is much smaller than the logs appended, the logs which can't be buffered
+    // wait in the queue instead of failing
+    const int numThreads = 4;
+    const int numLogs = 100;
+    auto batchSize = FLAGS_max_batch_size;
+    FLAGS_max_batch_size = 4;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back(std::thread([i, leader] {
+            std::vector<folly::Future<AppendLogResult>> futures;
+            for (int j = 1; j <= numLogs; ++j) {
+                futures.emplace_back(leader->appendAsync(
+                    0, folly::stringPrintf("Log %03d for t%d", j, i)));
+            }
+            for (auto& fut : futures) {
+                ASSERT_EQ(AppendLogResult::SUCCEEDED, std::move(fut).get());
+            }
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    FLAGS_max_batch_size = batchSize;
+
+    // Sleep a while to make sure the last log has been committed on followers
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+
+    // The logs of each thread are in the order they were appended
+    for (auto& c : copies) {
+        ASSERT_EQ(numThreads * numLogs, c->getNumLogs());
+        std::vector<int> lastLog(numThreads, 0);
+        for (int i = 0; i < numThreads * numLogs; ++i) {
+            folly::StringPiece msg;
+            ASSERT_TRUE(c->getLogMsg(i, msg));
+            int j = 0, t = 0;
+            ASSERT_EQ(2, sscanf(msg.str().c_str(), "Log %d for t%d", &j, &t));
+            ASSERT_EQ(lastLog[t] + 1, j);
+            lastLog[t] = j;
+        }
+    }
+
+    finishRaft(services, copies, workers, leader);
+}
+
+TEST(LogAppend, RejectWhenQueueFull) {
+    fs::TempDir walRoot("/tmp/reject_when_queue_full.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    // The process-wide limit only leaves room for one queued log
+    auto batchSize = FLAGS_max_batch_size;
+    auto totalBytes = FLAGS_raft_append_queue_total_max_bytes;
+    FLAGS_max_batch_size = 1;
+    FLAGS_raft_append_queue_total_max_bytes = 1;
+    std::vector<folly::Future<AppendLogResult>> futures;
+    for (int i = 1; i <= 100; ++i) {
+        futures.emplace_back(leader->appendAsync(0, folly::stringPrintf("Log %03d", i)));
+    }
+    int rejected = 0;
+    for (auto& fut : futures) {
+        auto res = std::move(fut).get();
+        if (res == AppendLogResult::E_BUFFER_OVERFLOW) {
+            rejected++;
+        } else {
+            ASSERT_EQ(AppendLogResult::SUCCEEDED, res);
+        }
+    }
+    EXPECT_LT(0, rejected);
+
+    // The queue has been drained, so the logs are not rejected any more
+    ASSERT_EQ(AppendLogResult::SUCCEEDED, leader->appendAsync(0, "Log after").get());
+    FLAGS_max_batch_size = batchSize;
+    FLAGS_raft_append_queue_total_max_bytes = totalBytes;
+
+    finishRaft(services, copies, workers, leader);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -16,6 +16,7 @@
 #include <folly/String.h>
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
+DECLARE_uint32(max_batch_size);
 
 
 namespace nebula {
@@ -242,6 +243,32 @@ TEST_F(LogCASTest, EmptyTest) {
     }
 }
 
+TEST_F(LogCASTest, QueuedLogsAfterInvalidCAS) {
+    // The buffer holds one log only, so the logs appended meanwhile wait in the queue. They
+    // are still replicated when a whole batch is made of invalid CAS.
+    auto batchSize = FLAGS_max_batch_size;
+    FLAGS_max_batch_size = 1;
+    LOG(INFO) << "=====> Start appending logs";
+    std::vector<std::string> msgs;
+    std::vector<folly::Future<AppendLogResult>> futures;
+    for (int i = 0; i < 10; ++i) {
+        futures.emplace_back(leader_->atomicOpAsync([] () {
+            return test::compareAndSet("FCAS Log Message");
+        }));
+        auto msg = folly::stringPrintf("Test Log Message %02d", i);
+        msgs.emplace_back(msg);
+        futures.emplace_back(leader_->appendAsync(0, std::move(msg)));
+    }
+    for (auto& fut : futures) {
+        fut.wait(std::chrono::seconds(10));
+        ASSERT_TRUE(fut.isReady());
+    }
+    LOG(INFO) << "<===== Finish appending logs";
+    FLAGS_max_batch_size = batchSize;
+
+    checkConsensus(copies_, 0, 9, msgs);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -0,0 +1,128 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/meta/Common.h"
+#include <folly/Benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+#include "kvstore/NebulaStore.h"
+#include "kvstore/PartManager.h"
+
+DEFINE_int32(reader_threads, 16, "Number of threads reading concurrently");
+DEFINE_int32(append_batch_size, 16, "Number of kvs in each append");
+
+// Read throughput of NebulaStore::get, every get checks the leadership and lease of the part,
+// with or without a concurrent writer which keeps appending logs to the same part.
+
+namespace nebula {
+namespace kvstore {
+
+const GraphSpaceID kSpaceId = 1;
+const PartitionID kPartId = 1;
+
+std::unique_ptr<fs::TempDir> rootPath;
+std::unique_ptr<NebulaStore> store;
+
+void initStore() {
+    auto partMan = std::make_unique<MemPartManager>();
+    partMan->partsMap_[kSpaceId][kPartId] = meta::PartHosts();
+    auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+    auto workers = apache::thrift::concurrency::PriorityThreadManager::newPriorityThreadManager(
+        1, true /*stats*/);
+    workers->setNamePrefix("executor");
+    workers->start();
+
+    rootPath = std::make_unique<fs::TempDir>("/tmp/leader_lease_bm.XXXXXX");
+    std::vector<std::string> paths;
+    paths.emplace_back(folly::stringPrintf("%s/disk1", rootPath->path()));
+
+    KVOptions options;
+    options.dataPaths_ = std::move(paths);
+    options.partMan_ = std::move(partMan);
+    HostAddr local = {"", 0};
+    store = std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, workers);
+    store->init();
+    while (!store->isLeader(kSpaceId, kPartId)) {
+        usleep(100000);
+    }
+
+    folly::Baton<true, std::atomic> baton;
+    store->asyncMultiPut(kSpaceId, kPartId, {{"key", "val"}},
+                         [&baton] (nebula::cpp2::ErrorCode code) {
+        CHECK_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+        baton.post();
+    });
+    baton.wait();
+}
+
+void readWithAppends(size_t iters, bool append) {
+    std::atomic<bool> stop{false};
+    std::unique_ptr<std::thread> writer;
+    BENCHMARK_SUSPEND {
+        if (append) {
+            writer = std::make_unique<std::thread>([&stop] {
+                int64_t i = 0;
+                while (!stop) {
+                    std::vector<KV> data;
+                    for (int32_t j = 0; j < FLAGS_append_batch_size; j++, i++) {
+                        data.emplace_back(folly::to<std::string>(i), std::string(128, 'v'));
+                    }
+                    folly::Baton<true, std::atomic> baton;
+                    store->asyncMultiPut(kSpaceId, kPartId, std::move(data),
+                                         [&baton] (nebula::cpp2::ErrorCode) {
+                        baton.post();
+                    });
+                    baton.wait();
+                }
+            });
+        }
+    }
+
+    std::vector<std::thread> readers;
+    auto readsPerThread = iters / FLAGS_reader_threads + 1;
+    for (int32_t i = 0; i < FLAGS_reader_threads; i++) {
+        readers.emplace_back([readsPerThread] {
+            std::string val;
+            for (size_t j = 0; j < readsPerThread; j++) {
+                auto code = store->get(kSpaceId, kPartId, "key", &val);
+                folly::doNotOptimizeAway(code);
+            }
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    BENCHMARK_SUSPEND {
+        stop = true;
+        if (writer != nullptr) {
+            writer->join();
+        }
+    }
+}
+
+BENCHMARK(ReadWithoutAppend, iters) {
+    readWithAppends(iters, false);
+}
+
+BENCHMARK_RELATIVE(ReadWithConcurrentAppend, iters) {
+    readWithAppends(iters, true);
+}
+
+}  // namespace kvstore
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    nebula::kvstore::initStore();
+    folly::runBenchmarks();
+    nebula::kvstore::store.reset();
+    nebula::kvstore::rootPath.reset();
+    return 0;
+}
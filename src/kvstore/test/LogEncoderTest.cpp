@@ -150,6 +150,26 @@ TEST(LogEncoderTest, BatchTest) {
     ASSERT_EQ(expectd, decoded);
 }
 
+TEST(LogEncoderTest, SstChunkTest) {
+    std::string file;
+    int64_t offset = 0;
+    folly::StringPiece chunk;
+    {
+        auto row = encodeSstChunk("123.0.sst", 1024, "sst bytes");
+        ASSERT_TRUE(decodeSstChunk(row, file, offset, chunk));
+        EXPECT_EQ("123.0.sst", file);
+        EXPECT_EQ(1024, offset);
+        EXPECT_EQ("sst bytes", chunk.str());
+    }
+    // Normal rows of snapshot are not regarded as chunks
+    {
+        auto row = encodeKV(std::string(4, '\0'), "val");
+        EXPECT_FALSE(decodeSstChunk(row, file, offset, chunk));
+        row = encodeKV("__spaces__", "val");
+        EXPECT_FALSE(decodeSstChunk(row, file, offset, chunk));
+    }
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
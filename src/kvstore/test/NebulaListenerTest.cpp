@@ -11,6 +11,7 @@
 #include "common/meta/Common.h"
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 #include <gtest/gtest.h>
+#include <rocksdb/merge_operator.h>
 #include "kvstore/NebulaStore.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/LogEncoder.h"
@@ -29,6 +30,27 @@ using nebula::meta::ListenerHosts;
 namespace nebula {
 namespace kvstore {
 
+// Append the operands to the value
+class AppendOperator : public rocksdb::AssociativeMergeOperator {
+public:
+    const char* Name() const override {
+        return "AppendOperator";
+    }
+
+    bool Merge(const rocksdb::Slice&,
+               const rocksdb::Slice* existing,
+               const rocksdb::Slice& operand,
+               std::string* newValue,
+               rocksdb::Logger*) const override {
+        newValue->clear();
+        if (existing != nullptr) {
+            newValue->assign(existing->data(), existing->size());
+        }
+        newValue->append(operand.data(), operand.size());
+        return true;
+    }
+};
+
 class DummyListener : public Listener {
 public:
     DummyListener(GraphSpaceID spaceId,
@@ -51,6 +73,15 @@ public:
         data_.clear();
     }
 
+    std::vector<KV> merges() {
+        return merges_;
+    }
+
+    // The number of kv applied when each round of merges is applied
+    std::vector<size_t> dataSizeOnMerge() {
+        return dataSizeOnMerge_;
+    }
+
     std::pair<int64_t, int64_t> commitSnapshot(const std::vector<std::string>& data,
                                                LogID committedLogId,
                                                TermID committedLogTerm,
@@ -85,6 +116,14 @@ protected:
         return true;
     }
 
+    bool applyMerge(const std::vector<KV>& operands) override {
+        dataSizeOnMerge_.emplace_back(data_.size());
+        for (const auto& kv : operands) {
+            merges_.emplace_back(kv);
+        }
+        return true;
+    }
+
     bool persist(LogID, TermID, LogID) override {
         return true;
     }
@@ -99,6 +138,8 @@ protected:
 
 private:
     std::vector<KV> data_;
+    std::vector<KV> merges_;
+    std::vector<size_t> dataSizeOnMerge_;
     std::pair<int64_t, int64_t> committedSnapshot_{0, 0};
 };
 
@@ -182,6 +223,7 @@ protected:
         KVOptions options;
         options.dataPaths_ = std::move(paths);
         options.partMan_ = std::move(partMan);
+        options.mergeOp_ = std::make_shared<AppendOperator>();
         HostAddr local = peers_[index];
         return std::make_unique<NebulaStore>(std::move(options),
                                              ioThreadPool,
@@ -339,6 +381,61 @@ TEST_P(ListenerBasicTest, SimpleTest) {
     }
 }
 
+TEST_P(ListenerBasicTest, MergeTest) {
+    auto put = [this] (PartitionID partId, int32_t round) {
+        std::vector<KV> data;
+        for (int32_t i = 0; i < 10; i++) {
+            data.emplace_back(folly::stringPrintf("key_%d_%d", partId, i),
+                              folly::stringPrintf("val_%d_%d_%d", partId, i, round));
+        }
+        auto index = findStoreIndex(findLeader(partId));
+        folly::Baton<true, std::atomic> baton;
+        stores_[index]->asyncMultiPut(spaceId_, partId, std::move(data),
+                                      [&baton](cpp2::ErrorCode code) {
+            EXPECT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    };
+
+    LOG(INFO) << "Put, merge and put again";
+    for (int32_t partId = 1; partId <= partCount_; partId++) {
+        put(partId, 0);
+        auto index = findStoreIndex(findLeader(partId));
+        for (int32_t i = 0; i < 10; i++) {
+            folly::Baton<true, std::atomic> baton;
+            stores_[index]->asyncMerge(spaceId_, partId,
+                                       folly::stringPrintf("key_%d_%d", partId, i),
+                                       folly::stringPrintf("_merge_%d", i),
+                                       [&baton](cpp2::ErrorCode code) {
+                EXPECT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+                baton.post();
+            });
+            baton.wait();
+        }
+        put(partId, 1);
+    }
+
+    // wait listener commit
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+
+    LOG(INFO) << "Check listener's data and merges";
+    for (int32_t partId = 1; partId <= partCount_; partId++) {
+        auto dummy = dummys_[partId];
+        CHECK_EQ(20, dummy->data().size());
+        const auto& merges = dummy->merges();
+        CHECK_EQ(10, merges.size());
+        for (int32_t i = 0; i < static_cast<int32_t>(merges.size()); i++) {
+            CHECK_EQ(folly::stringPrintf("key_%d_%d", partId, i), merges[i].first);
+            CHECK_EQ(folly::stringPrintf("_merge_%d", i), merges[i].second);
+        }
+        // The merges are applied after the first puts, and before the second ones
+        for (auto size : dummy->dataSizeOnMerge()) {
+            CHECK_EQ(10, size);
+        }
+    }
+}
+
 TEST_P(ListenerBasicTest, TransLeaderTest) {
     LOG(INFO) << "Insert some data";
     for (int32_t partId = 1; partId <= partCount_; partId++) {
@@ -17,6 +17,7 @@
 #include "kvstore/PartManager.h"
 #include "kvstore/RocksEngine.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "kvstore/StartupProgress.h"
 #include "kvstore/LogEncoder.h"
 #include "meta/ActiveHostsMan.h"
 
@@ -192,6 +193,18 @@ TEST(NebulaStoreTest, PartsTest) {
         }
     };
     check(0);
+    {
+        // the engines and parts on disks are loaded concurrently, the others are added from meta
+        auto progress = StartupProgress::instance().toJson();
+        auto phase = [&](StartupProgress::Phase p) -> const folly::dynamic& {
+            return progress["phases"].at(static_cast<size_t>(p));
+        };
+        ASSERT_EQ("finished", phase(StartupProgress::kOpenEngines)["state"].asString());
+        ASSERT_EQ(2, phase(StartupProgress::kOpenEngines)["done"].asInt());
+        ASSERT_EQ(6, phase(StartupProgress::kLoadParts)["total"].asInt());
+        ASSERT_EQ(6, phase(StartupProgress::kLoadParts)["done"].asInt());
+        ASSERT_EQ(10, phase(StartupProgress::kLoadFromMeta)["done"].asInt());
+    }
     // After init, the parts should be 0-9, and the distribution should be
     // disk1: 0, 1, 2, 3, 8
     // disk2: 4, 5, 6, 7, 9
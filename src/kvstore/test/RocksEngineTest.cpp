@@ -29,6 +29,34 @@ TEST(RocksEngineTest, SimpleTest) {
 }
 
 
+TEST(RocksEngineTest, MultiGetTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_MultiGetTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10;  i++) {
+        data.emplace_back(folly::stringPrintf("key_%d", i), folly::stringPrintf("val_%d", i));
+    }
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+    // flush part of the keys into sst files
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put("key_10", "val_10"));
+
+    // the keys are not sorted, with missing and duplicate ones
+    std::vector<std::string> keys = {"key_7", "key_10", "key_3", "key_20", "key_0", "key_7"};
+    std::vector<std::string> values;
+    auto status = engine->multiGet(keys, &values);
+    ASSERT_EQ(keys.size(), status.size());
+    ASSERT_EQ(keys.size(), values.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == "key_20") {
+            EXPECT_TRUE(status[i].isKeyNotFound());
+        } else {
+            EXPECT_TRUE(status[i].ok());
+            EXPECT_EQ("val_" + keys[i].substr(4), values[i]);
+        }
+    }
+}
+
 TEST(RocksEngineTest, RangeTest) {
     fs::TempDir rootPath("/tmp/rocksdb_engine_RangeTest.XXXXXX");
     auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
@@ -15,6 +15,9 @@ DEFINE_int32(wal_ttl, 14400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 16 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
 DEFINE_bool(wal_sync, false, "Whether fsync needs to be called every write");
+DEFINE_bool(wal_mmap_read, true,
+            "Whether to read the wal files by mmap when the logs are not in the buffer, such as "
+            "the catching up of followers and listeners");
 
 namespace nebula {
 namespace wal {
@@ -492,18 +495,21 @@ void FileBasedWal::scanLastWal(WalFileInfoPtr info, LogID firstId) {
     close(fd);
 }
 
-bool FileBasedWal::appendLogInternal(LogID id,
-                                     TermID term,
-                                     ClusterID cluster,
-                                     std::string msg) {
+bool FileBasedWal::prepareLog(LogID id,
+                              TermID term,
+                              ClusterID cluster,
+                              const std::string& msg,
+                              const PendingLogs& pending) {
     if (stopped_) {
         LOG(ERROR) << idStr_ << "WAL has stopped. Do not accept logs any more";
         return false;
     }
 
-    if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
+    // The logs not written yet should be taken into account as well
+    LogID lastLogId = pending.empty() ? lastLogId_ : std::get<0>(pending.back());
+    if (lastLogId != 0 && (firstLogId_ != 0 || !pending.empty()) && id != lastLogId + 1) {
         LOG(ERROR) << idStr_ << "There is a gap in the log id. The last log id is "
-                   << lastLogId_
+                   << lastLogId
                    << ", and the id being appended is " << id;
         return false;
     }
@@ -512,36 +518,70 @@ bool FileBasedWal::appendLogInternal(LogID id,
         LOG(ERROR) << idStr_ << "Pre process failed for log " << id;
         return false;
     }
+    return true;
+}
 
-    // Write to the WAL file first
-    std::string strBuf;
-    strBuf.reserve(sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(ClusterID)
-                    + msg.size()
-                    + 2 * sizeof(int32_t));
-    strBuf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
-    strBuf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
+
+void FileBasedWal::encodeLog(LogID id,
+                             TermID term,
+                             ClusterID cluster,
+                             const std::string& msg,
+                             std::string& buf) {
     int32_t len = msg.size();
-    strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-    strBuf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
-    strBuf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
-    strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+    buf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
+    buf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
+    buf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+    buf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
+    buf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
+    buf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+}
 
-    // Prepare the WAL file if it's not opened
-    if (currFd_ < 0) {
-        prepareNewFile(id);
-    } else if (currInfo_->size() + strBuf.size() > policy_.fileSize) {
-        // Need to roll over
+
+bool FileBasedWal::bufferLog(LogID id,
+                             TermID term,
+                             ClusterID cluster,
+                             std::string msg,
+                             std::string& buf,
+                             PendingLogs& pending) {
+    if (!prepareLog(id, term, cluster, msg, pending)) {
+        return false;
+    }
+
+    size_t logSize = sizeof(LogID)
+                     + sizeof(TermID)
+                     + sizeof(ClusterID)
+                     + msg.size()
+                     + 2 * sizeof(int32_t);
+    // A batch never spans across wal files, so flush the pending logs before rolling over
+    size_t currSize = (currFd_ < 0 ? 0 : currInfo_->size()) + buf.size();
+    if (currSize > 0 && currSize + logSize > policy_.fileSize) {
+        flushLogs(buf, pending);
         closeCurrFile();
 
         std::lock_guard<std::mutex> g(walFilesMutex_);
         prepareNewFile(id);
     }
 
-    ssize_t bytesWritten = write(currFd_, strBuf.data(), strBuf.size());
-    if (bytesWritten != (ssize_t)strBuf.size()) {
-        LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << strBuf.size()
+    encodeLog(id, term, cluster, msg, buf);
+    pending.emplace_back(id, term, cluster, std::move(msg));
+    return true;
+}
+
+
+void FileBasedWal::flushLogs(std::string& buf, PendingLogs& pending) {
+    if (pending.empty()) {
+        return;
+    }
+
+    // Prepare the WAL file if it's not opened
+    if (currFd_ < 0) {
+        prepareNewFile(std::get<0>(pending.front()));
+    }
+
+    // All logs in the batch are written by one write, and synced once at most
+    ssize_t bytesWritten = write(currFd_, buf.data(), buf.size());
+    if (bytesWritten != (ssize_t)buf.size()) {
+        LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << buf.size()
                    << ", error:" << strerror(errno);
     }
 
@@ -549,17 +589,40 @@ bool FileBasedWal::appendLogInternal(LogID id,
         LOG(WARNING) << "sync wal \"" << currInfo_->path()
                      << "\" failed, error: " << strerror(errno);
     }
-    currInfo_->setSize(currInfo_->size() + strBuf.size());
-    currInfo_->setLastId(id);
-    currInfo_->setLastTerm(term);
 
-    lastLogId_ = id;
-    lastLogTerm_ = term;
+    auto lastId = std::get<0>(pending.back());
+    auto lastTerm = std::get<1>(pending.back());
+    currInfo_->setSize(currInfo_->size() + buf.size());
+    currInfo_->setLastId(lastId);
+    currInfo_->setLastTerm(lastTerm);
+
+    lastLogId_ = lastId;
+    lastLogTerm_ = lastTerm;
     if (firstLogId_ == 0) {
-        firstLogId_ = id;
+        firstLogId_ = std::get<0>(pending.front());
+    }
+
+    for (auto& log : pending) {
+        logBuffer_->push(std::get<0>(log),
+                         std::get<1>(log),
+                         std::get<2>(log),
+                         std::move(std::get<3>(log)));
     }
+    buf.clear();
+    pending.clear();
+}
+
 
-    logBuffer_->push(id, term, cluster, std::move(msg));
+bool FileBasedWal::appendLogInternal(LogID id,
+                                     TermID term,
+                                     ClusterID cluster,
+                                     std::string msg) {
+    std::string buf;
+    PendingLogs pending;
+    if (!bufferLog(id, term, cluster, std::move(msg), buf, pending)) {
+        return false;
+    }
+    flushLogs(buf, pending);
     return true;
 }
 
@@ -585,16 +648,24 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
         LOG_EVERY_N(WARNING, 100) << idStr_ << "Failed to appendLogs because of no more space";
         return false;
     }
+    // Group commit: serialize the whole batch into one buffer, then write it at once
+    std::string buf;
+    PendingLogs pending;
     for (; iter.valid(); ++iter) {
-        if (!appendLogInternal(iter.logId(),
-                               iter.logTerm(),
-                               iter.logSource(),
-                               iter.logMsg().toString())) {
+        if (!bufferLog(iter.logId(),
+                       iter.logTerm(),
+                       iter.logSource(),
+                       iter.logMsg().toString(),
+                       buf,
+                       pending)) {
             LOG(ERROR) << idStr_ << "Failed to append log for logId "
                        << iter.logId();
+            // The logs before the failed one have been accepted
+            flushLogs(buf, pending);
             return false;
         }
     }
+    flushLogs(buf, pending);
 
     return true;
 }
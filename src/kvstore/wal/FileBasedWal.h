@@ -159,6 +159,34 @@ private:
                            ClusterID cluster,
                            std::string msg);
 
+    // (id, term, cluster, msg) of the logs which have been encoded but not written yet
+    using PendingLogs = std::vector<std::tuple<LogID, TermID, ClusterID, std::string>>;
+
+    // Check the log id and call the pre-processor
+    bool prepareLog(LogID id,
+                    TermID term,
+                    ClusterID cluster,
+                    const std::string& msg,
+                    const PendingLogs& pending);
+
+    // Append the log in on-disk format to buf
+    static void encodeLog(LogID id,
+                          TermID term,
+                          ClusterID cluster,
+                          const std::string& msg,
+                          std::string& buf);
+
+    // Encode the log into buf, rolling over the wal file if needed
+    bool bufferLog(LogID id,
+                   TermID term,
+                   ClusterID cluster,
+                   std::string msg,
+                   std::string& buf,
+                   PendingLogs& pending);
+
+    // Write all pending logs by one write and at most one fsync
+    void flushLogs(std::string& buf, PendingLogs& pending);
+
 
 private:
     using WalFiles = std::map<LogID, WalFileInfoPtr>;
@@ -8,6 +8,10 @@
 #include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/WalFileInfo.h"
 #include "kvstore/wal/WalFileIterator.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+DECLARE_bool(wal_mmap_read);
 
 namespace nebula {
 namespace wal {
@@ -77,29 +81,11 @@ WalFileIterator::WalFileIterator(
     }
 
     if (!idRanges_.empty()) {
+        mapCurrFile();
         // Find the correct position in the first WAL file
         currPos_ = 0;
         while (true) {
-            LogID logId;
-            // Read the logID
-            int fd = fds_.front();
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&logId),
-                           sizeof(LogID),
-                           currPos_),
-                     static_cast<ssize_t>(sizeof(LogID)));
-            // Read the termID
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currTerm_),
-                           sizeof(TermID),
-                           currPos_ + sizeof(LogID)),
-                     static_cast<ssize_t>(sizeof(TermID)));
-            // Read the log length
-            CHECK_EQ(pread(fd,
-                           reinterpret_cast<char*>(&currMsgLen_),
-                           sizeof(int32_t),
-                           currPos_ + sizeof(LogID) + sizeof(TermID)),
-                     static_cast<ssize_t>(sizeof(int32_t)));
+            LogID logId = readLogHead();
             if (logId == currId_) {
                 break;
             }
@@ -114,6 +100,7 @@ WalFileIterator::WalFileIterator(
 
 
 WalFileIterator::~WalFileIterator() {
+    unmapCurrFile();
     for (auto& fd : fds_) {
         close(fd);
     }
@@ -129,6 +116,7 @@ LogIterator& WalFileIterator::operator++() {
                 << nextFirstId_
                 << ", so need to move to the next file";
         // Close the current file
+        unmapCurrFile();
         CHECK_EQ(close(fds_.front()), 0);
         fds_.pop_front();
         idRanges_.pop_front();
@@ -143,6 +131,7 @@ LogIterator& WalFileIterator::operator++() {
         nextFirstId_ = getFirstIdInNextFile();
         CHECK_EQ(currId_, idRanges_.front().first);
         currPos_ = 0;
+        mapCurrFile();
     } else {
         // Move to the next log
         currPos_ += sizeof(LogID)
@@ -157,27 +146,8 @@ LogIterator& WalFileIterator::operator++() {
         currId_ = lastId_ + 1;
         return *this;
     } else {
-        LogID logId;
-        int fd = fds_.front();
-        // Read the logID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&logId),
-                       sizeof(LogID),
-                       currPos_),
-                 static_cast<ssize_t>(sizeof(LogID))) << "currPos = " << currPos_;
+        LogID logId = readLogHead();
         CHECK_EQ(currId_, logId);
-        // Read the termID
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currTerm_),
-                       sizeof(TermID),
-                       currPos_ + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(TermID)));
-        // Read the log length
-        CHECK_EQ(pread(fd,
-                       reinterpret_cast<char*>(&currMsgLen_),
-                       sizeof(int32_t),
-                       currPos_ + sizeof(TermID) + sizeof(LogID)),
-                 static_cast<ssize_t>(sizeof(int32_t)));
     }
 
     return *this;
@@ -200,46 +170,81 @@ TermID WalFileIterator::logTerm() const {
 
 
 ClusterID WalFileIterator::logSource() const {
-            // Retrieve from the file
     DCHECK(!fds_.empty());
     ClusterID cluster = 0;
-    CHECK_EQ(pread(fds_.front(),
-                   &(cluster),
-                   sizeof(ClusterID),
-                   currPos_
-                    + sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(int32_t)),
-             static_cast<ssize_t>(sizeof(ClusterID)))
-        << "Failed to read. Curr position is " << currPos_
-        << ", expected read length is " << sizeof(ClusterID)
-        << " (errno: " << errno << "): " << strerror(errno);
-
+    read(&cluster, sizeof(ClusterID), currPos_ + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t));
     return cluster;
 }
 
 
 folly::StringPiece WalFileIterator::logMsg() const {
-    // Retrieve from the file
     DCHECK(!fds_.empty());
-
+    auto pos = currPos_ + sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) + sizeof(ClusterID);
+    if (mapped_ != nullptr && pos + currMsgLen_ <= mappedSize_) {
+        // The view is valid until the iterator moves to the next file
+        return folly::StringPiece(mapped_ + pos, currMsgLen_);
+    }
+    // Retrieve from the file
     currLog_.resize(currMsgLen_);
-    CHECK_EQ(pread(fds_.front(),
-                   &(currLog_[0]),
-                   currMsgLen_,
-                   currPos_
-                    + sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(int32_t)
-                    + sizeof(ClusterID)),
-             static_cast<ssize_t>(currMsgLen_))
-        << "Failed to read. Curr position is " << currPos_
-        << ", expected read length is " << currMsgLen_
+    read(&(currLog_[0]), currMsgLen_, pos);
+    return currLog_;
+}
+
+
+void WalFileIterator::mapCurrFile() {
+    unmapCurrFile();
+    if (!FLAGS_wal_mmap_read || fds_.empty()) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fds_.front(), &st) != 0 || st.st_size <= 0) {
+        return;
+    }
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fds_.front(), 0);
+    if (addr == MAP_FAILED) {
+        LOG(WARNING) << wal_->idStr_ << "Failed to map the wal file (" << errno << "): "
+                     << strerror(errno) << ", read it by pread";
+        return;
+    }
+    // The logs are read in order, let the kernel read ahead the whole file
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    madvise(addr, st.st_size, MADV_WILLNEED);
+    mapped_ = static_cast<char*>(addr);
+    mappedSize_ = st.st_size;
+}
+
+
+void WalFileIterator::unmapCurrFile() {
+    if (mapped_ != nullptr) {
+        munmap(mapped_, mappedSize_);
+        mapped_ = nullptr;
+        mappedSize_ = 0;
+    }
+}
+
+
+void WalFileIterator::read(void* buf, size_t len, int64_t pos) const {
+    if (mapped_ != nullptr && pos + len <= mappedSize_) {
+        memcpy(buf, mapped_ + pos, len);
+        return;
+    }
+    // The part of file appended after mapped is read by pread
+    CHECK_EQ(pread(fds_.front(), buf, len, pos), static_cast<ssize_t>(len))
+        << "Failed to read. Curr position is " << pos
+        << ", expected read length is " << len
         << " (errno: " << errno << "): " << strerror(errno);
+}
 
-    return currLog_;
+
+LogID WalFileIterator::readLogHead() {
+    LogID logId;
+    read(&logId, sizeof(LogID), currPos_);
+    read(&currTerm_, sizeof(TermID), currPos_ + sizeof(LogID));
+    read(&currMsgLen_, sizeof(int32_t), currPos_ + sizeof(LogID) + sizeof(TermID));
+    return logId;
 }
 
+
 LogID WalFileIterator::getFirstIdInNextFile() const {
     auto it = idRanges_.begin();
     ++it;
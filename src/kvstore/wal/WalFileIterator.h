@@ -40,6 +40,17 @@ public:
 private:
     LogID getFirstIdInNextFile() const;
 
+    // Map the current file if FLAGS_wal_mmap_read, the maps of the previous file is released
+    void mapCurrFile();
+
+    void unmapCurrFile();
+
+    // Read from the map of the current file if possible, otherwise by pread
+    void read(void* buf, size_t len, int64_t pos) const;
+
+    // Read the id, term and length of the log at currPos_, return the id
+    LogID readLogHead();
+
 private:
     // Holds the Wal object, so that it will not be destroyed before the iterator
     std::shared_ptr<FileBasedWal> wal_;
@@ -56,6 +67,10 @@ private:
     int64_t currPos_{0};
     int32_t currMsgLen_{0};
     mutable std::string currLog_;
+
+    // The map of the current file, the logs are returned as the views of it without copying
+    char* mapped_{nullptr};
+    size_t mappedSize_{0};
 };
 
 }  // namespace wal
@@ -8,6 +8,7 @@
 #include "common/fs/TempDir.h"
 #include <gtest/gtest.h>
 #include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/AtomicLogBuffer.h"
 
 DECLARE_int32(wal_ttl);
 
@@ -80,6 +81,65 @@ TEST(FileBasedWal, AppendLogs) {
 }
 
 
+TEST(FileBasedWal, AppendLogsInBatch) {
+    // Force to make each file 1MB, so some batches need to roll over
+    FileBasedWalInfo info;
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024L * 1024L;
+    policy.bufferSize = 1024L * 1024L;
+
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    info,
+                                    policy,
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    EXPECT_EQ(0, wal->lastLogId());
+
+    // Append > 5MB logs in batches of 300 logs
+    auto logs = AtomicLogBuffer::instance(16 * 1024 * 1024);
+    for (int i = 1; i <= 6000; i++) {
+        logs->push(i, 1, 0, folly::stringPrintf(kLongMsg, i));
+    }
+    for (int i = 1; i <= 6000; i += 300) {
+        auto iter = logs->iterator(i, i + 299);
+        ASSERT_TRUE(wal->appendLogs(*iter));
+        ASSERT_EQ(i + 299, wal->lastLogId());
+    }
+    {
+        // A batch with gap is rejected
+        auto iter = logs->iterator(6000, 6000);
+        ASSERT_FALSE(wal->appendLogs(*iter));
+        ASSERT_EQ(6000, wal->lastLogId());
+    }
+
+    // Close the wal
+    wal.reset();
+    auto files = FileUtils::listAllFilesInDir(walDir.path());
+    ASSERT_EQ(7, files.size());
+
+    // Now let's open it to read
+    wal = FileBasedWal::getWal(walDir.path(),
+                               info,
+                               policy,
+                               [](LogID, TermID, ClusterID, const std::string&) {
+                                   return true;
+                               });
+    EXPECT_EQ(6000, wal->lastLogId());
+
+    auto it = wal->iterator(1, 6000);
+    LogID id = 1;
+    while (it->valid()) {
+        ASSERT_EQ(id, it->logId());
+        ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+        ++(*it);
+        ++id;
+    }
+    EXPECT_EQ(6001, id);
+}
+
+
 TEST(FileBasedWal, CacheOverflow) {
     // Force to make each file 1MB, each buffer is 1MB, and there are two
     // buffers at most
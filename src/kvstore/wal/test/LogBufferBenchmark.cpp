@@ -5,8 +5,10 @@
  */
 
 #include "common/base/Base.h"
+#include "common/fs/TempDir.h"
 #include <folly/Benchmark.h>
 #include "kvstore/wal/AtomicLogBuffer.h"
+#include "kvstore/wal/FileBasedWal.h"
 #include "kvstore/wal/test/InMemoryLogBufferList.h"
 
 DEFINE_bool(only_seek, false, "Only seek in read test");
@@ -14,11 +16,17 @@ DEFINE_bool(only_seek, false, "Only seek in read test");
 #define TEST_WRTIE       1
 #define TEST_READ        1
 #define TEST_RW_MIXED    1
+#define TEST_WAL_APPEND  1
 
 using nebula::wal::AtomicLogBuffer;
 using nebula::wal::Record;
 using nebula::wal::InMemoryBufferList;
+using nebula::wal::FileBasedWal;
+using nebula::wal::FileBasedWalInfo;
+using nebula::wal::FileBasedWalPolicy;
 using nebula::LogID;
+using nebula::TermID;
+using nebula::ClusterID;
 
 void prepareData(std::shared_ptr<InMemoryBufferList> inMemoryLogBuffer,
                  int32_t len,
@@ -417,6 +425,77 @@ BENCHMARK_RELATIVE(AtomicLogBufferRWMixedWriteTest) {
 
 #endif
 
+#if TEST_WAL_APPEND
+/**
+ *  Append logs to wal, either one by one or by batch (group commit)
+ *
+ * */
+void runWalAppendTest(size_t iters, int32_t len, size_t batchSize, bool sync) {
+    std::unique_ptr<nebula::fs::TempDir> walDir;
+    std::shared_ptr<FileBasedWal> wal;
+    std::shared_ptr<AtomicLogBuffer> logs;
+    BENCHMARK_SUSPEND {
+        walDir = std::make_unique<nebula::fs::TempDir>("/tmp/LogBufferBenchmark.XXXXXX");
+        FileBasedWalPolicy policy;
+        policy.sync = sync;
+        wal = FileBasedWal::getWal(walDir->path(),
+                                   FileBasedWalInfo(),
+                                   policy,
+                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                       return true;
+                                   });
+        logs = AtomicLogBuffer::instance(std::numeric_limits<int32_t>::max());
+        for (size_t i = 1; i <= iters; i++) {
+            logs->push(i, 1, 0, std::string(len, 'A'));
+        }
+    }
+    if (batchSize == 1) {
+        for (size_t i = 1; i <= iters; i++) {
+            wal->appendLog(i, 1, 0, std::string(len, 'A'));
+        }
+    } else {
+        for (size_t i = 1; i <= iters; i += batchSize) {
+            auto iter = logs->iterator(i, std::min(iters, i + batchSize - 1));
+            wal->appendLogs(*iter);
+        }
+    }
+    BENCHMARK_SUSPEND {
+        wal.reset();
+        logs.reset();
+        walDir.reset();
+    }
+}
+
+BENCHMARK(WalAppendOneByOne, iters) {
+    runWalAppendTest(iters, 1024, 1, false);
+}
+
+BENCHMARK_RELATIVE(WalAppendBatch16, iters) {
+    runWalAppendTest(iters, 1024, 16, false);
+}
+
+BENCHMARK_RELATIVE(WalAppendBatch128, iters) {
+    runWalAppendTest(iters, 1024, 128, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(WalSyncAppendOneByOne, iters) {
+    runWalAppendTest(iters, 1024, 1, true);
+}
+
+BENCHMARK_RELATIVE(WalSyncAppendBatch16, iters) {
+    runWalAppendTest(iters, 1024, 16, true);
+}
+
+BENCHMARK_RELATIVE(WalSyncAppendBatch128, iters) {
+    runWalAppendTest(iters, 1024, 128, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+#endif
+
 /*************************
  * End of benchmarks
  ************************/
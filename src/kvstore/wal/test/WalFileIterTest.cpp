@@ -10,6 +10,8 @@
 #include "kvstore/wal/WalFileIterator.h"
 #include <gtest/gtest.h>
 
+DECLARE_bool(wal_mmap_read);
+
 namespace nebula {
 namespace wal {
 
@@ -110,6 +112,47 @@ TEST(WalFileIter, MultiFilesReadTest) {
     }
 }
 
+TEST(WalFileIter, MmapAndPreadTest) {
+    FileBasedWalInfo info;
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024;
+    TempDir walDir("/tmp/testWal.XXXXXX");
+
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    info,
+                                    policy,
+                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 1000; i++) {
+        EXPECT_TRUE(
+            wal->appendLog(i /*id*/, i / 100 /*term*/, i % 3 /*cluster*/,
+                           folly::stringPrintf("Test string %02d", i)));
+    }
+    EXPECT_LT(10, wal->walFiles_.size());
+
+    // The logs read by mmap and by pread should be the same, no matter where to start
+    bool mmapRead = FLAGS_wal_mmap_read;
+    for (auto useMmap : {true, false}) {
+        FLAGS_wal_mmap_read = useMmap;
+        for (LogID start : {1, 500, 999}) {
+            auto it = std::make_unique<WalFileIterator>(wal, start, 1000);
+            LogID id = start;
+            while (it->valid()) {
+                EXPECT_EQ(id, it->logId());
+                EXPECT_EQ(id / 100, it->logTerm());
+                EXPECT_EQ(id % 3, it->logSource());
+                EXPECT_EQ(folly::stringPrintf("Test string %02ld", id),
+                          it->logMsg());
+                ++(*it);
+                ++id;
+            }
+            EXPECT_EQ(1001, id);
+        }
+    }
+    FLAGS_wal_mmap_read = mmapRead;
+}
+
 
 }  // namespace wal
 }  // namespace nebula
@@ -151,8 +151,14 @@ void CreateTagIndexProcessor::process(const cpp2::CreateTagIndexReq& req) {
                 onFinished();
                 return;
             }
-            col.type.set_type(meta::cpp2::PropertyType::FIXED_STRING);
-            col.type.set_type_length(*field.get_type_length());
+            if (*field.get_type_length() == 0) {
+                // Length 0 means the index keeps the full string
+                col.type.set_type(meta::cpp2::PropertyType::STRING);
+                col.type.type_length_ref().reset();
+            } else {
+                col.type.set_type(meta::cpp2::PropertyType::FIXED_STRING);
+                col.type.set_type_length(*field.get_type_length());
+            }
         } else if (field.type_length_ref().has_value()) {
             LOG(ERROR) << "No need to set type length : " << field.get_name();
             handleErrorCode(nebula::cpp2::ErrorCode::E_INVALID_PARM);
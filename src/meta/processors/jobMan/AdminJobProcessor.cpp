@@ -8,6 +8,9 @@
 #include "meta/processors/jobMan/AdminJobProcessor.h"
 #include "meta/processors/jobMan/JobManager.h"
 #include "meta/processors/jobMan/JobDescription.h"
+#include "utils/OperationKeyUtils.h"
+
+DECLARE_bool(rebuild_index_by_ingest);
 
 namespace nebula {
 namespace meta {
@@ -41,6 +44,12 @@ void AdminJobProcessor::process(const cpp2::AdminJobReq& req) {
                     break;
                 }
             }
+            if ((cmd == cpp2::AdminCmd::REBUILD_TAG_INDEX ||
+                 cmd == cpp2::AdminCmd::REBUILD_EDGE_INDEX) &&
+                FLAGS_rebuild_index_by_ingest) {
+                // Both the hosts to run the job and the way storage writes the index follow it
+                paras.insert(paras.begin(), kRebuildIndexIngest);
+            }
 
             JobID jId = 0;
             auto jobExist = jobMgr->checkJobExist(cmd, paras, jId);
@@ -318,11 +318,44 @@ nebula::cpp2::ErrorCode JobManager::reportTaskFinish(const cpp2::ReportTaskReq&
         auto jobStatus = std::all_of(tasks.begin(), tasks.end(), [](auto& tsk) {
             return tsk.status_ == cpp2::JobStatus::FINISHED;
         }) ? cpp2::JobStatus::FINISHED : cpp2::JobStatus::FAILED;
+        if (jobStatus == cpp2::JobStatus::FINISHED) {
+            auto nextRet = runNextRound(jobId, tasks);
+            if (!nebula::ok(nextRet)) {
+                LOG(ERROR) << "Run the next round of job " << jobId << " failed, error: "
+                           << apache::thrift::util::enumNameSafe(nebula::error(nextRet));
+                jobStatus = cpp2::JobStatus::FAILED;
+            } else if (nebula::value(nextRet)) {
+                return nebula::cpp2::ErrorCode::SUCCEEDED;
+            }
+        }
         return jobFinished(jobId, jobStatus);
     }
     return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+ErrorOr<nebula::cpp2::ErrorCode, bool>
+JobManager::runNextRound(JobID jobId, std::list<TaskDescription>& tasks) {
+    auto optJobDescRet = JobDescription::loadJobDescription(jobId, kvStore_);
+    if (!nebula::ok(optJobDescRet)) {
+        return nebula::error(optJobDescRet);
+    }
+    auto optJobDesc = nebula::value(optJobDescRet);
+    auto jobExec =
+        MetaJobExecutorFactory::createMetaJobExecutor(optJobDesc, kvStore_, adminClient_);
+    if (!jobExec) {
+        LOG(WARNING) << folly::sformat("createMetaJobExecutor failed(), jobId={}", jobId);
+        return nebula::cpp2::ErrorCode::E_UNKNOWN;
+    }
+    if (!jobExec->check()) {
+        return nebula::cpp2::ErrorCode::E_INVALID_PARM;
+    }
+    auto rc = jobExec->prepare();
+    if (rc != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return rc;
+    }
+    return jobExec->nextRound(tasks);
+}
+
 ErrorOr<nebula::cpp2::ErrorCode, std::list<TaskDescription>>
 JobManager::getAllTasks(JobID jobId) {
     std::list<TaskDescription> taskDescriptions;
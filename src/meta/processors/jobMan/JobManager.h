@@ -127,6 +127,10 @@ private:
     nebula::cpp2::ErrorCode
     saveTaskStatus(TaskDescription& td, const cpp2::ReportTaskReq& req);
 
+    // Dispatch the next round of the job if it has one, see MetaJobExecutor::nextRound
+    ErrorOr<nebula::cpp2::ErrorCode, bool>
+    runNextRound(JobID jobId, std::list<TaskDescription>& tasks);
+
 private:
     // Todo(pandasheep)
     // When folly is upgraded, PriorityUMPSCQueueSet can be used
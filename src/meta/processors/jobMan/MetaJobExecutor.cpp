@@ -146,6 +146,33 @@ ErrOrHosts MetaJobExecutor::getLeaderHost(GraphSpaceID space) {
     return hosts;
 }
 
+ErrOrHosts MetaJobExecutor::getReplicaHost(GraphSpaceID space) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    const auto& partPrefix = MetaServiceUtils::partPrefix(space);
+    auto retCode = kvstore_->prefix(kDefaultSpaceId, kDefaultPartId, partPrefix, &iter);
+    if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        LOG(ERROR) << "Get space " << space << "'s part failed, error: "
+                   << apache::thrift::util::enumNameSafe(retCode);
+        return retCode;
+    }
+
+    std::vector<std::pair<HostAddr, std::vector<PartitionID>>> hosts;
+    for (; iter->valid(); iter->next()) {
+        auto partId = MetaServiceUtils::parsePartKeyPartId(iter->key());
+        for (auto& host : MetaServiceUtils::parsePartVal(iter->val())) {
+            auto it = std::find_if(hosts.begin(), hosts.end(), [&](auto& item){
+                return item.first == host;
+            });
+            if (it == hosts.end()) {
+                hosts.emplace_back(std::make_pair(host, std::vector<PartitionID>{partId}));
+            } else {
+                it->second.emplace_back(partId);
+            }
+        }
+    }
+    return hosts;
+}
+
 ErrOrHosts MetaJobExecutor::getListenerHost(GraphSpaceID space, cpp2::ListenerType type) {
     const auto& prefix = MetaServiceUtils::listenerPrefix(space, type);
     std::unique_ptr<kvstore::KVIterator> iter;
@@ -201,6 +228,10 @@ nebula::cpp2::ErrorCode MetaJobExecutor::execute() {
             addressesRet = getListenerHost(space_,  cpp2::ListenerType::ELASTICSEARCH);
             break;
         }
+        case TargetHosts::REPLICA: {
+            addressesRet = getReplicaHost(space_);
+            break;
+        }
         case TargetHosts::DEFAULT: {
             addressesRet = getTargetHost(space_);
             break;
@@ -217,7 +248,7 @@ nebula::cpp2::ErrorCode MetaJobExecutor::execute() {
 
     // write all tasks first.
     for (auto i = 0U; i != addresses.size(); ++i) {
-        TaskDescription task(jobId_, i, addresses[i].first);
+        TaskDescription task(jobId_, taskId_ + i, addresses[i].first);
         std::vector<kvstore::KV> data{{task.taskKey(), task.taskVal()}};
         folly::Baton<true, std::atomic> baton;
         auto rc = nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -12,6 +12,7 @@
 #include "kvstore/KVStore.h"
 #include "meta/processors/admin/AdminClient.h"
 #include "meta/processors/jobMan/JobDescription.h"
+#include "meta/processors/jobMan/TaskDescription.h"
 
 namespace nebula {
 namespace meta {
@@ -24,6 +25,8 @@ public:
     enum class TargetHosts {
         LEADER = 0,
         LISTENER,
+        // all hosts of the replicas, with the parts they hold
+        REPLICA,
         DEFAULT
     };
 
@@ -64,6 +67,14 @@ public:
         return nebula::cpp2::ErrorCode::SUCCEEDED;
     }
 
+    // Some jobs run their tasks in more than one round. It is called when all tasks have
+    // succeeded, return true if the tasks of the next round have been dispatched, then the job
+    // is not finished yet.
+    virtual ErrorOr<nebula::cpp2::ErrorCode, bool>
+    nextRound(std::list<TaskDescription>&) {
+        return false;
+    }
+
 protected:
     ErrorOr<nebula::cpp2::ErrorCode, GraphSpaceID>
     getSpaceIdFromName(const std::string& spaceName);
@@ -72,6 +83,8 @@ protected:
 
     ErrOrHosts getLeaderHost(GraphSpaceID space);
 
+    ErrOrHosts getReplicaHost(GraphSpaceID space);
+
     ErrOrHosts getListenerHost(GraphSpaceID space, cpp2::ListenerType type);
 
     virtual folly::Future<Status>
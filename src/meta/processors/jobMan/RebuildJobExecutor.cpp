@@ -12,17 +12,23 @@
 #include "meta/processors/jobMan/RebuildJobExecutor.h"
 #include "utils/Utils.h"
 
+DEFINE_bool(rebuild_index_by_ingest, false,
+            "Rebuild index by ingesting sorted SST files into each replica instead of writing "
+            "through raft, it applies to the rebuild jobs added afterwards, and the writes are "
+            "expected to be blocked");
+
 DECLARE_int32(heartbeat_interval_secs);
 
 namespace nebula {
 namespace meta {
 
 bool RebuildJobExecutor::check() {
-    return paras_.size() >= 1;
+    return paras_.size() >= (byIngest_ ? 2 : 1);
 }
 
 nebula::cpp2::ErrorCode RebuildJobExecutor::prepare() {
-    // the last value of paras_ is the space name, others are index name
+    // the last value of paras_ is the space name, others are index name, after the mark of
+    // rebuilding by ingest if any
     auto spaceRet = getSpaceIdFromName(paras_.back());
     if (!nebula::ok(spaceRet)) {
         LOG(ERROR) << "Can't find the space: " << paras_.back();
@@ -32,7 +38,13 @@ nebula::cpp2::ErrorCode RebuildJobExecutor::prepare() {
 
     std::string indexValue;
     IndexID indexId = -1;
-    for (auto i = 0u; i < paras_.size() - 1; i++) {
+    auto begin = 0u;
+    if (byIngest_) {
+        // the mark of the round goes first, it is the ingest round unless told otherwise
+        taskParameters_.emplace_back(kRebuildIndexIngest);
+        begin = 1;
+    }
+    for (auto i = begin; i < paras_.size() - 1; i++) {
         auto indexKey = MetaServiceUtils::indexIndexKey(space_, paras_[i]);
         auto retCode = kvstore_->get(kDefaultSpaceId, kDefaultPartId, indexKey, &indexValue);
         if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -48,6 +60,31 @@ nebula::cpp2::ErrorCode RebuildJobExecutor::prepare() {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+ErrorOr<nebula::cpp2::ErrorCode, bool>
+RebuildJobExecutor::nextRound(std::list<TaskDescription>& tasks) {
+    if (!byIngest_) {
+        return false;
+    }
+    auto replayed = std::any_of(tasks.begin(), tasks.end(), [](auto& task) {
+        return task.getTaskId() >= kReplayTaskId;
+    });
+    if (replayed) {
+        return false;
+    }
+
+    // All replicas have ingested the index of their own data, so the leaders could replay the
+    // operation logs now, their writes won't be overwritten by any ingestion any more.
+    LOG(INFO) << "Replay the operation logs of rebuilding index, job " << jobId_;
+    toHost_ = TargetHosts::LEADER;
+    taskId_ = kReplayTaskId;
+    taskParameters_.front() = kRebuildIndexReplay;
+    auto rc = execute();
+    if (rc != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        return rc;
+    }
+    return true;
+}
+
 nebula::cpp2::ErrorCode RebuildJobExecutor::stop() {
     auto errOrTargetHost = getTargetHost(space_);
     if (!nebula::ok(errOrTargetHost)) {
@@ -10,6 +10,9 @@
 #include "common/interface/gen-cpp2/common_types.h"
 #include "meta/processors/admin/AdminClient.h"
 #include "meta/processors/jobMan/MetaJobExecutor.h"
+#include "utils/OperationKeyUtils.h"
+
+DECLARE_bool(rebuild_index_by_ingest);
 
 namespace nebula {
 namespace meta {
@@ -21,7 +24,10 @@ public:
                        AdminClient* adminClient,
                        const std::vector<std::string>& paras)
         : MetaJobExecutor(jobId, kvstore, adminClient, paras) {
-        toHost_ = TargetHosts::LEADER;
+        // the mode is decided when the job is added, so that the rounds of a job agree with each
+        // other even if the flag is changed
+        byIngest_ = !paras_.empty() && paras_.front() == kRebuildIndexIngest;
+        toHost_ = byIngest_ ? TargetHosts::REPLICA : TargetHosts::LEADER;
     }
 
     bool check() override;
@@ -30,7 +36,14 @@ public:
 
     nebula::cpp2::ErrorCode stop() override;
 
+    ErrorOr<nebula::cpp2::ErrorCode, bool>
+    nextRound(std::list<TaskDescription>& tasks) override;
+
 protected:
+    // The tasks of the replay round are numbered from here, after those of the ingest round
+    static constexpr TaskID kReplayTaskId = 1 << 16;
+
+    bool                      byIngest_{false};
     std::vector<std::string>  taskParameters_;
 };
 
@@ -15,6 +15,8 @@
 #include "storage/GraphStorageServiceHandler.h"
 #include "storage/GeneralStorageServiceHandler.h"
 #include "storage/CompactionFilter.h"
+#include "storage/MergeOperator.h"
+#include "storage/StorageFlags.h"
 
 
 DECLARE_int32(heartbeat_interval_secs);
@@ -207,12 +209,19 @@ void MockCluster::initStorageKV(const char* dataPath,
 
     // Prepare KVStore
     options.dataPaths_ = std::move(paths);
+    options.mergeOp_ = std::make_shared<storage::NebulaOperator>();
     if (needCffBuilder) {
         std::unique_ptr<kvstore::CompactionFilterFactoryBuilder> cffBuilder(
                 new storage::StorageCompactionFilterFactoryBuilder(schemaMan_.get(),
                                                                    indexMan_.get()));
         options.cffBuilder_ = std::move(cffBuilder);
     }
+    if (FLAGS_enable_edge_cache) {
+        edgeCache_ = std::make_unique<storage::EdgeCache>(FLAGS_edge_cache_num,
+                                                          FLAGS_edge_cache_bucket_exp,
+                                                          FLAGS_edge_cache_max_entry_bytes);
+        options.commitCb_ = edgeCache_->commitCallback(schemaMan_.get());
+    }
     storageKV_ = initKV(std::move(options), addr);
     waitUntilAllElected(storageKV_.get(), 1, parts);
 
@@ -223,6 +232,7 @@ void MockCluster::initStorageKV(const char* dataPath,
     storageEnv_->rebuildIndexGuard_ = std::make_unique<storage::IndexGuard>();
     storageEnv_->verticesML_ = std::make_unique<storage::VerticesMemLock>();
     storageEnv_->edgesML_ = std::make_unique<storage::EdgesMemLock>();
+    storageEnv_->edgeCache_ = edgeCache_.get();
 }
 
 void MockCluster::startStorage(HostAddr addr,
@@ -18,6 +18,7 @@
 #include "storage/GraphStorageServiceHandler.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/BaseProcessor.h"
+#include "storage/cache/EdgeCache.h"
 #include <thrift/lib/cpp2/server/ThriftServer.h>
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 #include <folly/synchronization/Baton.h>
@@ -128,6 +129,8 @@ public:
     std::unique_ptr<RpcServer>                      storageAdminServer_{nullptr};
     std::unique_ptr<RpcServer>                      graphStorageServer_{nullptr};
     std::unique_ptr<RpcServer>                      generalStorageServer_{nullptr};
+    // edge cache must outlive storageKV_, which holds its commit callback
+    std::unique_ptr<storage::EdgeCache>             edgeCache_{nullptr};
     std::unique_ptr<kvstore::NebulaStore>           storageKV_{nullptr};
     std::unique_ptr<storage::StorageEnv>            storageEnv_{nullptr};
 
@@ -15,6 +15,7 @@
 #include <folly/futures/Future.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include "storage/CommonUtils.h"
+#include "storage/context/RequestTrace.h"
 #include "codec/RowReaderWrapper.h"
 #include "codec/RowWriterV2.h"
 #include "utils/IndexKeyUtils.h"
@@ -53,6 +54,7 @@ protected:
         if (counters_) {
             stats::StatsManager::addValue(counters_->latency_, this->duration_.elapsedInUSec());
         }
+        RequestTrace::finish(std::move(trace_), this->duration_.elapsedInUSec(), codes_.size());
 
         delete this;
     }
@@ -127,6 +129,8 @@ protected:
     int32_t                                         callingNum_{0};
     int32_t                                         spaceVidLen_;
     bool                                            isIntId_;
+    // Sampled trace of the request, nullptr if not traced
+    std::unique_ptr<RequestTrace>                   trace_;
 };
 
 }  // namespace storage
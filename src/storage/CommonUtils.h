@@ -66,6 +66,7 @@ using VerticesMemLock = MemoryLockCore<VMLI>;
 using EdgesMemLock = MemoryLockCore<EMLI>;
 
 class TransactionManager;
+class EdgeCache;
 
 // unify TagID, EdgeType
 using SchemaID = TagID;
@@ -80,6 +81,7 @@ public:
     std::unique_ptr<IndexGuard>                     rebuildIndexGuard_{nullptr};
     meta::MetaClient*                               metaClient_{nullptr};
     TransactionManager*                             txnMan_{nullptr};
+    EdgeCache*                                      edgeCache_{nullptr};
     std::unique_ptr<VerticesMemLock>                verticesML_{nullptr};
     std::unique_ptr<EdgesMemLock>                   edgesML_{nullptr};
 
@@ -9,26 +9,132 @@
 
 #include "common/base/Base.h"
 #include "common/meta/NebulaSchemaProvider.h"
+#include "common/time/WallClock.h"
 #include "codec/RowReaderWrapper.h"
 #include "kvstore/CompactionFilter.h"
 #include "storage/CommonUtils.h"
+#include "storage/StorageFlags.h"
 #include "utils/NebulaKeyUtils.h"
 #include "utils/IndexKeyUtils.h"
 #include "utils/OperationKeyUtils.h"
 
-DEFINE_bool(storage_kv_mode, false, "True for kv mode");
-
 namespace nebula {
 namespace storage {
 
+/**
+ * CompactionSnapshot is the schemas, ttl and indexes of a space taken when a compaction starts,
+ * so that the filter does not look up the schema manager and parse the ttl props for each key.
+ * The ttl column of each schema version is resolved to its field index, only that column is
+ * decoded from the rows. The tags, edges, indexes and schema versions created after the snapshot
+ * are not in it, the filter falls back to the schema manager for them.
+ * */
+class CompactionSnapshot final {
+public:
+    struct SchemaEntry {
+        // all versions of the schema, from oldest to newest
+        std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>  schemas;
+        bool                                                            hasTtl{false};
+        int64_t                                                         ttlDuration{0};
+        // field index of the ttl column in each version, -1 if not exists
+        std::vector<int64_t>                                            ttlIndex;
+    };
+
+    struct IndexEntry {
+        // nullptr if the schema of the index not exists
+        const SchemaEntry*                                              schema{nullptr};
+    };
+
+    static std::unique_ptr<CompactionSnapshot> build(meta::SchemaManager* schemaMan,
+                                                     meta::IndexManager* indexMan,
+                                                     GraphSpaceID spaceId) {
+        auto tags = schemaMan->getAllVerTagSchema(spaceId);
+        auto edges = schemaMan->getAllVerEdgeSchema(spaceId);
+        if (!tags.ok() || !edges.ok()) {
+            LOG(WARNING) << "Space " << spaceId << " build compaction snapshot failed";
+            return nullptr;
+        }
+        auto snapshot = std::make_unique<CompactionSnapshot>();
+        for (auto& tag : tags.value()) {
+            snapshot->tags_.emplace(tag.first, buildEntry(std::move(tag.second)));
+        }
+        for (auto& edge : edges.value()) {
+            snapshot->edges_.emplace(edge.first, buildEntry(std::move(edge.second)));
+        }
+        if (indexMan != nullptr) {
+            auto tagIndexes = indexMan->getTagIndexes(spaceId);
+            if (tagIndexes.ok()) {
+                for (const auto& index : tagIndexes.value()) {
+                    auto tagId = index->get_schema_id().get_tag_id();
+                    snapshot->indexes_[index->get_index_id()].schema = snapshot->tag(tagId);
+                }
+            }
+            auto edgeIndexes = indexMan->getEdgeIndexes(spaceId);
+            if (edgeIndexes.ok()) {
+                for (const auto& index : edgeIndexes.value()) {
+                    auto edgeType = index->get_schema_id().get_edge_type();
+                    snapshot->indexes_[index->get_index_id()].schema = snapshot->edge(edgeType);
+                }
+            }
+        }
+        return snapshot;
+    }
+
+    const SchemaEntry* tag(TagID tagId) const {
+        auto it = tags_.find(tagId);
+        return it == tags_.end() ? nullptr : &it->second;
+    }
+
+    const SchemaEntry* edge(EdgeType edgeType) const {
+        auto it = edges_.find(std::abs(edgeType));
+        return it == edges_.end() ? nullptr : &it->second;
+    }
+
+    const IndexEntry* index(IndexID indexId) const {
+        auto it = indexes_.find(indexId);
+        return it == indexes_.end() ? nullptr : &it->second;
+    }
+
+private:
+    static SchemaEntry buildEntry(
+            std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>> schemas) {
+        SchemaEntry entry;
+        entry.schemas = std::move(schemas);
+        if (entry.schemas.empty() || entry.schemas.back() == nullptr) {
+            return entry;
+        }
+        const auto* latest = entry.schemas.back().get();
+        auto ttl = CommonUtils::ttlProps(latest);
+        if (ttl.first) {
+            // Same as CommonUtils::checkDataExpiredForTTL, only these types could expire
+            auto ftype = latest->getFieldType(ttl.second.second);
+            entry.hasTtl = ftype == meta::cpp2::PropertyType::TIMESTAMP ||
+                           ftype == meta::cpp2::PropertyType::INT64;
+        }
+        if (entry.hasTtl) {
+            entry.ttlDuration = ttl.second.first;
+            for (const auto& schema : entry.schemas) {
+                entry.ttlIndex.emplace_back(
+                    schema == nullptr ? -1 : schema->getFieldIndex(ttl.second.second));
+            }
+        }
+        return entry;
+    }
+
+    std::unordered_map<TagID, SchemaEntry>      tags_;
+    std::unordered_map<EdgeType, SchemaEntry>   edges_;
+    std::unordered_map<IndexID, IndexEntry>     indexes_;
+};
+
 class StorageCompactionFilter final : public kvstore::KVFilter {
 public:
     StorageCompactionFilter(meta::SchemaManager* schemaMan,
                             meta::IndexManager* indexMan,
-                            size_t vIdLen)
+                            size_t vIdLen,
+                            std::unique_ptr<CompactionSnapshot> snapshot = nullptr)
         : schemaMan_(schemaMan)
         , indexMan_(indexMan)
-        , vIdLen_(vIdLen) {
+        , vIdLen_(vIdLen)
+        , snapshot_(std::move(snapshot)) {
         CHECK_NOTNULL(schemaMan_);
     }
 
@@ -56,10 +162,61 @@ public:
     }
 
 private:
+    enum class Validity {
+        kValid,
+        kInvalid,
+        // not decided by the snapshot
+        kUnknown,
+    };
+
+    static bool expired(const Value& v, int64_t ttlDuration) {
+        // if the value is not INT type (sush as NULL), it will never expire.
+        return v.isInt() && time::WallClock::fastNowInSec() > v.getInt() + ttlDuration;
+    }
+
+    // Check the row by the snapshot, only the ttl column of the row is decoded
+    Validity rowValid(const CompactionSnapshot::SchemaEntry* entry,
+                      const folly::StringPiece& val) const {
+        if (entry == nullptr) {
+            return Validity::kUnknown;
+        }
+        SchemaVer schemaVer;
+        int32_t readerVer;
+        RowReaderWrapper::getVersions(val, schemaVer, readerVer);
+        if (schemaVer < 0) {
+            VLOG(3) << "Remove the bad format row";
+            return Validity::kInvalid;
+        }
+        if (static_cast<size_t>(schemaVer) >= entry->schemas.size() ||
+            entry->schemas[schemaVer] == nullptr ||
+            entry->schemas[schemaVer]->getVersion() != schemaVer) {
+            // the schema version is newer than the snapshot
+            return Validity::kUnknown;
+        }
+        if (!entry->hasTtl) {
+            return Validity::kValid;
+        }
+        RowReaderWrapper reader;
+        if (!reader.reset(entry->schemas[schemaVer].get(), val, readerVer)) {
+            return Validity::kUnknown;
+        }
+        if (expired(reader.getValueByIndex(entry->ttlIndex[schemaVer]), entry->ttlDuration)) {
+            VLOG(3) << "Ttl expired";
+            return Validity::kInvalid;
+        }
+        return Validity::kValid;
+    }
+
     bool vertexValid(GraphSpaceID spaceId,
                      const folly::StringPiece& key,
                      const folly::StringPiece& val) const {
         auto tagId = NebulaKeyUtils::getTagId(vIdLen_, key);
+        if (snapshot_ != nullptr) {
+            auto ret = rowValid(snapshot_->tag(tagId), val);
+            if (ret != Validity::kUnknown) {
+                return ret == Validity::kValid;
+            }
+        }
         auto schema = schemaMan_->getTagSchema(spaceId, tagId);
         if (!schema) {
             VLOG(3) << "Space " << spaceId << ", Tag " << tagId << " invalid";
@@ -85,6 +242,12 @@ private:
             VLOG(3) << "Invalid reverse edge key";
             return false;
         }
+        if (snapshot_ != nullptr) {
+            auto ret = rowValid(snapshot_->edge(edgeType), val);
+            if (ret != Validity::kUnknown) {
+                return ret == Validity::kValid;
+            }
+        }
         auto schema = schemaMan_->getEdgeSchema(spaceId, std::abs(edgeType));
         if (!schema) {
             VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
@@ -105,6 +268,9 @@ private:
 
     bool lockValid(GraphSpaceID spaceId, const folly::StringPiece& key) const {
         auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen_, key);
+        if (snapshot_ != nullptr && snapshot_->edge(edgeType) != nullptr) {
+            return true;
+        }
         auto schema = schemaMan_->getEdgeSchema(spaceId, std::abs(edgeType));
         if (!schema) {
             VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
@@ -148,6 +314,18 @@ private:
                     const folly::StringPiece& key,
                     const folly::StringPiece& val) const {
         auto indexId = IndexKeyUtils::getIndexId(key);
+        const auto* index = snapshot_ == nullptr ? nullptr : snapshot_->index(indexId);
+        if (index != nullptr) {
+            if (val.empty()) {
+                return true;
+            }
+            if (index->schema == nullptr) {
+                VLOG(3) << "Space " << spaceId << ", schema of index " << indexId << " invalid";
+                return false;
+            }
+            return !index->schema->hasTtl ||
+                   !expired(IndexKeyUtils::parseIndexTTL(val), index->schema->ttlDuration);
+        }
         auto eRet = indexMan_->getEdgeIndex(spaceId, indexId);
         if (eRet.ok()) {
             if (!val.empty()) {
@@ -186,6 +364,7 @@ private:
     meta::SchemaManager* schemaMan_ = nullptr;
     meta::IndexManager* indexMan_ = nullptr;
     size_t vIdLen_;
+    std::unique_ptr<CompactionSnapshot> snapshot_;
 };
 
 class StorageCompactionFilterFactory final : public kvstore::KVCompactionFilterFactory {
@@ -197,10 +376,16 @@ public:
         KVCompactionFilterFactory(spaceId),
         schemaMan_(schemaMan),
         indexMan_(indexMan),
+        spaceId_(spaceId),
         vIdLen_(vIdLen) {}
 
+    // A filter is created for each compaction, along with the snapshot of the schemas
     std::unique_ptr<kvstore::KVFilter> createKVFilter() override {
-        return std::make_unique<StorageCompactionFilter>(schemaMan_, indexMan_, vIdLen_);
+        return std::make_unique<StorageCompactionFilter>(
+            schemaMan_,
+            indexMan_,
+            vIdLen_,
+            CompactionSnapshot::build(schemaMan_, indexMan_, spaceId_));
     }
 
     const char* Name() const override {
@@ -210,6 +395,7 @@ public:
 private:
     meta::SchemaManager* schemaMan_ = nullptr;
     meta::IndexManager* indexMan_ = nullptr;
+    GraphSpaceID spaceId_;
     size_t vIdLen_;
 };
 
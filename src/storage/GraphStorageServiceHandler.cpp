@@ -18,15 +18,55 @@
 #include "storage/query/ScanEdgeProcessor.h"
 #include "storage/index/LookupProcessor.h"
 #include "storage/transaction/TransactionProcessor.h"
+#include "storage/WorkloadPools.h"
 
 #define RETURN_FUTURE(processor) \
     auto f = processor->getFuture(); \
     processor->process(req); \
     return f;
 
+// Reject the request when the pool of its workload has too many pending tasks, all its parts
+// fail with E_WRITE_STALLED, so that the client could back off and retry
+#define RETURN_IF_OVERLOADED(RESP, workload, parts) \
+    if (!WorkloadPools::instance().admit(workload)) { \
+        VLOG(1) << "Too many pending " << WorkloadPools::name(workload) << " requests"; \
+        return folly::makeFuture<RESP>(overloadedResp<RESP>(parts)); \
+    }
+
 namespace nebula {
 namespace storage {
 
+namespace {
+
+template <typename RESP>
+RESP overloadedResp(const std::vector<PartitionID>& parts) {
+    std::vector<cpp2::PartitionResult> failedParts;
+    failedParts.reserve(parts.size());
+    for (auto partId : parts) {
+        cpp2::PartitionResult thriftRet;
+        thriftRet.set_code(nebula::cpp2::ErrorCode::E_WRITE_STALLED);
+        thriftRet.set_part_id(partId);
+        failedParts.emplace_back(std::move(thriftRet));
+    }
+    cpp2::ResponseCommon result;
+    result.set_failed_parts(std::move(failedParts));
+    RESP resp;
+    resp.set_result(std::move(result));
+    return resp;
+}
+
+template <typename PARTS>
+std::vector<PartitionID> partIds(const PARTS& parts) {
+    std::vector<PartitionID> ids;
+    ids.reserve(parts.size());
+    for (const auto& part : parts) {
+        ids.emplace_back(part.first);
+    }
+    return ids;
+}
+
+}  // namespace
+
 GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env)
         : env_(env)
         , vertexCache_(FLAGS_vertex_cache_num, FLAGS_vertex_cache_bucket_exp) {
@@ -61,6 +101,15 @@ GraphStorageServiceHandler::GraphStorageServiceHandler(StorageEnv* env)
 }
 
 
+folly::Executor* GraphStorageServiceHandler::executor(Workload workload) {
+    auto* pool = WorkloadPools::instance().get(workload);
+    if (pool != nullptr) {
+        return pool;
+    }
+    return readerPool_.get();
+}
+
+
 // Vertice section
 folly::Future<cpp2::ExecResponse>
 GraphStorageServiceHandler::future_addVertices(const cpp2::AddVerticesRequest& req) {
@@ -78,9 +127,10 @@ GraphStorageServiceHandler::future_deleteVertices(const cpp2::DeleteVerticesRequ
 
 folly::Future<cpp2::UpdateResponse>
 GraphStorageServiceHandler::future_updateVertex(const cpp2::UpdateVertexRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::UpdateResponse, Workload::kMutation, {req.get_part_id()});
     auto* processor = UpdateVertexProcessor::instance(env_,
                                                       &kUpdateVertexCounters,
-                                                      readerPool_.get(),
+                                                      executor(Workload::kMutation),
                                                       &vertexCache_);
     RETURN_FUTURE(processor);
 }
@@ -103,16 +153,22 @@ GraphStorageServiceHandler::future_deleteEdges(const cpp2::DeleteEdgesRequest& r
 
 folly::Future<cpp2::UpdateResponse>
 GraphStorageServiceHandler::future_updateEdge(const cpp2::UpdateEdgeRequest& req) {
-    auto* processor = UpdateEdgeProcessor::instance(env_, &kUpdateEdgeCounters, readerPool_.get());
+    RETURN_IF_OVERLOADED(cpp2::UpdateResponse, Workload::kMutation, {req.get_part_id()});
+    auto* processor = UpdateEdgeProcessor::instance(env_,
+                                                    &kUpdateEdgeCounters,
+                                                    executor(Workload::kMutation));
     RETURN_FUTURE(processor);
 }
 
 
 folly::Future<cpp2::GetNeighborsResponse>
 GraphStorageServiceHandler::future_getNeighbors(const cpp2::GetNeighborsRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::GetNeighborsResponse,
+                         Workload::kTraversal,
+                         partIds(req.get_parts()));
     auto* processor = GetNeighborsProcessor::instance(env_,
                                                       &kGetNeighborsCounters,
-                                                      readerPool_.get(),
+                                                      executor(Workload::kTraversal),
                                                       &vertexCache_);
     RETURN_FUTURE(processor);
 }
@@ -120,9 +176,10 @@ GraphStorageServiceHandler::future_getNeighbors(const cpp2::GetNeighborsRequest&
 
 folly::Future<cpp2::GetPropResponse>
 GraphStorageServiceHandler::future_getProps(const cpp2::GetPropRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::GetPropResponse, Workload::kPointRead, partIds(req.get_parts()));
     auto* processor = GetPropProcessor::instance(env_,
                                                  &kGetPropCounters,
-                                                 readerPool_.get(),
+                                                 executor(Workload::kPointRead),
                                                  &vertexCache_);
     RETURN_FUTURE(processor);
 }
@@ -130,9 +187,10 @@ GraphStorageServiceHandler::future_getProps(const cpp2::GetPropRequest& req) {
 
 folly::Future<cpp2::LookupIndexResp>
 GraphStorageServiceHandler::future_lookupIndex(const cpp2::LookupIndexRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::LookupIndexResp, Workload::kScan, req.get_parts());
     auto* processor = LookupProcessor::instance(env_,
                                                 &kLookupCounters,
-                                                readerPool_.get(),
+                                                executor(Workload::kScan),
                                                 &vertexCache_);
     RETURN_FUTURE(processor);
 }
@@ -140,18 +198,20 @@ GraphStorageServiceHandler::future_lookupIndex(const cpp2::LookupIndexRequest& r
 
 folly::Future<cpp2::ScanVertexResponse>
 GraphStorageServiceHandler::future_scanVertex(const cpp2::ScanVertexRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::ScanVertexResponse, Workload::kScan, {req.get_part_id()});
     auto* processor = ScanVertexProcessor::instance(env_,
                                                     &kScanVertexCounters,
-                                                    readerPool_.get());
+                                                    executor(Workload::kScan));
     RETURN_FUTURE(processor);
 }
 
 
 folly::Future<cpp2::ScanEdgeResponse>
 GraphStorageServiceHandler::future_scanEdge(const cpp2::ScanEdgeRequest& req) {
+    RETURN_IF_OVERLOADED(cpp2::ScanEdgeResponse, Workload::kScan, {req.get_part_id()});
     auto* processor = ScanEdgeProcessor::instance(env_,
                                                   &kScanEdgeCounters,
-                                                  readerPool_.get());
+                                                  executor(Workload::kScan));
     RETURN_FUTURE(processor);
 }
 
@@ -12,6 +12,7 @@
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
+#include "storage/WorkloadPools.h"
 
 namespace nebula {
 namespace storage {
@@ -64,6 +65,9 @@ public:
     future_getUUID(const cpp2::GetUUIDReq& req) override;
 
 private:
+    // The pool of the workload if the workload pools are enabled, otherwise the reader pool
+    folly::Executor* executor(Workload workload);
+
     StorageEnv*                                     env_{nullptr};
     VertexCache                                     vertexCache_;
     std::shared_ptr<folly::Executor>                readerPool_;
@@ -0,0 +1,259 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/MergeOperator.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+constexpr size_t kAddLen = 1 + sizeof(int64_t);
+// type + ver + nullOffset + nullMask + offset + width + delta
+constexpr size_t kAddFieldHeadLen = 1 + sizeof(int64_t) + sizeof(uint32_t) + 1 +
+                                    sizeof(uint32_t) + 1;
+constexpr size_t kAddFieldLen = kAddFieldHeadLen + sizeof(int64_t);
+
+template <typename T>
+void addTo(char* pos, int64_t delta) {
+    T v;
+    memcpy(reinterpret_cast<void*>(&v), pos, sizeof(T));
+    // Wrap around on overflow like the unsigned arithmetic does, instead of UB
+    using U = typename std::make_unsigned<T>::type;
+    v = static_cast<T>(static_cast<U>(v) + static_cast<U>(delta));
+    memcpy(pos, reinterpret_cast<void*>(&v), sizeof(T));
+}
+
+int64_t readDelta(const char* pos) {
+    int64_t delta;
+    memcpy(reinterpret_cast<void*>(&delta), pos, sizeof(int64_t));
+    return delta;
+}
+
+}  // namespace
+
+std::string NebulaOperator::addOperand(int64_t delta) {
+    std::string operand;
+    operand.reserve(kAddLen);
+    operand.push_back(MergeType::kAdd);
+    operand.append(reinterpret_cast<const char*>(&delta), sizeof(int64_t));
+    return operand;
+}
+
+std::string NebulaOperator::appendOperand(folly::StringPiece bytes) {
+    std::string operand;
+    operand.reserve(1 + bytes.size());
+    operand.push_back(MergeType::kAppend);
+    operand.append(bytes.data(), bytes.size());
+    return operand;
+}
+
+StatusOr<std::string> NebulaOperator::addFieldOperand(const meta::SchemaProviderIf* schema,
+                                                      const std::string& prop,
+                                                      int64_t delta) {
+    auto index = schema->getFieldIndex(prop);
+    if (index < 0) {
+        return Status::Error("Prop not found: %s", prop.c_str());
+    }
+    auto field = schema->field(index);
+    uint8_t width = 0;
+    switch (field->type()) {
+        case meta::cpp2::PropertyType::INT8:
+            width = sizeof(int8_t);
+            break;
+        case meta::cpp2::PropertyType::INT16:
+            width = sizeof(int16_t);
+            break;
+        case meta::cpp2::PropertyType::INT32:
+            width = sizeof(int32_t);
+            break;
+        case meta::cpp2::PropertyType::INT64:
+            width = sizeof(int64_t);
+            break;
+        default:
+            return Status::Error("Prop %s is not an integer", prop.c_str());
+    }
+
+    // Same layout as RowWriterV2: header and schema version, null flags, then the fields
+    int64_t ver = schema->getVersion();
+    size_t headerLen = 1;
+    for (auto v = ver; v > 0; v >>= 8) {
+        ++headerLen;
+    }
+    size_t numNullables = schema->getNumNullableFields();
+    size_t numNullBytes = numNullables > 0 ? ((numNullables - 1) >> 3) + 1 : 0;
+    uint32_t nullOffset = 0;
+    uint8_t nullMask = 0;
+    if (field->nullable()) {
+        auto pos = field->nullFlagPos();
+        nullOffset = headerLen + (pos >> 3);
+        nullMask = 0x80 >> (pos & 0x07);
+    }
+    uint32_t offset = headerLen + numNullBytes + field->offset();
+
+    std::string operand;
+    operand.reserve(kAddFieldLen);
+    operand.push_back(MergeType::kAddField);
+    operand.append(reinterpret_cast<const char*>(&ver), sizeof(int64_t))
+           .append(reinterpret_cast<const char*>(&nullOffset), sizeof(uint32_t))
+           .append(reinterpret_cast<const char*>(&nullMask), 1)
+           .append(reinterpret_cast<const char*>(&offset), sizeof(uint32_t))
+           .append(reinterpret_cast<const char*>(&width), 1)
+           .append(reinterpret_cast<const char*>(&delta), sizeof(int64_t));
+    return operand;
+}
+
+bool NebulaOperator::apply(const rocksdb::Slice& operand,
+                           bool& exists,
+                           std::string& value) const {
+    if (operand.empty()) {
+        return false;
+    }
+    switch (operand[0]) {
+        case MergeType::kAdd: {
+            if (operand.size() != kAddLen || (exists && value.size() != sizeof(int64_t))) {
+                return false;
+            }
+            if (!exists) {
+                value.assign(sizeof(int64_t), '\0');
+                exists = true;
+            }
+            addTo<int64_t>(&value[0], readDelta(operand.data() + 1));
+            return true;
+        }
+        case MergeType::kAppend: {
+            if (!exists) {
+                value.clear();
+                exists = true;
+            }
+            value.append(operand.data() + 1, operand.size() - 1);
+            return true;
+        }
+        case MergeType::kAddField: {
+            if (operand.size() != kAddFieldLen || !exists || value.empty()) {
+                return false;
+            }
+            const char* p = operand.data() + 1;
+            int64_t ver;
+            memcpy(reinterpret_cast<void*>(&ver), p, sizeof(int64_t));
+            p += sizeof(int64_t);
+            uint32_t nullOffset;
+            memcpy(reinterpret_cast<void*>(&nullOffset), p, sizeof(uint32_t));
+            p += sizeof(uint32_t);
+            uint8_t nullMask = *p;
+            p += 1;
+            uint32_t offset;
+            memcpy(reinterpret_cast<void*>(&offset), p, sizeof(uint32_t));
+            p += sizeof(uint32_t);
+            uint8_t width = *p;
+            p += 1;
+            int64_t delta = readDelta(p);
+
+            // Only rows encoded by RowWriterV2 with the same schema version could be merged
+            if ((value[0] & 0x18) != 0x08) {
+                return false;
+            }
+            size_t verBytes = value[0] & 0x07;
+            int64_t rowVer = 0;
+            if (verBytes > 0) {
+                if (value.size() <= verBytes) {
+                    return false;
+                }
+                memcpy(reinterpret_cast<void*>(&rowVer), &value[1], verBytes);
+            }
+            if (rowVer != ver || offset + width > value.size() || nullOffset >= value.size()) {
+                return false;
+            }
+            if (nullMask != 0 && (value[nullOffset] & nullMask) != 0) {
+                // null + delta is still null
+                return true;
+            }
+            switch (width) {
+                case sizeof(int8_t):
+                    addTo<int8_t>(&value[offset], delta);
+                    return true;
+                case sizeof(int16_t):
+                    addTo<int16_t>(&value[offset], delta);
+                    return true;
+                case sizeof(int32_t):
+                    addTo<int32_t>(&value[offset], delta);
+                    return true;
+                case sizeof(int64_t):
+                    addTo<int64_t>(&value[offset], delta);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
+bool NebulaOperator::FullMergeV2(const MergeOperationInput& merge_in,
+                                 MergeOperationOutput* merge_out) const {
+    bool exists = merge_in.existing_value != nullptr;
+    std::string& value = merge_out->new_value;
+    if (exists) {
+        value.assign(merge_in.existing_value->data(), merge_in.existing_value->size());
+    } else {
+        value.clear();
+    }
+    for (const auto& operand : merge_in.operand_list) {
+        if (!apply(operand, exists, value)) {
+            LOG(ERROR) << "Drop the merge operand which doesn't match the value, key "
+                       << folly::hexlify(merge_in.key.ToString());
+        }
+    }
+    return true;
+}
+
+bool NebulaOperator::PartialMerge(const rocksdb::Slice& key,
+                                  const rocksdb::Slice& left_operand,
+                                  const rocksdb::Slice& right_operand,
+                                  std::string* new_value,
+                                  rocksdb::Logger* logger) const {
+    UNUSED(key);
+    UNUSED(logger);
+    if (left_operand.empty() || right_operand.empty() || left_operand[0] != right_operand[0]) {
+        return false;
+    }
+    switch (left_operand[0]) {
+        case MergeType::kAdd: {
+            if (left_operand.size() != kAddLen || right_operand.size() != kAddLen) {
+                return false;
+            }
+            auto sum = static_cast<uint64_t>(readDelta(left_operand.data() + 1)) +
+                       static_cast<uint64_t>(readDelta(right_operand.data() + 1));
+            *new_value = addOperand(static_cast<int64_t>(sum));
+            return true;
+        }
+        case MergeType::kAppend: {
+            new_value->reserve(left_operand.size() + right_operand.size() - 1);
+            new_value->assign(left_operand.data(), left_operand.size());
+            new_value->append(right_operand.data() + 1, right_operand.size() - 1);
+            return true;
+        }
+        case MergeType::kAddField: {
+            // Only operands on the same field of the same schema version could be combined
+            if (left_operand.size() != kAddFieldLen || right_operand.size() != kAddFieldLen ||
+                memcmp(left_operand.data(), right_operand.data(), kAddFieldHeadLen) != 0) {
+                return false;
+            }
+            auto sum = static_cast<uint64_t>(readDelta(left_operand.data() + kAddFieldHeadLen)) +
+                       static_cast<uint64_t>(readDelta(right_operand.data() + kAddFieldHeadLen));
+            auto delta = static_cast<int64_t>(sum);
+            new_value->assign(left_operand.data(), kAddFieldHeadLen);
+            new_value->append(reinterpret_cast<const char*>(&delta), sizeof(int64_t));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
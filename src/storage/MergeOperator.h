@@ -8,41 +8,64 @@
 #define KVSTORE_MERGEOPERATOR_H_
 
 #include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+#include "common/meta/SchemaProviderIf.h"
 #include <rocksdb/merge_operator.h>
 
 namespace nebula {
 namespace storage {
 
+/**
+ * NebulaOperator folds blind updates into the value lazily, so hot counters could be updated
+ * without decoding, evaluating and re-encoding the row. UpdateVertexProcessor uses kAddField
+ * for `prop = prop +/- constant' when enable_update_by_merge is on. Each operand starts with one
+ * byte of MergeType:
+ *
+ * kAdd:      delta(8). The value is a raw int64, a missing value is regarded as 0.
+ * kAppend:   bytes to be appended to the raw value.
+ * kAddField: ver(8) + nullOffset(4) + nullMask(1) + offset(4) + width(1) + delta(8).
+ *            The value is a row encoded by RowWriterV2 with schema version `ver', and the
+ *            integer field of `width' bytes at `offset' is added by delta. If the field is null,
+ *            it keeps null, the same as `prop = prop + delta' in an update.
+ *
+ * An operand which doesn't match the existing value (wrong type, schema changed, value missing
+ * for kAddField) is dropped with an error log, the merge never fails, otherwise rocksdb would
+ * regard the key as corrupted.
+ * */
 class NebulaOperator : public rocksdb::MergeOperator {
 public:
+    enum MergeType : char {
+        kAdd       = 0x01,
+        kAppend    = 0x02,
+        kAddField  = 0x03,
+    };
+
     const char* Name() const override {
         return "NebulaMergeOperator";
     }
 
+    static std::string addOperand(int64_t delta);
+
+    static std::string appendOperand(folly::StringPiece bytes);
+
+    // Build the operand to add delta to the integer field `prop' of rows encoded by `schema'
+    static StatusOr<std::string> addFieldOperand(const meta::SchemaProviderIf* schema,
+                                                 const std::string& prop,
+                                                 int64_t delta);
+
 private:
     bool FullMergeV2(const MergeOperationInput& merge_in,
-                     MergeOperationOutput* merge_out) const override {
-        UNUSED(merge_in);
-        UNUSED(merge_out);
-        LOG(ERROR) << "NebulaMergeOperator not supported yet";
-        return false;
-    }
+                     MergeOperationOutput* merge_out) const override;
 
     bool PartialMerge(const rocksdb::Slice& key, const rocksdb::Slice& left_operand,
                       const rocksdb::Slice& right_operand, std::string* new_value,
-                      rocksdb::Logger* logger) const override {
-        UNUSED(key);
-        UNUSED(left_operand);
-        UNUSED(right_operand);
-        UNUSED(new_value);
-        UNUSED(logger);
-        LOG(ERROR) << "NebulaMergeOperator not supported yet";
-        return false;
-    }
+                      rocksdb::Logger* logger) const override;
+
+    // Apply one operand on the value in place, return false if it doesn't match the value
+    bool apply(const rocksdb::Slice& operand, bool& exists, std::string& value) const;
 };
 
 
 }  // namespace storage
 }  // namespace nebula
 #endif  // KVSTORE_MERGEOPERATOR_H_
-
@@ -26,12 +26,25 @@ DEFINE_int32(rebuild_index_batch_num, 1024,
 DEFINE_int32(rebuild_index_locked_threshold, 1024,
              "The locked threshold will refuse writing.");
 
+DEFINE_int32(rebuild_index_sst_buffer_mb, 64,
+             "Max size of the index entries sorted in memory before written to a SST file");
+
 DEFINE_int32(vertex_cache_num, 16 * 1000 * 1000, "Total keys inside the cache");
 
 DEFINE_int32(vertex_cache_bucket_exp, 4, "Total buckets number is 1 << cache_bucket_exp");
 
 DEFINE_bool(enable_vertex_cache, true, "Enable vertex cache");
 
+DEFINE_bool(enable_edge_cache, false, "Enable the out-edge list cache used by GetNeighbors");
+
+DEFINE_int32(edge_cache_num, 100 * 1000, "Total edge lists inside the edge cache");
+
+DEFINE_int32(edge_cache_bucket_exp, 4, "Total buckets number is 1 << edge_cache_bucket_exp");
+
+DEFINE_int32(edge_cache_max_entry_bytes, 16 * 1024,
+             "Edge list larger than this will not be cached, so the memory used by edge cache "
+             "is at most edge_cache_num * edge_cache_max_entry_bytes");
+
 DEFINE_int32(reader_handlers, 32, "Total reader handlers");
 
 DEFINE_uint64(default_mvcc_ver, 0L, "vertex/edge version if enable_multi_versions set to false."
@@ -43,8 +56,66 @@ DEFINE_string(reader_handlers_type, "cpu", "Type of reader handlers, options: cp
 
 DEFINE_bool(trace_toss, false, "output verbose log of toss");
 
+DEFINE_int32(toss_resume_concurrency, 16,
+             "Max number of the dangling toss locks met by readers resumed at the same time");
+
+DEFINE_int32(toss_resume_wait_ms, 100,
+             "Max time a reader waits for the toss locks it meets to be resumed, after that the "
+             "last committed edges are returned and the locks keep being resumed in background");
+
 DEFINE_int32(max_edge_returned_per_vertex, INT_MAX,
              "Max edge number returnred searching vertex");
 
+DEFINE_int64(max_edges_returned_per_response, 10000000,
+             "Max number of edges materialized in a GetNeighbors response, the parts not "
+             "finished within it are returned as they are with E_PARTIAL_RESULT, "
+             "0 means unlimited");
+
 DEFINE_bool(query_concurrently, false,
             "whether to run query of each part concurrently, only lookup and go are supported");
+
+DEFINE_int32(query_batch_size, 256,
+             "Max number of vertices of the same part executed as a batch by the storage plan, "
+             "the nodes could read the data of the whole batch at once. 0 means executing the "
+             "vertices one by one");
+
+DEFINE_int32(super_vertex_threshold, 0,
+             "When query_concurrently is on, the edges of a vertex with at least this many edges "
+             "are split into sub-ranges and scanned in parallel in GetNeighbors, 0 means disabled");
+
+DEFINE_int32(super_vertex_split_num, 8,
+             "Number of sub-ranges the edges of one edge type of a super vertex are split into");
+
+DEFINE_bool(enable_filter_program, true,
+            "Whether to compile the common shapes of filters into a FilterProgram, which checks "
+            "the rows without evaluating the expression");
+
+DEFINE_bool(enable_update_by_merge, false,
+            "Whether to update the non-indexed int64 props of a vertex without ttl by merging "
+            "the delta, when each of them is updated as `prop = prop +/- constant' and nothing "
+            "is returned or filtered. It still locks and reads the vertex, only the decoding, "
+            "evaluating and encoding of the row are saved, so it is off by default");
+
+DEFINE_int32(index_fetch_batch_size, 256,
+             "The number of rows fetched by each multiGet, when a lookup reads the props which are "
+             "not in the index");
+
+DEFINE_double(request_trace_sample_rate, 0,
+              "Ratio of the read requests whose time of each stage is traced, the slowest ones are "
+              "kept for /slow_requests. 0 means disabled");
+
+DEFINE_int32(slow_request_log_size, 100, "Number of the slowest traced requests kept");
+
+DEFINE_bool(enable_workload_pools, false,
+            "Whether to run the point reads, traversals, scans, mutations and admin tasks in "
+            "separate thread pools, instead of sharing the reader handlers");
+DEFINE_int32(point_read_threads, 16, "Number of threads serving getProps");
+DEFINE_int32(traversal_threads, 16, "Number of threads serving getNeighbors");
+DEFINE_int32(scan_threads, 4, "Number of threads serving scanVertex, scanEdge and lookupIndex");
+DEFINE_int32(mutation_threads, 8, "Number of threads serving updateVertex and updateEdge");
+DEFINE_int32(admin_threads, 4, "Number of threads running the sub tasks of admin tasks");
+DEFINE_int64(workload_max_queue_size, 0,
+             "Requests are rejected when a workload pool has this many pending tasks, "
+             "0 means unlimited");
+
+DEFINE_bool(storage_kv_mode, false, "True for kv mode");
@@ -23,12 +23,22 @@ DECLARE_int32(rebuild_index_batch_num);
 
 DECLARE_int32(rebuild_index_locked_threshold);
 
+DECLARE_int32(rebuild_index_sst_buffer_mb);
+
 DECLARE_int32(vertex_cache_num);
 
 DECLARE_int32(vertex_cache_bucket_exp);
 
 DECLARE_bool(enable_vertex_cache);
 
+DECLARE_bool(enable_edge_cache);
+
+DECLARE_int32(edge_cache_num);
+
+DECLARE_int32(edge_cache_bucket_exp);
+
+DECLARE_int32(edge_cache_max_entry_bytes);
+
 DECLARE_int32(reader_handlers);
 
 DECLARE_uint64(default_mvcc_ver);
@@ -37,8 +47,40 @@ DECLARE_string(reader_handlers_type);
 
 DECLARE_bool(trace_toss);
 
+DECLARE_int32(toss_resume_concurrency);
+
+DECLARE_int32(toss_resume_wait_ms);
+
 DECLARE_int32(max_edge_returned_per_vertex);
 
+DECLARE_int64(max_edges_returned_per_response);
+
 DECLARE_bool(query_concurrently);
 
+DECLARE_int32(query_batch_size);
+
+DECLARE_int32(super_vertex_threshold);
+
+DECLARE_int32(super_vertex_split_num);
+
+DECLARE_bool(enable_filter_program);
+
+DECLARE_bool(enable_update_by_merge);
+
+DECLARE_int32(index_fetch_batch_size);
+
+DECLARE_double(request_trace_sample_rate);
+
+DECLARE_int32(slow_request_log_size);
+
+DECLARE_bool(enable_workload_pools);
+DECLARE_int32(point_read_threads);
+DECLARE_int32(traversal_threads);
+DECLARE_int32(scan_threads);
+DECLARE_int32(mutation_threads);
+DECLARE_int32(admin_threads);
+DECLARE_int64(workload_max_queue_size);
+
+DECLARE_bool(storage_kv_mode);
+
 #endif  // STORAGE_STORAGEFLAGS_H_
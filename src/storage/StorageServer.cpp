@@ -16,6 +16,7 @@
 #include "common/version/Version.h"
 #include "storage/BaseProcessor.h"
 #include "storage/CompactionFilter.h"
+#include "storage/MergeOperator.h"
 #include "storage/StorageFlags.h"
 #include "storage/StorageAdminServiceHandler.h"
 #include "storage/InternalStorageServiceHandler.h"
@@ -24,8 +25,13 @@
 #include "storage/http/StorageHttpDownloadHandler.h"
 #include "storage/http/StorageHttpIngestHandler.h"
 #include "storage/http/StorageHttpAdminHandler.h"
+#include "storage/http/StorageHttpStartupHandler.h"
+#include "storage/http/StorageHttpTraceHandler.h"
+#include "storage/http/StorageHttpWorkloadHandler.h"
 #include "storage/transaction/TransactionManager.h"
+#include "storage/WorkloadPools.h"
 #include "kvstore/PartManager.h"
+#include "kvstore/StartupProgress.h"
 #include "utils/Utils.h"
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 
@@ -63,7 +69,11 @@ std::unique_ptr<kvstore::KVStore> StorageServer::getStoreInstance() {
                                                 metaClient_.get());
     options.cffBuilder_ = std::make_unique<StorageCompactionFilterFactoryBuilder>(schemaMan_.get(),
                                                                                   indexMan_.get());
+    options.mergeOp_ = std::make_shared<NebulaOperator>();
     options.schemaMan_ = schemaMan_.get();
+    if (edgeCache_ != nullptr) {
+        options.commitCb_ = edgeCache_->commitCallback(schemaMan_.get());
+    }
     if (FLAGS_store_type == "nebula") {
         auto nbStore = std::make_unique<kvstore::NebulaStore>(std::move(options),
                                                               ioThreadPool_,
@@ -91,22 +101,42 @@ bool StorageServer::initWebService() {
     webSvc_ = std::make_unique<WebService>();
     auto& router = webSvc_->router();
 
-    router.get("/download").handler([this](web::PathParams&&) {
+    // The web service is started before the store is loaded, the handlers which need the store
+    // are unavailable until it is ready
+    router.get("/download").handler([this](web::PathParams&&) -> proxygen::RequestHandler* {
+        if (!kvstore::StartupProgress::instance().ready()) {
+            return new storage::StorageHttpStartupHandler(true);
+        }
         auto* handler = new storage::StorageHttpDownloadHandler();
         handler->init(hdfsHelper_.get(), webWorkers_.get(), kvstore_.get(), dataPaths_);
         return handler;
     });
-    router.get("/ingest").handler([this](web::PathParams&&) {
+    router.get("/ingest").handler([this](web::PathParams&&) -> proxygen::RequestHandler* {
+        if (!kvstore::StartupProgress::instance().ready()) {
+            return new storage::StorageHttpStartupHandler(true);
+        }
         auto handler = new nebula::storage::StorageHttpIngestHandler();
         handler->init(kvstore_.get());
         return handler;
     });
-    router.get("/admin").handler([this](web::PathParams&&) {
+    router.get("/admin").handler([this](web::PathParams&&) -> proxygen::RequestHandler* {
+        if (!kvstore::StartupProgress::instance().ready()) {
+            return new storage::StorageHttpStartupHandler(true);
+        }
         return new storage::StorageHttpAdminHandler(schemaMan_.get(), kvstore_.get());
     });
     router.get("/rocksdb_stats").handler([](web::PathParams&&) {
         return new storage::StorageHttpStatsHandler();
     });
+    router.get("/slow_requests").handler([](web::PathParams&&) {
+        return new storage::StorageHttpTraceHandler();
+    });
+    router.get("/workloads").handler([](web::PathParams&&) {
+        return new storage::StorageHttpWorkloadHandler();
+    });
+    router.get("/startup").handler([](web::PathParams&&) {
+        return new storage::StorageHttpStartupHandler();
+    });
 
     auto status = webSvc_->start();
     return status.ok();
@@ -145,6 +175,19 @@ bool StorageServer::start() {
     LOG(INFO) << "Init index manager";
     indexMan_ = meta::ServerBasedIndexManager::create(metaClient_.get());
 
+    if (FLAGS_enable_edge_cache) {
+        LOG(INFO) << "Init edge cache";
+        edgeCache_ = std::make_unique<EdgeCache>(FLAGS_edge_cache_num,
+                                                 FLAGS_edge_cache_bucket_exp,
+                                                 FLAGS_edge_cache_max_entry_bytes);
+    }
+
+    // Start the web service first, so that the progress of loading the store could be watched
+    if (!initWebService()) {
+        LOG(ERROR) << "Init webservice failed!";
+        return false;
+    }
+
     LOG(INFO) << "Init kvstore";
     kvstore_ = getStoreInstance();
 
@@ -152,12 +195,9 @@ bool StorageServer::start() {
         LOG(ERROR) << "Init kvstore failed";
         return false;
     }
+    kvstore::StartupProgress::instance().setReady();
 
-    if (!initWebService()) {
-        LOG(ERROR) << "Init webservice failed!";
-        return false;
-    }
-
+    WorkloadPools::instance().init();
     taskMgr_ = AdminTaskManager::instance();
     if (!taskMgr_->init()) {
         LOG(ERROR) << "Init task manager failed!";
@@ -170,6 +210,7 @@ bool StorageServer::start() {
     env_->schemaMan_ = schemaMan_.get();
     env_->rebuildIndexGuard_ = std::make_unique<IndexGuard>();
     env_->metaClient_ = metaClient_.get();
+    env_->edgeCache_ = edgeCache_.get();
 
     txnMan_ = std::make_unique<TransactionManager>(env_.get());
     env_->txnMan_ = txnMan_.get();
@@ -297,6 +338,7 @@ void StorageServer::stop() {
     if (taskMgr_) {
         taskMgr_->shutdown();
     }
+    WorkloadPools::instance().stop();
     if (metaClient_) {
         metaClient_->stop();
     }
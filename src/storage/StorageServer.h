@@ -16,6 +16,7 @@
 #include "kvstore/NebulaStore.h"
 #include "storage/CommonUtils.h"
 #include "storage/admin/AdminTaskManager.h"
+#include "storage/cache/EdgeCache.h"
 
 namespace nebula {
 
@@ -85,6 +86,7 @@ private:
 
     AdminTaskManager* taskMgr_{nullptr};
     std::unique_ptr<TransactionManager> txnMan_;
+    std::unique_ptr<EdgeCache> edgeCache_;
 };
 
 }  // namespace storage
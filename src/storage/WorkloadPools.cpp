@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/WorkloadPools.h"
+#include "common/time/Duration.h"
+#include "storage/StorageFlags.h"
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+namespace nebula {
+namespace storage {
+
+WorkloadExecutor::WorkloadExecutor(const char* name, size_t numThreads, int64_t maxQueueSize)
+    : name_(name)
+    , maxQueueSize_(maxQueueSize) {
+    pool_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::max<size_t>(numThreads, 1),
+        std::make_shared<folly::NamedThreadFactory>(name_ + "-pool"));
+    queueLength_ = stats::StatsManager::registerHisto(
+        name_ + "_queue_length", 100, 0, 10000, "avg, p75, p95, p99");
+    waitUs_ = stats::StatsManager::registerHisto(
+        name_ + "_queue_wait_us", 1000, 0, 100000, "avg, p75, p95, p99");
+    numRejections_ = stats::StatsManager::registerStats(
+        "num_" + name_ + "_rejections", "rate, sum");
+}
+
+void WorkloadExecutor::add(folly::Func func) {
+    auto pending = pending_.fetch_add(1, std::memory_order_relaxed) + 1;
+    stats::StatsManager::addValue(queueLength_, pending);
+    pool_->add([this, func = std::move(func), queued = time::Duration()] () mutable {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        stats::StatsManager::addValue(waitUs_, queued.elapsedInUSec());
+        func();
+    });
+}
+
+bool WorkloadExecutor::admit() {
+    auto maxQueueSize = maxQueueSize_.load(std::memory_order_relaxed);
+    if (maxQueueSize <= 0 || pending() < maxQueueSize) {
+        return true;
+    }
+    rejections_.fetch_add(1, std::memory_order_relaxed);
+    stats::StatsManager::addValue(numRejections_);
+    return false;
+}
+
+void WorkloadExecutor::setNumThreads(size_t numThreads) {
+    LOG(INFO) << "Resize the " << name_ << " pool from " << pool_->numThreads()
+              << " to " << numThreads << " threads";
+    pool_->setNumThreads(std::max<size_t>(numThreads, 1));
+}
+
+folly::dynamic WorkloadExecutor::toJson() const {
+    folly::dynamic pool = folly::dynamic::object();
+    pool["name"] = name_;
+    pool["threads"] = pool_->numThreads();
+    pool["active_threads"] = pool_->numActiveThreads();
+    pool["pending"] = pending();
+    pool["max_queue_size"] = maxQueueSize_.load(std::memory_order_relaxed);
+    pool["rejections"] = rejections_.load(std::memory_order_relaxed);
+    return pool;
+}
+
+WorkloadPools& WorkloadPools::instance() {
+    static WorkloadPools pools;
+    return pools;
+}
+
+const char* WorkloadPools::name(Workload workload) {
+    switch (workload) {
+        case Workload::kPointRead:
+            return "point_read";
+        case Workload::kTraversal:
+            return "traversal";
+        case Workload::kScan:
+            return "scan";
+        case Workload::kMutation:
+            return "mutation";
+        case Workload::kAdmin:
+            return "admin";
+        default:
+            LOG(FATAL) << "Unknown workload " << static_cast<int32_t>(workload);
+    }
+    return "";
+}
+
+void WorkloadPools::init() {
+    if (!FLAGS_enable_workload_pools || pools_.front() != nullptr) {
+        return;
+    }
+    std::array<int32_t, static_cast<size_t>(Workload::kNumWorkloads)> threads = {
+        FLAGS_point_read_threads,
+        FLAGS_traversal_threads,
+        FLAGS_scan_threads,
+        FLAGS_mutation_threads,
+        FLAGS_admin_threads,
+    };
+    for (size_t i = 0; i < pools_.size(); i++) {
+        auto* workloadName = name(static_cast<Workload>(i));
+        LOG(INFO) << "Start the " << workloadName << " pool with " << threads[i] << " threads";
+        pools_[i] = std::make_unique<WorkloadExecutor>(workloadName,
+                                                       std::max(threads[i], 1),
+                                                       FLAGS_workload_max_queue_size);
+    }
+}
+
+void WorkloadPools::stop() {
+    for (auto& pool : pools_) {
+        if (pool != nullptr) {
+            pool->join();
+        }
+    }
+}
+
+WorkloadExecutor* WorkloadPools::find(const std::string& workloadName) {
+    for (size_t i = 0; i < pools_.size(); i++) {
+        if (workloadName == name(static_cast<Workload>(i))) {
+            return pools_[i].get();
+        }
+    }
+    return nullptr;
+}
+
+folly::dynamic WorkloadPools::toJson() {
+    auto pools = folly::dynamic::array();
+    for (const auto& pool : pools_) {
+        if (pool != nullptr) {
+            pools.push_back(pool->toJson());
+        }
+    }
+    return pools;
+}
+
+}  // namespace storage
+}  // namespace nebula
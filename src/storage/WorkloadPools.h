@@ -0,0 +1,116 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_WORKLOADPOOLS_H_
+#define STORAGE_WORKLOADPOOLS_H_
+
+#include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
+#include <folly/Executor.h>
+#include <folly/dynamic.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+namespace nebula {
+namespace storage {
+
+enum class Workload : uint8_t {
+    kPointRead  = 0,    // getProps
+    kTraversal  = 1,    // getNeighbors
+    kScan       = 2,    // scanVertex, scanEdge and lookupIndex
+    kMutation   = 3,    // updateVertex and updateEdge
+    kAdmin      = 4,    // sub tasks of the admin tasks, such as rebuilding index
+    kNumWorkloads = 5,
+};
+
+/**
+ * WorkloadExecutor is the thread pool of one workload. Besides running the tasks, it reports the
+ * number of pending tasks and how long they wait as stats, and admits new requests only when the
+ * pending tasks are fewer than the max queue size. Both the threads and the max queue size could
+ * be changed at runtime.
+ * */
+class WorkloadExecutor final : public folly::Executor {
+public:
+    WorkloadExecutor(const char* name, size_t numThreads, int64_t maxQueueSize);
+
+    void add(folly::Func func) override;
+
+    // Whether a new request is accepted, the limit is soft since the requests admitted at the
+    // same time are all accepted
+    bool admit();
+
+    void setNumThreads(size_t numThreads);
+
+    void setMaxQueueSize(int64_t maxQueueSize) {
+        maxQueueSize_.store(maxQueueSize, std::memory_order_relaxed);
+    }
+
+    int64_t pending() const {
+        return pending_.load(std::memory_order_relaxed);
+    }
+
+    folly::dynamic toJson() const;
+
+    void join() {
+        pool_->join();
+    }
+
+private:
+    std::string                                     name_;
+    std::unique_ptr<folly::CPUThreadPoolExecutor>   pool_;
+    // tasks added but not started yet
+    std::atomic<int64_t>                            pending_{0};
+    // 0 means unlimited
+    std::atomic<int64_t>                            maxQueueSize_;
+    std::atomic<int64_t>                            rejections_{0};
+
+    stats::CounterId                                queueLength_;
+    stats::CounterId                                waitUs_;
+    stats::CounterId                                numRejections_;
+};
+
+/**
+ * WorkloadPools separates the requests into workloads, each of which runs in its own
+ * WorkloadExecutor, so that a long scan or an index rebuilding does not occupy the threads of the
+ * latency-critical point reads and traversals. The pools are only created when
+ * FLAGS_enable_workload_pools is on, otherwise get returns nullptr and the callers run in the
+ * shared pools as before.
+ * */
+class WorkloadPools final {
+public:
+    static WorkloadPools& instance();
+
+    static const char* name(Workload workload);
+
+    // Create the pools sized by the flags, it should be called before serving any request
+    void init();
+
+    void stop();
+
+    WorkloadExecutor* get(Workload workload) {
+        return pools_[static_cast<size_t>(workload)].get();
+    }
+
+    // Return nullptr if no pool of the name
+    WorkloadExecutor* find(const std::string& name);
+
+    bool admit(Workload workload) {
+        auto* pool = get(workload);
+        return pool == nullptr || pool->admit();
+    }
+
+    folly::dynamic toJson();
+
+private:
+    WorkloadPools() = default;
+
+    std::array<std::unique_ptr<WorkloadExecutor>,
+               static_cast<size_t>(Workload::kNumWorkloads)>    pools_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_WORKLOADPOOLS_H_
@@ -6,6 +6,7 @@
 
 #include "storage/admin/AdminTaskManager.h"
 #include "storage/admin/AdminTask.h"
+#include "storage/WorkloadPools.h"
 
 DEFINE_uint32(max_task_concurrency, 10, "The tasks number could be invoked simultaneously");
 DEFINE_uint32(max_concurrent_subtasks, 10, "The sub tasks could be invoked simultaneously");
@@ -28,6 +29,14 @@ bool AdminTaskManager::init() {
     return true;
 }
 
+folly::Executor* AdminTaskManager::executor() {
+    auto* pool = WorkloadPools::instance().get(Workload::kAdmin);
+    if (pool != nullptr) {
+        return pool;
+    }
+    return pool_.get();
+}
+
 void AdminTaskManager::addAsyncTask(std::shared_ptr<AdminTask> task) {
     TaskHandle handle = std::make_pair(task->getJobId(), task->getTaskId());
     tasks_.insert(handle, task);
@@ -141,7 +150,7 @@ void AdminTaskManager::schedule() {
                   task->unFinishedSubTask_.load(),
                   subTaskConcurrency);
         for (size_t i = 0; i < subTaskConcurrency; ++i) {
-            pool_->add(std::bind(&AdminTaskManager::runSubTask, this, handle));
+            executor()->add(std::bind(&AdminTaskManager::runSubTask, this, handle));
         }
     }  // end while (!shutdown_)
     LOG(INFO) << "AdminTaskManager::pickTaskThread(~)";
@@ -182,7 +191,7 @@ void AdminTaskManager::runSubTask(TaskHandle handle) {
             task->finish();
             tasks_.erase(handle);
         } else {
-            pool_->add(std::bind(&AdminTaskManager::runSubTask, this, handle));
+            executor()->add(std::bind(&AdminTaskManager::runSubTask, this, handle));
         }
     } else {
         FLOG_INFO("task(%d, %d) runSubTask() exit", handle.first, handle.second);
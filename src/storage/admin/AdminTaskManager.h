@@ -52,6 +52,8 @@ public:
 private:
     void schedule();
     void runSubTask(TaskHandle handle);
+    // The admin workload pool if the workload pools are enabled, otherwise pool_
+    folly::Executor* executor();
 
 private:
     bool                                    shutdown_{false};
@@ -5,9 +5,11 @@
  */
 
 #include "kvstore/Common.h"
+#include "common/fs/FileUtils.h"
 #include "storage/StorageFlags.h"
 #include "storage/admin/RebuildIndexTask.h"
 #include "utils/OperationKeyUtils.h"
+#include <rocksdb/sst_file_writer.h>
 
 namespace nebula {
 namespace storage {
@@ -18,9 +20,21 @@ RebuildIndexTask::genSubTasks() {
     space_ = *ctx_.parameters_.space_id_ref();
     auto parts = *ctx_.parameters_.parts_ref();
 
+    // The rebuild by ingest is marked by the first parameter, see OperationKeyUtils
+    std::vector<std::string> paras;
+    if (ctx_.parameters_.task_specfic_paras_ref().has_value()) {
+        paras = *ctx_.parameters_.task_specfic_paras_ref();
+    }
+    if (!paras.empty() && paras.front() == kRebuildIndexIngest) {
+        byIngest_ = true;
+        paras.erase(paras.begin());
+    } else if (!paras.empty() && paras.front() == kRebuildIndexReplay) {
+        replay_ = true;
+        paras.erase(paras.begin());
+    }
+
     IndexItems items;
-    if (!ctx_.parameters_.task_specfic_paras_ref().has_value()
-            || (*ctx_.parameters_.task_specfic_paras_ref()).empty()) {
+    if (paras.empty()) {
         auto itemsRet = getIndexes(space_);
         if (!itemsRet.ok()) {
             LOG(ERROR) << "Indexes not found";
@@ -29,7 +43,7 @@ RebuildIndexTask::genSubTasks() {
 
         items = std::move(itemsRet).value();
     } else {
-        for (const auto& index : *ctx_.parameters_.task_specfic_paras_ref()) {
+        for (const auto& index : paras) {
             auto indexID = folly::to<IndexID>(index);
             auto indexRet = getIndex(space_, indexID);
             if (!indexRet.ok()) {
@@ -46,17 +60,22 @@ RebuildIndexTask::genSubTasks() {
     }
 
     std::vector<AdminSubTask> tasks;
-    for (auto it = env_->rebuildIndexGuard_->cbegin();
-         it != env_->rebuildIndexGuard_->cend(); ++it) {
-        if (std::get<0>(it->first) == space_ && it->second != IndexState::FINISHED) {
-            LOG(ERROR) << "This space is building index";
-            return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+    // The leaders are left BUILDING by the ingest round until the operation logs are replayed
+    if (!replay_) {
+        for (auto it = env_->rebuildIndexGuard_->cbegin();
+             it != env_->rebuildIndexGuard_->cend(); ++it) {
+            if (std::get<0>(it->first) == space_ && it->second != IndexState::FINISHED) {
+                LOG(ERROR) << "This space is building index";
+                return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+            }
         }
     }
 
     for (const auto& part : parts) {
-        env_->rebuildIndexGuard_->insert_or_assign(std::make_tuple(space_, part),
-                                                   IndexState::STARTING);
+        if (!replay_) {
+            env_->rebuildIndexGuard_->insert_or_assign(std::make_tuple(space_, part),
+                                                       IndexState::STARTING);
+        }
         std::function<nebula::cpp2::ErrorCode()> task =
             std::bind(&RebuildIndexTask::invoke, this, space_, part, items);
         tasks.emplace_back(std::move(task));
@@ -68,6 +87,47 @@ nebula::cpp2::ErrorCode
 RebuildIndexTask::invoke(GraphSpaceID space,
                          PartitionID part,
                          const IndexItems& items) {
+    auto leader = true;
+    if (byIngest_ || replay_) {
+        auto partRet = env_->kvstore_->part(space, part);
+        if (!nebula::ok(partRet)) {
+            LOG(ERROR) << folly::sformat("Part not found, space={}, part={}", space, part);
+            return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+        }
+        leader = nebula::value(partRet)->isLeader();
+    }
+
+    if (replay_) {
+        if (!leader) {
+            LOG(ERROR) << folly::sformat("Not the leader, space={}, part={}", space, part);
+            return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+        }
+        // The leader may have changed since the ingest round, the operation logs are
+        // replicated so that the new leader could replay them as well
+        env_->rebuildIndexGuard_->insert_or_assign(std::make_tuple(space, part),
+                                                   IndexState::BUILDING);
+        return replayOperations(space, part);
+    }
+
+    if (!leader) {
+        // Every replica builds the index of its own data in the ingest round, the operation
+        // logs are replayed by the leader after all replicas have ingested
+        LOG(INFO) << folly::sformat("Building index on follower, space={}, part={}",
+                                    space, part);
+        env_->rebuildIndexGuard_->assign(std::make_tuple(space, part), IndexState::BUILDING);
+        auto result = buildIndexGlobal(space, part, items);
+        if (result == nebula::cpp2::ErrorCode::SUCCEEDED) {
+            result = ingestIndex(space, part);
+        }
+        removeRuns(space, part);
+        if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            LOG(ERROR) << "Building index failed";
+            return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+        }
+        env_->rebuildIndexGuard_->assign(std::make_tuple(space, part), IndexState::FINISHED);
+        return result;
+    }
+
     auto result = removeLegacyLogs(space, part);
     if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
         LOG(ERROR) << "Remove legacy logs at part: " << part << " failed";
@@ -82,6 +142,10 @@ RebuildIndexTask::invoke(GraphSpaceID space,
 
     LOG(INFO) << "Start building index";
     result = buildIndexGlobal(space, part, items);
+    if (result == nebula::cpp2::ErrorCode::SUCCEEDED) {
+        result = ingestIndex(space, part);
+    }
+    removeRuns(space, part);
     if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
         LOG(ERROR) << "Building index failed";
         return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
@@ -89,8 +153,17 @@ RebuildIndexTask::invoke(GraphSpaceID space,
         LOG(INFO) << folly::sformat("Building index successful, space={}, part={}", space, part);
     }
 
+    if (byIngest_) {
+        // Stay BUILDING, the operation logs are replayed in the replay round
+        return result;
+    }
+    return replayOperations(space, part);
+}
+
+nebula::cpp2::ErrorCode
+RebuildIndexTask::replayOperations(GraphSpaceID space, PartitionID part) {
     LOG(INFO) << folly::sformat("Processing operation logs, space={}, part={}", space, part);
-    result = buildIndexOnOperations(space, part);
+    auto result = buildIndexOnOperations(space, part);
     if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
         LOG(ERROR) << folly::sformat(
             "Building index with operation logs failed, space={}, part={}", space, part);
@@ -247,6 +320,145 @@ RebuildIndexTask::writeData(GraphSpaceID space,
     return result;
 }
 
+nebula::cpp2::ErrorCode
+RebuildIndexTask::writeIndex(GraphSpaceID space,
+                             PartitionID part,
+                             std::vector<kvstore::KV>&& data) {
+    if (!byIngest_) {
+        return writeData(space, part, std::move(data));
+    }
+
+    auto& runs = sstRuns(part);
+    for (auto& kv : data) {
+        runs.bytes += kv.first.size() + kv.second.size();
+        runs.entries.emplace_back(std::move(kv));
+    }
+    if (runs.bytes >= static_cast<size_t>(FLAGS_rebuild_index_sst_buffer_mb) * 1024 * 1024) {
+        return dumpRun(space, part, runs);
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+nebula::cpp2::ErrorCode
+RebuildIndexTask::ingestIndex(GraphSpaceID space, PartitionID part) {
+    if (!byIngest_ || canceled_) {
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    auto& runs = sstRuns(part);
+    if (!runs.entries.empty()) {
+        auto ret = dumpRun(space, part, runs);
+        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            return ret;
+        }
+    }
+
+    auto partRet = env_->kvstore_->part(space, part);
+    if (!nebula::ok(partRet)) {
+        return nebula::error(partRet);
+    }
+    auto* engine = nebula::value(partRet)->engine();
+    // The runs may overlap with each other, they are ingested one by one so that the later
+    // ones win
+    for (const auto& file : runs.files) {
+        LOG(INFO) << folly::sformat("Ingesting index file {}, space={}, part={}",
+                                    file, space, part);
+        auto ret = engine->ingest({file});
+        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            LOG(ERROR) << "Ingest index file " << file << " failed";
+            return ret;
+        }
+    }
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+RebuildIndexTask::SstRuns& RebuildIndexTask::sstRuns(PartitionID part) {
+    std::lock_guard<std::mutex> g(runsLock_);
+    return runs_[part];
+}
+
+nebula::cpp2::ErrorCode
+RebuildIndexTask::dumpRun(GraphSpaceID space, PartitionID part, SstRuns& runs) {
+    auto dirRet = sstDir(space, part);
+    if (!nebula::ok(dirRet)) {
+        LOG(ERROR) << folly::sformat("Part not found, space={}, part={}", space, part);
+        return nebula::error(dirRet);
+    }
+    auto dir = nebula::value(dirRet);
+    if (!fs::FileUtils::exist(dir) && !fs::FileUtils::makeDir(dir)) {
+        LOG(ERROR) << "Make dir " << dir << " failed";
+        return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+    }
+    auto path = folly::stringPrintf("%s/%zu.sst", dir.c_str(), runs.files.size());
+
+    auto& entries = runs.entries;
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    rocksdb::Options options;
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+    auto s = writer.Open(path);
+    if (!s.ok()) {
+        LOG(ERROR) << "Open " << path << " failed: " << s.ToString();
+        return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        // Keys in a SST file must be unique, the last one of the same key wins
+        if (i + 1 < entries.size() && entries[i + 1].first == entries[i].first) {
+            continue;
+        }
+        s = writer.Put(entries[i].first, entries[i].second);
+        if (!s.ok()) {
+            LOG(ERROR) << "Write " << path << " failed: " << s.ToString();
+            return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+        }
+    }
+    s = writer.Finish();
+    if (!s.ok()) {
+        LOG(ERROR) << "Finish " << path << " failed: " << s.ToString();
+        return nebula::cpp2::ErrorCode::E_REBUILD_INDEX_FAILED;
+    }
+
+    VLOG(1) << folly::sformat("Dump {} index entries into {}", entries.size(), path);
+    runs.files.emplace_back(std::move(path));
+    entries.clear();
+    runs.bytes = 0;
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void RebuildIndexTask::removeRuns(GraphSpaceID space, PartitionID part) {
+    if (!byIngest_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> g(runsLock_);
+        runs_.erase(part);
+    }
+    // The part may have been removed while building, its data root is gone with it
+    auto dirRet = sstDir(space, part);
+    if (!nebula::ok(dirRet)) {
+        LOG(WARNING) << folly::sformat("Part not found, space={}, part={}", space, part);
+        return;
+    }
+    auto dir = nebula::value(dirRet);
+    if (fs::FileUtils::exist(dir) && !fs::FileUtils::remove(dir.c_str(), true)) {
+        LOG(WARNING) << "Remove " << dir << " failed";
+    }
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::string>
+RebuildIndexTask::sstDir(GraphSpaceID space, PartitionID part) {
+    auto partRet = env_->kvstore_->part(space, part);
+    if (!nebula::ok(partRet)) {
+        return nebula::error(partRet);
+    }
+    return folly::stringPrintf("%s/rebuild_index/%d/%d",
+                               nebula::value(partRet)->engine()->getDataRoot(),
+                               ctx_.jobId_,
+                               part);
+}
+
 nebula::cpp2::ErrorCode
 RebuildIndexTask::removeData(GraphSpaceID space,
                              PartitionID part,
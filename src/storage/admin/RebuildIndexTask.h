@@ -57,6 +57,16 @@ protected:
               PartitionID part,
               std::vector<kvstore::KV> data);
 
+    // Write the index entries built from the data of the part. They are written through raft,
+    // or sorted into SST files to be ingested by ingestIndex when rebuilding by ingest.
+    nebula::cpp2::ErrorCode
+    writeIndex(GraphSpaceID space,
+               PartitionID part,
+               std::vector<kvstore::KV>&& data);
+
+    nebula::cpp2::ErrorCode
+    ingestIndex(GraphSpaceID space, PartitionID part);
+
     nebula::cpp2::ErrorCode
     removeData(GraphSpaceID space,
                PartitionID part,
@@ -72,9 +82,40 @@ protected:
            PartitionID part,
            const IndexItems& items);
 
+    // Replay the operation logs written while building, then the index is FINISHED
+    nebula::cpp2::ErrorCode
+    replayOperations(GraphSpaceID space, PartitionID part);
+
+private:
+    // The sorted runs of the index entries of a part
+    struct SstRuns {
+        std::vector<kvstore::KV>    entries;
+        size_t                      bytes{0};
+        std::vector<std::string>    files;
+    };
+
+    SstRuns& sstRuns(PartitionID part);
+
+    // Sort the buffered entries and write them into a new SST file
+    nebula::cpp2::ErrorCode
+    dumpRun(GraphSpaceID space, PartitionID part, SstRuns& runs);
+
+    void removeRuns(GraphSpaceID space, PartitionID part);
+
+    ErrorOr<nebula::cpp2::ErrorCode, std::string>
+    sstDir(GraphSpaceID space, PartitionID part);
+
 protected:
     std::atomic<bool>   canceled_{false};
     GraphSpaceID        space_;
+    // Build the index of the data of each replica and ingest it, the followers are scanned too
+    bool                byIngest_{false};
+    // Only replay the operation logs on the leaders, after all replicas have ingested
+    bool                replay_{false};
+
+private:
+    std::mutex                                  runsLock_;
+    std::unordered_map<PartitionID, SstRuns>    runs_;
 };
 
 }  // namespace storage
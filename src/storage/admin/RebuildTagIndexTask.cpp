@@ -45,7 +45,8 @@ RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space,
     auto vidSize = vidSizeRet.value();
     std::unique_ptr<kvstore::KVIterator> iter;
     auto prefix = NebulaKeyUtils::vertexPrefix(part);
-    auto ret = env_->kvstore_->prefix(space, part, prefix, &iter);
+    // The followers build the index of their own data when rebuilding by ingest
+    auto ret = env_->kvstore_->prefix(space, part, prefix, &iter, byIngest_);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
         LOG(ERROR) << "Processing Part " << part << " Failed";
         return ret;
@@ -62,7 +63,7 @@ RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space,
         }
 
         if (static_cast<int32_t>(data.size()) == FLAGS_rebuild_index_batch_num) {
-            auto result = writeData(space, part, data);
+            auto result = writeIndex(space, part, std::move(data));
             if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
                 LOG(ERROR) << "Write Part " << part << " Index Failed";
                 return result;
@@ -142,7 +143,7 @@ RebuildTagIndexTask::buildIndexGlobal(GraphSpaceID space,
         iter->next();
     }
 
-    auto result = writeData(space, part, std::move(data));
+    auto result = writeIndex(space, part, std::move(data));
     if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
         LOG(ERROR) << "Write Part " << part << " Index Failed";
         return nebula::cpp2::ErrorCode::E_STORE_FAILURE;
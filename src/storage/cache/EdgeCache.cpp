@@ -0,0 +1,195 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/cache/EdgeCache.h"
+#include "common/stats/StatsManager.h"
+#include "utils/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace storage {
+
+stats::CounterId kNumEdgeCacheHits;
+stats::CounterId kNumEdgeCacheMisses;
+stats::CounterId kNumEdgeCacheInvalidations;
+
+EdgeCacheIterator::EdgeCacheIterator(std::string rows,
+                                     std::unique_ptr<kvstore::KVIterator> tail)
+        : rows_(std::move(rows))
+        , tail_(std::move(tail)) {
+    // rows_ will not be modified any more, so it is safe to refer to its buffer
+    const char* pos = rows_.data();
+    const char* end = rows_.data() + rows_.size();
+    while (pos < end) {
+        uint32_t keyLen = *reinterpret_cast<const uint32_t*>(pos);
+        pos += sizeof(uint32_t);
+        folly::StringPiece key(pos, keyLen);
+        pos += keyLen;
+        uint32_t valLen = *reinterpret_cast<const uint32_t*>(pos);
+        pos += sizeof(uint32_t);
+        folly::StringPiece val(pos, valLen);
+        pos += valLen;
+        entries_.emplace_back(key, val);
+    }
+    CHECK(pos == end);
+}
+
+EdgeCache::EdgeCache(size_t capacity, uint32_t bucketsExp, size_t maxEntryBytes)
+        : cache_(capacity, bucketsExp)
+        , maxEntryBytes_(maxEntryBytes) {
+    for (auto& v : versions_) {
+        v.store(0, std::memory_order_relaxed);
+    }
+    if (!kNumEdgeCacheHits.valid()) {
+        kNumEdgeCacheHits = stats::StatsManager::registerStats("num_edge_cache_hits",
+                                                               "rate, sum");
+        kNumEdgeCacheMisses = stats::StatsManager::registerStats("num_edge_cache_misses",
+                                                                 "rate, sum");
+        kNumEdgeCacheInvalidations =
+            stats::StatsManager::registerStats("num_edge_cache_invalidations", "rate, sum");
+    }
+}
+
+std::string EdgeCache::cacheKey(GraphSpaceID spaceId, folly::StringPiece prefix) const {
+    std::string key;
+    key.reserve(sizeof(GraphSpaceID) + prefix.size());
+    key.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID))
+       .append(prefix.data(), prefix.size());
+    return key;
+}
+
+std::atomic<uint64_t>& EdgeCache::slot(const std::string& key) {
+    return versions_[std::hash<std::string>()(key) % kVersionSlots];
+}
+
+uint64_t EdgeCache::generation(GraphSpaceID spaceId, PartitionID partId) {
+    folly::RWSpinLock::ReadHolder rh(&generationLock_);
+    auto it = generations_.find(std::make_pair(spaceId, partId));
+    return it == generations_.end() ? 0 : it->second;
+}
+
+std::unique_ptr<kvstore::KVIterator> EdgeCache::get(GraphSpaceID spaceId,
+                                                    const std::string& prefix) {
+    auto key = cacheKey(spaceId, prefix);
+    auto ret = cache_.get(key);
+    if (ret.ok()) {
+        // the entry starts with the generation of the part when it was filled
+        auto entry = std::move(ret).value();
+        auto gen = readInt<uint64_t>(entry.data(), sizeof(uint64_t));
+        if (gen == generation(spaceId, NebulaKeyUtils::getPart(prefix))) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            stats::StatsManager::addValue(kNumEdgeCacheHits);
+            return std::make_unique<EdgeCacheIterator>(entry.substr(sizeof(uint64_t)));
+        }
+        cache_.evict(key);
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    stats::StatsManager::addValue(kNumEdgeCacheMisses);
+    return nullptr;
+}
+
+EdgeCache::Version EdgeCache::version(GraphSpaceID spaceId, const std::string& prefix) {
+    Version version;
+    version.slot = slot(cacheKey(spaceId, prefix)).load(std::memory_order_acquire);
+    version.generation = generation(spaceId, NebulaKeyUtils::getPart(prefix));
+    return version;
+}
+
+std::unique_ptr<kvstore::KVIterator>
+EdgeCache::fill(GraphSpaceID spaceId,
+                const std::string& prefix,
+                Version version,
+                std::unique_ptr<kvstore::KVIterator> iter) {
+    std::string rows;
+    bool complete = true;
+    while (iter->valid()) {
+        auto key = iter->key();
+        auto val = iter->val();
+        if (rows.size() + 2 * sizeof(uint32_t) + key.size() + val.size() > maxEntryBytes_) {
+            complete = false;
+            break;
+        }
+        uint32_t keyLen = key.size();
+        uint32_t valLen = val.size();
+        rows.append(reinterpret_cast<const char*>(&keyLen), sizeof(uint32_t))
+            .append(key.data(), key.size())
+            .append(reinterpret_cast<const char*>(&valLen), sizeof(uint32_t))
+            .append(val.data(), val.size());
+        iter->next();
+    }
+    if (!complete) {
+        // Too many edges to cache, the rows read so far will be returned before the rest
+        return std::make_unique<EdgeCacheIterator>(std::move(rows), std::move(iter));
+    }
+
+    auto key = cacheKey(spaceId, prefix);
+    auto& ver = slot(key);
+    std::string entry;
+    entry.reserve(sizeof(uint64_t) + rows.size());
+    entry.append(reinterpret_cast<const char*>(&version.generation), sizeof(uint64_t))
+         .append(rows);
+    cache_.insert(key, std::move(entry));
+    // If any write on the same slot has been committed since we started to scan, the rows
+    // might be stale, so drop it. Either we see the new version here, or the writer will evict
+    // our entry after it bumps the version. A part invalidated in the meantime is caught by the
+    // generation when the entry is read.
+    if (ver.load(std::memory_order_acquire) != version.slot) {
+        cache_.evict(key);
+    }
+    return std::make_unique<EdgeCacheIterator>(std::move(rows));
+}
+
+void EdgeCache::invalidate(GraphSpaceID spaceId,
+                           size_t vIdLen,
+                           const std::vector<std::string>& keys) {
+    static constexpr size_t kTypeLen = sizeof(NebulaKeyType);
+    for (const auto& key : keys) {
+        if (key.size() != kEdgeLen + (vIdLen << 1)) {
+            continue;
+        }
+        auto type = readInt<uint32_t>(key.data(), kTypeLen) & kTypeMask;
+        if (static_cast<NebulaKeyType>(type) != NebulaKeyType::kEdge) {
+            continue;
+        }
+        // the prefix of (partId, srcId, edgeType)
+        folly::StringPiece prefix(key.data(), sizeof(PartitionID) + vIdLen + sizeof(EdgeType));
+        auto ck = cacheKey(spaceId, prefix);
+        slot(ck).fetch_add(1, std::memory_order_acq_rel);
+        cache_.evict(ck);
+        invalidations_.fetch_add(1, std::memory_order_relaxed);
+        stats::StatsManager::addValue(kNumEdgeCacheInvalidations);
+    }
+}
+
+void EdgeCache::invalidatePart(GraphSpaceID spaceId, PartitionID partId) {
+    {
+        folly::RWSpinLock::WriteHolder wh(&generationLock_);
+        ++generations_[std::make_pair(spaceId, partId)];
+    }
+    invalidations_.fetch_add(1, std::memory_order_relaxed);
+    stats::StatsManager::addValue(kNumEdgeCacheInvalidations);
+}
+
+kvstore::CommitCallback EdgeCache::commitCallback(meta::SchemaManager* schemaMan) {
+    return [this, schemaMan] (GraphSpaceID spaceId,
+                              PartitionID partId,
+                              const std::vector<std::string>& keys,
+                              bool all) {
+        if (all) {
+            invalidatePart(spaceId, partId);
+            return;
+        }
+        auto vIdLen = schemaMan->getSpaceVidLen(spaceId);
+        if (!vIdLen.ok()) {
+            // We could not tell which keys are edges, so be conservative
+            invalidatePart(spaceId, partId);
+            return;
+        }
+        invalidate(spaceId, vIdLen.value(), keys);
+    };
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,150 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_CACHE_EDGECACHE_H_
+#define STORAGE_CACHE_EDGECACHE_H_
+
+#include "common/base/Base.h"
+#include "common/base/ConcurrentLRUCache.h"
+#include <folly/RWSpinLock.h>
+#include "common/meta/SchemaManager.h"
+#include "kvstore/Common.h"
+#include "kvstore/KVIterator.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * EdgeCacheIterator iterates over the rows of an encoded edge list, the rows are laid out as
+ * keyLen(4) + key + valLen(4) + val. If the list is not complete (the vertex has too many edges
+ * to be cached), `tail` is the iterator of kvstore to continue with.
+ * */
+class EdgeCacheIterator final : public kvstore::KVIterator {
+public:
+    explicit EdgeCacheIterator(std::string rows,
+                               std::unique_ptr<kvstore::KVIterator> tail = nullptr);
+
+    bool valid() const override {
+        return idx_ < entries_.size() || (tail_ != nullptr && tail_->valid());
+    }
+
+    void next() override {
+        if (idx_ < entries_.size()) {
+            ++idx_;
+        } else {
+            tail_->next();
+        }
+    }
+
+    void prev() override {
+        LOG(FATAL) << "EdgeCacheIterator::prev() is not supported";
+    }
+
+    folly::StringPiece key() const override {
+        if (idx_ < entries_.size()) {
+            return entries_[idx_].first;
+        }
+        return tail_->key();
+    }
+
+    folly::StringPiece val() const override {
+        if (idx_ < entries_.size()) {
+            return entries_[idx_].second;
+        }
+        return tail_->val();
+    }
+
+private:
+    std::string                                                  rows_;
+    std::vector<std::pair<folly::StringPiece, folly::StringPiece>> entries_;
+    size_t                                                       idx_ = 0;
+    std::unique_ptr<kvstore::KVIterator>                         tail_;
+};
+
+/**
+ * EdgeCache keeps the raw out-edge list of (space, part, srcId, edgeType), the cache key is
+ * spaceId + NebulaKeyUtils::edgePrefix(vIdLen, partId, srcId, edgeType). It is bounded by
+ * both the number of entries and the bytes of each entry, so the memory used is at most
+ * capacity * maxEntryBytes. Entries are invalidated by the raft commit callback, so any write
+ * applied on this host (processors, toss, snapshot, ingest) will evict the related lists, and
+ * so does the removal of a part or a space.
+ *
+ * Writes which could not be listed by key invalidate the whole part, by bumping the generation
+ * of the part. Each entry records the generation it was filled in, and is dropped when it is
+ * read after the generation moved on, so the other parts keep their entries.
+ * */
+class EdgeCache final {
+public:
+    // Read before scanning the kvstore, and passed to `fill'
+    struct Version {
+        uint64_t slot;
+        uint64_t generation;
+    };
+
+    EdgeCache(size_t capacity, uint32_t bucketsExp, size_t maxEntryBytes);
+
+    // Return an iterator over the cached edges, or nullptr if not found.
+    std::unique_ptr<kvstore::KVIterator> get(GraphSpaceID spaceId, const std::string& prefix);
+
+    // The version of the slot and the generation of the part which `prefix' belongs to
+    Version version(GraphSpaceID spaceId, const std::string& prefix);
+
+    // Read all edges from `iter', and put them into cache if they fit in one entry. The returned
+    // iterator yields exactly the same rows as `iter' would do.
+    std::unique_ptr<kvstore::KVIterator> fill(GraphSpaceID spaceId,
+                                              const std::string& prefix,
+                                              Version version,
+                                              std::unique_ptr<kvstore::KVIterator> iter);
+
+    // Evict the edge lists which contain any of the edge keys
+    void invalidate(GraphSpaceID spaceId, size_t vIdLen, const std::vector<std::string>& keys);
+
+    // Evict all edge lists of the part
+    void invalidatePart(GraphSpaceID spaceId, PartitionID partId);
+
+    // Build the callback to be registered in kvstore::KVOptions
+    kvstore::CommitCallback commitCallback(meta::SchemaManager* schemaMan);
+
+    uint64_t hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t invalidations() const {
+        return invalidations_.load(std::memory_order_relaxed);
+    }
+
+    // evictions because of capacity
+    uint64_t evicts() {
+        return cache_.evicts();
+    }
+
+private:
+    std::string cacheKey(GraphSpaceID spaceId, folly::StringPiece prefix) const;
+
+    std::atomic<uint64_t>& slot(const std::string& key);
+
+    uint64_t generation(GraphSpaceID spaceId, PartitionID partId);
+
+    static constexpr size_t kVersionSlots = 1024;
+
+    ConcurrentLRUCache<std::string, std::string>       cache_;
+    size_t                                             maxEntryBytes_;
+    std::array<std::atomic<uint64_t>, kVersionSlots>   versions_;
+    folly::RWSpinLock                                  generationLock_;
+    std::unordered_map<std::pair<GraphSpaceID, PartitionID>, uint64_t> generations_;
+
+    std::atomic<uint64_t>                              hits_{0};
+    std::atomic<uint64_t>                              misses_{0};
+    std::atomic<uint64_t>                              invalidations_{0};
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_CACHE_EDGECACHE_H_
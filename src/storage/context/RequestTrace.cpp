@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/context/RequestTrace.h"
+#include "common/time/WallClock.h"
+#include "storage/StorageFlags.h"
+#include <folly/Random.h>
+
+namespace nebula {
+namespace storage {
+
+thread_local RequestTrace* RequestTrace::current_ = nullptr;
+
+namespace {
+
+bool faster(const std::unique_ptr<RequestTrace>& a, const std::unique_ptr<RequestTrace>& b) {
+    // std heap is a max heap of the comparator, so the fastest is on the top
+    return a->latencyUs() > b->latencyUs();
+}
+
+}  // namespace
+
+RequestTrace::RequestTrace(const char* name, GraphSpaceID space)
+    : name_(name)
+    , space_(space)
+    , startTime_(time::WallClock::fastNowInMicroSec()) {}
+
+std::unique_ptr<RequestTrace> RequestTrace::sample(const char* name, GraphSpaceID space) {
+    auto rate = FLAGS_request_trace_sample_rate;
+    if (rate <= 0 || (rate < 1 && folly::Random::randDouble01() >= rate)) {
+        return nullptr;
+    }
+    return std::make_unique<RequestTrace>(name, space);
+}
+
+void RequestTrace::finish(std::unique_ptr<RequestTrace> trace,
+                          int64_t latencyUs,
+                          size_t failedParts) {
+    if (trace == nullptr) {
+        return;
+    }
+    trace->latencyUs_ = latencyUs;
+    trace->failedParts_ = failedParts;
+    SlowRequestLog::instance().add(std::move(trace));
+}
+
+folly::dynamic RequestTrace::toJson() const {
+    auto executeUs = stageUs_[kExecute].load(std::memory_order_relaxed);
+    auto decodeUs = stageUs_[kDecode].load(std::memory_order_relaxed);
+    auto filterUs = stageUs_[kFilter].load(std::memory_order_relaxed);
+    folly::dynamic trace = folly::dynamic::object();
+    trace["name"] = name_;
+    trace["space"] = space_;
+    trace["start_time_us"] = startTime_;
+    trace["latency_us"] = latencyUs_;
+    trace["failed_parts"] = failedParts_;
+    trace["queue_us"] = stageUs_[kQueue].load(std::memory_order_relaxed);
+    trace["execute_us"] = executeUs;
+    trace["read_us"] = std::max<int64_t>(0, executeUs - decodeUs - filterUs);
+    trace["decode_us"] = decodeUs;
+    trace["filter_us"] = filterUs;
+    trace["output_us"] = stageUs_[kOutput].load(std::memory_order_relaxed);
+    trace["keys_read"] = keys_.load(std::memory_order_relaxed);
+    trace["bytes_read"] = bytes_.load(std::memory_order_relaxed);
+    trace["rows_returned"] = rows_;
+    return trace;
+}
+
+SlowRequestLog& SlowRequestLog::instance() {
+    static SlowRequestLog log;
+    return log;
+}
+
+void SlowRequestLog::add(std::unique_ptr<RequestTrace> trace) {
+    auto size = static_cast<size_t>(std::max(FLAGS_slow_request_log_size, 0));
+    std::lock_guard<std::mutex> g(lock_);
+    if (traces_.size() < size) {
+        traces_.emplace_back(std::move(trace));
+        std::push_heap(traces_.begin(), traces_.end(), faster);
+        return;
+    }
+    if (traces_.empty() || trace->latencyUs() <= traces_.front()->latencyUs()) {
+        return;
+    }
+    std::pop_heap(traces_.begin(), traces_.end(), faster);
+    traces_.back() = std::move(trace);
+    std::push_heap(traces_.begin(), traces_.end(), faster);
+}
+
+folly::dynamic SlowRequestLog::toJson() {
+    std::vector<folly::dynamic> traces;
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        traces.reserve(traces_.size());
+        for (const auto& trace : traces_) {
+            traces.emplace_back(trace->toJson());
+        }
+    }
+    std::sort(traces.begin(), traces.end(), [](const auto& a, const auto& b) {
+        return a["latency_us"].asInt() > b["latency_us"].asInt();
+    });
+    auto result = folly::dynamic::array();
+    for (auto& trace : traces) {
+        result.push_back(std::move(trace));
+    }
+    return result;
+}
+
+void SlowRequestLog::clear() {
+    std::lock_guard<std::mutex> g(lock_);
+    traces_.clear();
+}
+
+}  // namespace storage
+}  // namespace nebula
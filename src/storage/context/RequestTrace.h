@@ -0,0 +1,163 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_CONTEXT_REQUESTTRACE_H_
+#define STORAGE_CONTEXT_REQUESTTRACE_H_
+
+#include "common/base/Base.h"
+#include "common/time/Duration.h"
+#include <folly/dynamic.h>
+
+namespace nebula {
+namespace storage {
+
+/**
+ * RequestTrace records where the time of a sampled request goes: waiting in the queue of the
+ * workers, reading from the kvstore, decoding the props, evaluating the filter and merging the
+ * results of the parts, along with the keys and bytes read and the rows returned.
+ *
+ * A processor samples a trace when the request arrives, and sets it as the current trace of the
+ * thread which is working on the request, so that the nodes could account their time by
+ * ScopedTrace without passing the trace around. When no request is traced, the cost is a read of
+ * a thread local pointer.
+ *
+ * The time of reading is what is left of kExecute after decoding and filtering. When the parts
+ * are executed concurrently, the stages are the sum of all threads, which could be more than the
+ * latency.
+ * */
+class RequestTrace final {
+public:
+    enum Stage : uint8_t {
+        kQueue      = 0,
+        kExecute    = 1,
+        kDecode     = 2,
+        kFilter     = 3,
+        kOutput     = 4,
+        kNumStages  = 5,
+    };
+
+    RequestTrace(const char* name, GraphSpaceID space);
+
+    // Return a trace of the request if it is sampled by FLAGS_request_trace_sample_rate,
+    // otherwise nullptr
+    static std::unique_ptr<RequestTrace> sample(const char* name, GraphSpaceID space);
+
+    // The trace of the request processed by the current thread, nullptr if not traced
+    static RequestTrace* current() {
+        return current_;
+    }
+
+    static void setCurrent(RequestTrace* trace) {
+        current_ = trace;
+    }
+
+    // Account a key read by the current request
+    static void countKey(size_t bytes) {
+        if (current_ != nullptr) {
+            current_->keys_.fetch_add(1, std::memory_order_relaxed);
+            current_->bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    void addTime(Stage stage, int64_t us) {
+        stageUs_[stage].fetch_add(us, std::memory_order_relaxed);
+    }
+
+    void setRows(int64_t rows) {
+        rows_ = rows;
+    }
+
+    // Called once the response is sent, the trace is kept by the SlowRequestLog if it is one of
+    // the slowest ones
+    static void finish(std::unique_ptr<RequestTrace> trace,
+                       int64_t latencyUs,
+                       size_t failedParts);
+
+    int64_t latencyUs() const {
+        return latencyUs_;
+    }
+
+    folly::dynamic toJson() const;
+
+private:
+    static thread_local RequestTrace*   current_;
+
+    std::string                         name_;
+    GraphSpaceID                        space_;
+    int64_t                             startTime_;
+    int64_t                             latencyUs_{0};
+    size_t                              failedParts_{0};
+    std::array<std::atomic<int64_t>, kNumStages> stageUs_{};
+    std::atomic<int64_t>                keys_{0};
+    std::atomic<int64_t>                bytes_{0};
+    int64_t                             rows_{0};
+};
+
+// Account the time of the scope to a stage of the current trace
+class ScopedTrace final {
+public:
+    explicit ScopedTrace(RequestTrace::Stage stage)
+        : trace_(RequestTrace::current())
+        , stage_(stage) {
+        if (trace_ != nullptr) {
+            duration_.reset();
+        }
+    }
+
+    ~ScopedTrace() {
+        if (trace_ != nullptr) {
+            trace_->addTime(stage_, duration_.elapsedInUSec());
+        }
+    }
+
+private:
+    RequestTrace*           trace_;
+    RequestTrace::Stage     stage_;
+    time::Duration          duration_{true};
+};
+
+// Set the trace as the current one of the thread in the scope
+class TraceGuard final {
+public:
+    explicit TraceGuard(RequestTrace* trace)
+        : prev_(RequestTrace::current()) {
+        RequestTrace::setCurrent(trace);
+    }
+
+    ~TraceGuard() {
+        RequestTrace::setCurrent(prev_);
+    }
+
+private:
+    RequestTrace* prev_;
+};
+
+/**
+ * SlowRequestLog keeps the slowest FLAGS_slow_request_log_size traced requests, they are
+ * returned by the /slow_requests of the web service, slowest first.
+ * */
+class SlowRequestLog final {
+public:
+    static SlowRequestLog& instance();
+
+    void add(std::unique_ptr<RequestTrace> trace);
+
+    folly::dynamic toJson();
+
+    void clear();
+
+private:
+    SlowRequestLog() = default;
+
+    std::mutex                                      lock_;
+    // min heap of the latency, the fastest one is dropped when full
+    std::vector<std::unique_ptr<RequestTrace>>      traces_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_CONTEXT_REQUESTTRACE_H_
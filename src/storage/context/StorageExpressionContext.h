@@ -101,6 +101,14 @@ public:
         return vIdLen_;
     }
 
+    const std::string& name() const {
+        return name_;
+    }
+
+    const meta::NebulaSchemaProvider* schema() const {
+        return schema_;
+    }
+
     bool hasNullableCol() const {
         return hasNullableCol_;
     }
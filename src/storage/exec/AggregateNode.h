@@ -69,9 +69,17 @@ public:
     }
 
     void calculateStat() {
+        this->result_.setList(calculateStat(stats_));
+    }
+
+    const std::vector<PropStat>& stats() const {
+        return stats_;
+    }
+
+    static nebula::List calculateStat(const std::vector<PropStat>& stats) {
         nebula::List result;
-        result.values.reserve(stats_.size());
-        for (const auto& stat : stats_) {
+        result.values.reserve(stats.size());
+        for (const auto& stat : stats) {
             if (stat.statType_ == cpp2::StatType::SUM) {
                 result.values.emplace_back(stat.sum_);
             } else if (stat.statType_ == cpp2::StatType::COUNT) {
@@ -84,7 +92,16 @@ public:
                 result.values.emplace_back(stat.min_);
             }
         }
-        this->result_.setList(std::move(result));
+        return result;
+    }
+
+    // Merge the stat collected from another part of the edges of the same vertex
+    static void mergeStat(const PropStat& from, PropStat& to) {
+        DCHECK(from.statType_ == to.statType_);
+        to.sum_ = to.sum_ + from.sum_;
+        to.count_ = to.count_ + from.count_;
+        to.max_ = from.max_ > to.max_ ? from.max_ : to.max_;
+        to.min_ = from.min_ < to.min_ ? from.min_ : to.min_;
     }
 
 private:
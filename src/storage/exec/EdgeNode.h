@@ -8,14 +8,25 @@
 #define STORAGE_EXEC_EDGENODE_H_
 
 #include "common/base/Base.h"
+#include "kvstore/Part.h"
 #include "storage/exec/RelNode.h"
 #include "storage/exec/StorageIterator.h"
+#include "storage/cache/EdgeCache.h"
 #include "storage/transaction/TransactionManager.h"
 #include "storage/transaction/TossEdgeIterator.h"
 
 namespace nebula {
 namespace storage {
 
+// The key range of the edges of one edge type of a vertex, start_ and end_ are the suffix after
+// the edge prefix, an empty end_ means till the end of the prefix. It is used to split the edges
+// of a super vertex into sub-ranges, which are scanned in parallel.
+struct EdgeRange {
+    EdgeType    edgeType_;
+    std::string start_;
+    std::string end_;
+};
+
 // EdgeNode will return a StorageIterator which iterates over the specified
 // edgeType of given vertexId
 template<typename T>
@@ -174,11 +185,46 @@ public:
         VLOG(1) << "partId " << partId << ", vId " << vId << ", edgeType " << edgeType_
                 << ", prop size " << props_->size();
         std::unique_ptr<kvstore::KVIterator> iter;
+        if (range_ != nullptr && range_->edgeType_ != edgeType_) {
+            // only the edges in the range are scanned
+            iter_.reset();
+            return nebula::cpp2::ErrorCode::SUCCEEDED;
+        }
         prefix_ = NebulaKeyUtils::edgePrefix(context_->vIdLen(), partId, vId, edgeType_);
-        ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix_, &iter);
+        bool toss = context_->env()->txnMan_ &&
+                    context_->env()->txnMan_->enableToss(context_->spaceId());
+        auto* edgeCache = context_->env()->edgeCache_;
+        if (range_ != nullptr) {
+            start_ = prefix_ + range_->start_;
+            if (range_->end_.empty()) {
+                ret = context_->env()->kvstore_->rangeWithPrefix(
+                    context_->spaceId(), partId, start_, prefix_, &iter);
+            } else {
+                end_ = prefix_ + range_->end_;
+                ret = context_->env()->kvstore_->range(
+                    context_->spaceId(), partId, start_, end_, &iter);
+            }
+        } else if (FLAGS_enable_edge_cache && edgeCache != nullptr && !toss) {
+            // lock keys of toss need to be resolved when reading, so edge cache is not used
+            ret = checkLeader(partId);
+            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                iter_.reset();
+                return ret;
+            }
+            iter = edgeCache->get(context_->spaceId(), prefix_);
+            if (iter == nullptr) {
+                auto version = edgeCache->version(context_->spaceId(), prefix_);
+                ret = context_->env()->kvstore_->prefix(
+                    context_->spaceId(), partId, prefix_, &iter);
+                if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter) {
+                    iter = edgeCache->fill(context_->spaceId(), prefix_, version, std::move(iter));
+                }
+            }
+        } else {
+            ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix_, &iter);
+        }
         if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && iter->valid()) {
-            if (context_->env()->txnMan_ &&
-                context_->env()->txnMan_->enableToss(context_->spaceId())) {
+            if (toss) {
                 bool stopAtFirstEdge = false;
                 iter_.reset(new TossEdgeIterator(
                     context_, std::move(iter), edgeType_, schemas_, &ttl_, stopAtFirstEdge));
@@ -191,6 +237,31 @@ public:
         }
         return ret;
     }
+
+    // Only scan the edges in the range, the range must outlive the node
+    void setRange(const EdgeRange* range) {
+        range_ = range;
+    }
+
+private:
+    // The cached edges could only be served by a leader in lease, the same as what kvstore
+    // checks before reading
+    nebula::cpp2::ErrorCode checkLeader(PartitionID partId) {
+        auto partRet = context_->env()->kvstore_->part(context_->spaceId(), partId);
+        if (!nebula::ok(partRet)) {
+            return nebula::error(partRet);
+        }
+        auto part = nebula::value(partRet);
+        if (!part->isLeader() || !part->leaseValid()) {
+            return nebula::cpp2::ErrorCode::E_LEADER_CHANGED;
+        }
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    const EdgeRange* range_ = nullptr;
+    // the range interface of kvstore holds the reference of the start and end key
+    std::string start_;
+    std::string end_;
 };
 
 }  // namespace storage
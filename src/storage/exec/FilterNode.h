@@ -9,8 +9,11 @@
 
 #include "common/base/Base.h"
 #include "common/expression/Expression.h"
+#include "storage/StorageFlags.h"
 #include "storage/exec/HashJoinNode.h"
+#include "storage/exec/FilterProgram.h"
 #include "storage/context/StorageExpressionContext.h"
+#include "storage/context/RequestTrace.h"
 
 namespace nebula {
 namespace storage {
@@ -24,6 +27,9 @@ As for GetNeighbors, it will have filter that involves both tag and edge express
 that case, FilterNode has a upstream of HashJoinNode, which will keep popping out edge
 data. All tage data has been put into ExpressionContext before FilterNode is executed.
 By that means, it can check the filter of tag + edge.
+
+If the filter has been compiled into a FilterProgram by compileFilter, the rows are checked by the
+program first, and only those it could not decide are evaluated by the expression.
 */
 template<typename T>
 class FilterNode : public IterateNode<T> {
@@ -39,11 +45,20 @@ public:
         , expCtx_(expCtx)
         , filterExp_(exp) {}
 
+    // Compile the filter into a FilterProgram if possible, see FilterProgram::compile for isEdge
+    void compileFilter(bool isEdge) {
+        if (FLAGS_enable_filter_program && filterExp_ != nullptr) {
+            program_ = FilterProgram::compile(filterExp_, isEdge);
+        }
+    }
+
     nebula::cpp2::ErrorCode execute(PartitionID partId, const T& vId) override {
         auto ret = RelNode<T>::execute(partId, vId);
         if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
             return ret;
         }
+        // the tag props of the vertex have been set into expCtx_ by upstream
+        srcBound_ = false;
 
         do {
             if (context_->resultStat_ == ResultStatus::ILLEGAL_DATA) {
@@ -63,6 +78,20 @@ private:
     // return true when the value iter points to a value which can filter
     bool check() override {
         if (filterExp_ != nullptr) {
+            ScopedTrace filter(RequestTrace::kFilter);
+            if (program_ != nullptr) {
+                if (!srcBound_) {
+                    program_->bindSrcProps(*expCtx_);
+                    srcBound_ = true;
+                }
+                auto result = program_->check(context_->edgeName_,
+                                              context_->edgeSchema_,
+                                              this->reader(),
+                                              this->val());
+                if (result != FilterProgram::Result::kUnknown) {
+                    return result == FilterProgram::Result::kTrue;
+                }
+            }
             expCtx_->reset(this->reader(), this->key().str());
             // result is false when filter out
             auto result = filterExp_->eval(*expCtx_);
@@ -80,6 +109,8 @@ private:
     RunTimeContext                   *context_;
     StorageExpressionContext         *expCtx_;
     Expression                       *filterExp_;
+    std::unique_ptr<FilterProgram>    program_;
+    bool                              srcBound_{false};
 };
 
 }  // namespace storage
@@ -0,0 +1,435 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/exec/FilterProgram.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/ContainerExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// The types of constants which could be compared with a prop without any conversion
+bool isSupportedConstant(const Value& value) {
+    switch (value.type()) {
+        case Value::Type::INT:
+        case Value::Type::STRING:
+        case Value::Type::BOOL:
+            return true;
+        case Value::Type::FLOAT:
+            return !std::isnan(value.getFloat());
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<FilterProgram> FilterProgram::compile(const Expression* exp, bool isEdge) {
+    if (exp == nullptr) {
+        return nullptr;
+    }
+    std::unique_ptr<FilterProgram> program(new FilterProgram(isEdge));
+    if (!program->compileExp(exp)) {
+        VLOG(2) << "Filter could not be compiled: " << exp->toString();
+        return nullptr;
+    }
+    program->srcValues_.resize(program->props_.size());
+    return program;
+}
+
+bool FilterProgram::compileExp(const Expression* exp) {
+    switch (exp->kind()) {
+        case Expression::Kind::kLogicalAnd:
+        case Expression::Kind::kLogicalOr: {
+            auto* logExp = static_cast<const LogicalExpression*>(exp);
+            const auto& operands = logExp->operands();
+            if (operands.empty()) {
+                return false;
+            }
+            for (const auto& operand : operands) {
+                if (!compileExp(operand)) {
+                    return false;
+                }
+            }
+            auto op = exp->kind() == Expression::Kind::kLogicalAnd ? OpCode::kAnd : OpCode::kOr;
+            for (size_t i = 1; i < operands.size(); i++) {
+                Instruction ins;
+                ins.op = op;
+                program_.emplace_back(std::move(ins));
+            }
+            return true;
+        }
+        case Expression::Kind::kUnaryNot: {
+            auto* unaExp = static_cast<const UnaryExpression*>(exp);
+            if (!compileExp(unaExp->operand())) {
+                return false;
+            }
+            Instruction ins;
+            ins.op = OpCode::kNot;
+            program_.emplace_back(std::move(ins));
+            return true;
+        }
+        case Expression::Kind::kIsNull:
+        case Expression::Kind::kIsNotNull: {
+            auto* unaExp = static_cast<const UnaryExpression*>(exp);
+            Instruction ins;
+            ins.op = exp->kind() == Expression::Kind::kIsNull ? OpCode::kIsNull
+                                                              : OpCode::kIsNotNull;
+            if (!compileProp(unaExp->operand(), ins.prop)) {
+                return false;
+            }
+            program_.emplace_back(std::move(ins));
+            return true;
+        }
+        case Expression::Kind::kRelEQ:
+        case Expression::Kind::kRelNE:
+        case Expression::Kind::kRelLT:
+        case Expression::Kind::kRelLE:
+        case Expression::Kind::kRelGT:
+        case Expression::Kind::kRelGE: {
+            auto* relExp = static_cast<const RelationalExpression*>(exp);
+            const Expression* propExp = relExp->left();
+            const Expression* constExp = relExp->right();
+            // `constant op prop' is the same as `prop flipped(op) constant'
+            bool flipped = false;
+            if (propExp->kind() == Expression::Kind::kConstant) {
+                std::swap(propExp, constExp);
+                flipped = true;
+            }
+            if (constExp->kind() != Expression::Kind::kConstant) {
+                return false;
+            }
+            const auto& value = static_cast<const ConstantExpression*>(constExp)->value();
+            if (!isSupportedConstant(value)) {
+                return false;
+            }
+
+            Instruction ins;
+            switch (exp->kind()) {
+                case Expression::Kind::kRelEQ:
+                    ins.op = OpCode::kEQ;
+                    break;
+                case Expression::Kind::kRelNE:
+                    ins.op = OpCode::kNE;
+                    break;
+                case Expression::Kind::kRelLT:
+                    ins.op = flipped ? OpCode::kGT : OpCode::kLT;
+                    break;
+                case Expression::Kind::kRelLE:
+                    ins.op = flipped ? OpCode::kGE : OpCode::kLE;
+                    break;
+                case Expression::Kind::kRelGT:
+                    ins.op = flipped ? OpCode::kLT : OpCode::kGT;
+                    break;
+                default:
+                    ins.op = flipped ? OpCode::kLE : OpCode::kGE;
+                    break;
+            }
+            // bool is only compared by equality
+            if (value.type() == Value::Type::BOOL &&
+                ins.op != OpCode::kEQ && ins.op != OpCode::kNE) {
+                return false;
+            }
+            if (!compileProp(propExp, ins.prop)) {
+                return false;
+            }
+            ins.type = value.type();
+            switch (value.type()) {
+                case Value::Type::INT:
+                    ins.intVal = value.getInt();
+                    break;
+                case Value::Type::FLOAT:
+                    ins.floatVal = value.getFloat();
+                    break;
+                case Value::Type::STRING:
+                    ins.strVal = value.getStr();
+                    break;
+                default:
+                    ins.boolVal = value.getBool();
+                    break;
+            }
+            program_.emplace_back(std::move(ins));
+            return true;
+        }
+        case Expression::Kind::kRelIn:
+        case Expression::Kind::kRelNotIn: {
+            auto* relExp = static_cast<const RelationalExpression*>(exp);
+            Instruction ins;
+            ins.op = exp->kind() == Expression::Kind::kRelIn ? OpCode::kIn : OpCode::kNotIn;
+            if (!compileProp(relExp->left(), ins.prop)) {
+                return false;
+            }
+            // the list is either a constant or a list expression of constants
+            std::vector<Value> items;
+            auto* right = relExp->right();
+            if (right->kind() == Expression::Kind::kConstant) {
+                const auto& value = static_cast<const ConstantExpression*>(right)->value();
+                if (value.type() != Value::Type::LIST) {
+                    return false;
+                }
+                items = value.getList().values;
+            } else if (right->kind() == Expression::Kind::kList) {
+                auto* listExp = static_cast<const ListExpression*>(right);
+                for (auto& item : listExp->items()) {
+                    if (item->kind() != Expression::Kind::kConstant) {
+                        return false;
+                    }
+                    items.emplace_back(static_cast<const ConstantExpression*>(item)->value());
+                }
+            } else {
+                return false;
+            }
+            // All items must be of the same type, so the prop matches either all or none of them
+            if (items.empty()) {
+                return false;
+            }
+            ins.type = items.front().type();
+            for (auto& item : items) {
+                if (!isSupportedConstant(item) || item.type() != ins.type) {
+                    return false;
+                }
+                ins.items.emplace(std::move(item));
+            }
+            program_.emplace_back(std::move(ins));
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool FilterProgram::compileProp(const Expression* exp, size_t& prop) {
+    bool isSrc = false;
+    switch (exp->kind()) {
+        case Expression::Kind::kEdgeProperty: {
+            if (!isEdge_) {
+                return false;
+            }
+            auto* propExp = static_cast<const PropertyExpression*>(exp);
+            const auto& name = propExp->prop();
+            // the props in the key are not read from the row
+            if (name == kSrc || name == kDst || name == kRank || name == kType) {
+                return false;
+            }
+            break;
+        }
+        case Expression::Kind::kTagProperty:
+        case Expression::Kind::kSrcProperty: {
+            auto* propExp = static_cast<const PropertyExpression*>(exp);
+            const auto& name = propExp->prop();
+            if (name == kVid || name == kTag) {
+                return false;
+            }
+            isSrc = isEdge_;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    auto* propExp = static_cast<const PropertyExpression*>(exp);
+    for (size_t i = 0; i < props_.size(); i++) {
+        if (props_[i].isSrc == isSrc &&
+            props_[i].sym == propExp->sym() &&
+            props_[i].name == propExp->prop()) {
+            prop = i;
+            return true;
+        }
+    }
+    prop = props_.size();
+    props_.emplace_back(Prop{isSrc, propExp->sym(), propExp->prop()});
+    return true;
+}
+
+const FilterProgram::Binding* FilterProgram::bind(const std::string& name,
+                                                  const meta::SchemaProviderIf* schema,
+                                                  const meta::SchemaProviderIf* rowSchema) {
+    if (rowSchema == lastSchema_) {
+        return lastBinding_;
+    }
+    auto iter = bindings_.find(rowSchema);
+    if (iter == bindings_.end()) {
+        // The same as StorageExpressionContext::readValue, only the prop of the tag or edge in
+        // the latest schema could be read from the row
+        Binding binding;
+        binding.slots.resize(props_.size(), -1);
+        std::vector<std::string> names;
+        for (size_t i = 0; i < props_.size(); i++) {
+            const auto& prop = props_[i];
+            if (prop.isSrc || prop.sym != name || schema == nullptr ||
+                schema->field(prop.name) == nullptr) {
+                continue;
+            }
+            binding.slots[i] = names.size();
+            names.emplace_back(prop.name);
+        }
+        if (!names.empty()) {
+            binding.projection = std::make_unique<RowProjection>(rowSchema, names);
+        }
+        iter = bindings_.emplace(rowSchema, std::move(binding)).first;
+    }
+    lastSchema_ = rowSchema;
+    lastBinding_ = &iter->second;
+    return lastBinding_;
+}
+
+void FilterProgram::bindSrcProps(const StorageExpressionContext& expCtx) {
+    for (size_t i = 0; i < props_.size(); i++) {
+        if (props_[i].isSrc) {
+            srcValues_[i] = expCtx.getSrcProp(props_[i].sym, props_[i].name);
+        }
+    }
+}
+
+FilterProgram::Result FilterProgram::check(const std::string& name,
+                                           const meta::SchemaProviderIf* schema,
+                                           RowReader* reader,
+                                           folly::StringPiece row) {
+    if (reader == nullptr || reader->readerVer() != 2) {
+        return Result::kUnknown;
+    }
+    auto* binding = bind(name, schema, reader->getSchema());
+    if (binding->projection != nullptr && !binding->projection->decode(row, values_)) {
+        return Result::kUnknown;
+    }
+
+    stack_.clear();
+    for (const auto& ins : program_) {
+        switch (ins.op) {
+            case OpCode::kAnd:
+            case OpCode::kOr:
+            case OpCode::kNot: {
+                DCHECK(!stack_.empty());
+                if (ins.op == OpCode::kNot) {
+                    stack_.back() = !stack_.back();
+                    break;
+                }
+                DCHECK_GE(stack_.size(), 2);
+                bool right = stack_.back();
+                stack_.pop_back();
+                if (ins.op == OpCode::kAnd) {
+                    stack_.back() = stack_.back() && right;
+                } else {
+                    stack_.back() = stack_.back() || right;
+                }
+                break;
+            }
+            default: {
+                const Value* value = nullptr;
+                if (props_[ins.prop].isSrc) {
+                    value = &srcValues_[ins.prop];
+                } else {
+                    auto slot = binding->slots[ins.prop];
+                    if (slot < 0) {
+                        return Result::kUnknown;
+                    }
+                    value = &values_[slot];
+                }
+                auto ret = compare(ins, *value);
+                if (ret == Result::kUnknown) {
+                    return Result::kUnknown;
+                }
+                stack_.emplace_back(ret == Result::kTrue);
+                break;
+            }
+        }
+    }
+    DCHECK_EQ(1, stack_.size());
+    return stack_.back() ? Result::kTrue : Result::kFalse;
+}
+
+FilterProgram::Result FilterProgram::compare(const Instruction& ins, const Value& value) const {
+    auto toResult = [] (bool b) {
+        return b ? Result::kTrue : Result::kFalse;
+    };
+    if (value.isNull()) {
+        // A missing prop may have a default value, and the comparisons with null are null,
+        // leave them to the expression
+        if (value.getNull() != NullType::__NULL__) {
+            return Result::kUnknown;
+        }
+        switch (ins.op) {
+            case OpCode::kIsNull:
+                return Result::kTrue;
+            case OpCode::kIsNotNull:
+                return Result::kFalse;
+            default:
+                return Result::kUnknown;
+        }
+    }
+    if (value.empty()) {
+        return Result::kUnknown;
+    }
+    if (ins.op == OpCode::kIsNull) {
+        return Result::kFalse;
+    }
+    if (ins.op == OpCode::kIsNotNull) {
+        return Result::kTrue;
+    }
+    if (value.type() != ins.type) {
+        return Result::kUnknown;
+    }
+    if (ins.op == OpCode::kIn || ins.op == OpCode::kNotIn) {
+        if (value.type() == Value::Type::FLOAT && std::isnan(value.getFloat())) {
+            return Result::kUnknown;
+        }
+        bool found = ins.items.find(value) != ins.items.end();
+        return toResult(ins.op == OpCode::kIn ? found : !found);
+    }
+
+    // -1, 0, 1 for less, equal and greater than the constant
+    int cmp = 0;
+    switch (ins.type) {
+        case Value::Type::INT: {
+            auto v = value.getInt();
+            cmp = v < ins.intVal ? -1 : (v > ins.intVal ? 1 : 0);
+            break;
+        }
+        case Value::Type::FLOAT: {
+            auto v = value.getFloat();
+            if (std::isnan(v)) {
+                return Result::kUnknown;
+            }
+            cmp = v < ins.floatVal ? -1 : (v > ins.floatVal ? 1 : 0);
+            break;
+        }
+        case Value::Type::STRING: {
+            auto c = value.getStr().compare(ins.strVal);
+            cmp = c < 0 ? -1 : (c > 0 ? 1 : 0);
+            break;
+        }
+        case Value::Type::BOOL:
+            cmp = value.getBool() == ins.boolVal ? 0 : 1;
+            break;
+        default:
+            return Result::kUnknown;
+    }
+    switch (ins.op) {
+        case OpCode::kEQ:
+            return toResult(cmp == 0);
+        case OpCode::kNE:
+            return toResult(cmp != 0);
+        case OpCode::kLT:
+            return toResult(cmp < 0);
+        case OpCode::kLE:
+            return toResult(cmp <= 0);
+        case OpCode::kGT:
+            return toResult(cmp > 0);
+        case OpCode::kGE:
+            return toResult(cmp >= 0);
+        default:
+            return Result::kUnknown;
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
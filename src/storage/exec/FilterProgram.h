@@ -0,0 +1,128 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_EXEC_FILTERPROGRAM_H_
+#define STORAGE_EXEC_FILTERPROGRAM_H_
+
+#include "common/base/Base.h"
+#include "common/expression/Expression.h"
+#include "codec/RowReader.h"
+#include "codec/RowProjection.h"
+#include "storage/context/StorageExpressionContext.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * FilterProgram is compiled from the common predicate shapes of a filter expression:
+ * comparisons between a prop and an int, double, string or bool constant, IN / NOT IN a list of
+ * constants, IS NULL / IS NOT NULL of a prop, and AND / OR / NOT of them. The tree is flattened
+ * into a postfix program over a stack of bool, with the constants already typed. The props of a
+ * row are decoded by a RowProjection, which is built once for each schema version, so checking a
+ * row needs neither the virtual eval of expressions nor the prop map of the expression context.
+ *
+ * The program only decides a row when all props it reads are present, and either null for the
+ * null checks or of the same type as the constants, where the result is exactly the same as the
+ * expression. Otherwise it returns kUnknown, and the caller falls back to the expression.
+ *
+ * The bindings are cached by the schema of the row, which is assumed to identify the tag or edge.
+ * */
+class FilterProgram final {
+public:
+    enum class Result : uint8_t {
+        kFalse      = 0,
+        kTrue       = 1,
+        kUnknown    = 2,
+    };
+
+    // Return nullptr if any part of the expression is not supported. If isEdge, the props of a
+    // row are `edge.prop`, and `$^.tag.prop` or `tag.prop` are props of the src vertex which are
+    // bound by bindSrcProps. Otherwise the props of a row are `tag.prop` or `$^.tag.prop`.
+    static std::unique_ptr<FilterProgram> compile(const Expression* exp, bool isEdge);
+
+    // Check the row of the tag or edge `name', with `schema' as its latest schema
+    Result check(const std::string& name,
+                 const meta::SchemaProviderIf* schema,
+                 RowReader* reader,
+                 folly::StringPiece row);
+
+    // Read the props of the src vertex from the expression context, it should be called once the
+    // tag props of a vertex have been set into the context
+    void bindSrcProps(const StorageExpressionContext& expCtx);
+
+private:
+    enum class OpCode : uint8_t {
+        kEQ,
+        kNE,
+        kLT,
+        kLE,
+        kGT,
+        kGE,
+        kIn,
+        kNotIn,
+        kIsNull,
+        kIsNotNull,
+        kAnd,
+        kOr,
+        kNot,
+    };
+
+    struct Prop {
+        // prop of the src vertex, not of the row
+        bool            isSrc;
+        std::string     sym;
+        std::string     name;
+    };
+
+    struct Instruction {
+        OpCode                      op;
+        // index in props_ for comparisons and null checks
+        size_t                      prop{0};
+        // type of the constants, the prop must be of the same type
+        Value::Type                 type{Value::Type::__EMPTY__};
+        int64_t                     intVal{0};
+        double                      floatVal{0};
+        std::string                 strVal;
+        bool                        boolVal{false};
+        std::unordered_set<Value>   items;
+    };
+
+    struct Binding {
+        // decode the props of the row, nullptr if none of the props is in the row
+        std::unique_ptr<RowProjection>  projection;
+        // index of each prop in the decoded values, -1 if not a prop of the row
+        std::vector<int32_t>            slots;
+    };
+
+    explicit FilterProgram(bool isEdge) : isEdge_(isEdge) {}
+
+    bool compileExp(const Expression* exp);
+
+    bool compileProp(const Expression* exp, size_t& prop);
+
+    const Binding* bind(const std::string& name,
+                        const meta::SchemaProviderIf* schema,
+                        const meta::SchemaProviderIf* rowSchema);
+
+    Result compare(const Instruction& ins, const Value& value) const;
+
+    bool                                isEdge_;
+    std::vector<Prop>                   props_;
+    std::vector<Instruction>            program_;
+
+    std::unordered_map<const meta::SchemaProviderIf*, Binding> bindings_;
+    const meta::SchemaProviderIf*       lastSchema_{nullptr};
+    const Binding*                      lastBinding_{nullptr};
+
+    // buffers reused for each row
+    std::vector<Value>                  values_;
+    std::vector<Value>                  srcValues_;
+    std::vector<char>                   stack_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_EXEC_FILTERPROGRAM_H_
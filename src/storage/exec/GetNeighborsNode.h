@@ -20,22 +20,35 @@ namespace storage {
 // GetNeighborsNode will generate a row in response of GetNeighbors, so it need to get the tag
 // result from HashJoinNode, and the stat info and edge iterator from AggregateNode. Then collect
 // some edge props, and put them into the target cell of a row.
+//
+// If superVertices is given, the iteration of a vertex stops once super_vertex_threshold edges
+// are met, the row of the vertex is left as a placeholder, and its index in the result and the
+// vertex id are recorded in superVertices, so that the edges could be scanned again in parallel.
+//
+// If edgeBudget is given, it is the number of edges the whole response could still hold, which is
+// shared by the plans of all parts. Once it is used up, the vertex fails with E_PARTIAL_RESULT
+// instead of materializing more edges.
 class GetNeighborsNode : public QueryNode<VertexID> {
 public:
     using RelNode::execute;
+    using SuperVertices = std::vector<std::pair<size_t, VertexID>>;
 
     GetNeighborsNode(RunTimeContext* context,
                      IterateNode<VertexID>* hashJoinNode,
                      IterateNode<VertexID>* upstream,
                      EdgeContext* edgeContext,
                      nebula::DataSet* resultDataSet,
-                     int64_t limit = 0)
+                     int64_t limit = 0,
+                     SuperVertices* superVertices = nullptr,
+                     std::atomic<int64_t>* edgeBudget = nullptr)
         : context_(context)
         , hashJoinNode_(hashJoinNode)
         , upstream_(upstream)
         , edgeContext_(edgeContext)
         , resultDataSet_(resultDataSet)
-        , limit_(limit) {}
+        , limit_(limit)
+        , superVertices_(superVertices)
+        , edgeBudget_(edgeBudget) {}
 
     nebula::cpp2::ErrorCode execute(PartitionID partId, const VertexID& vId) override {
         auto ret = RelNode::execute(partId, vId);
@@ -65,10 +78,16 @@ public:
         // add default null for each edge node and the last column of yield expression
         row.resize(row.size() + edgeContext_->propContexts_.size() + 1, Value());
 
+        isSuperVertex_ = false;
         ret = iterateEdges(row);
         if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
             return ret;
         }
+        if (isSuperVertex_) {
+            superVertices_->emplace_back(resultDataSet_->rows.size(), vId);
+            resultDataSet_->rows.emplace_back(std::move(row));
+            return nebula::cpp2::ErrorCode::SUCCEEDED;
+        }
 
         if (edgeContext_->statCount_ > 0) {
             auto agg = dynamic_cast<AggregateNode<VertexID>*>(upstream_);
@@ -92,6 +111,11 @@ protected:
             if (edgeRowCount >= limit_) {
                 return nebula::cpp2::ErrorCode::SUCCEEDED;
             }
+            if (edgeBudget_ != nullptr &&
+                edgeBudget_->fetch_sub(1, std::memory_order_relaxed) <= 0) {
+                VLOG(1) << "Too many edges in the response, the vertex is not finished";
+                return nebula::cpp2::ErrorCode::E_PARTIAL_RESULT;
+            }
             auto key = upstream_->key();
             auto reader = upstream_->reader();
             auto props = context_->props_;
@@ -100,7 +124,8 @@ protected:
             list.reserve(props->size());
             // collect props need to return
             if (!QueryUtils::collectEdgeProps(key, context_->vIdLen(), context_->isIntId(),
-                                              reader, props, list).ok()) {
+                                              upstream_->val(), projection(reader, props),
+                                              values_, reader, props, list).ok()) {
                 return nebula::cpp2::ErrorCode::E_EDGE_PROP_NOT_FOUND;
             }
 
@@ -110,16 +135,48 @@ protected:
             }
             auto& cell = row[columnIdx].mutableList();
             cell.values.emplace_back(std::move(list));
+
+            if (superVertices_ != nullptr &&
+                edgeRowCount + 1 >= FLAGS_super_vertex_threshold &&
+                edgeRowCount + 1 < limit_) {
+                isSuperVertex_ = true;
+                return nebula::cpp2::ErrorCode::SUCCEEDED;
+            }
         }
         return nebula::cpp2::ErrorCode::SUCCEEDED;
     }
 
+    // The projection of the props is built once for each schema version of each edge type,
+    // return nullptr if the row is not encoded by RowWriterV2
+    const RowProjection* projection(RowReader* reader, const std::vector<PropContext>* props) {
+        if (reader == nullptr || reader->readerVer() != 2) {
+            return nullptr;
+        }
+        auto key = std::make_pair(reader->getSchema(), props);
+        auto iter = projections_.find(key);
+        if (iter == projections_.end()) {
+            iter = projections_.emplace(key,
+                                        QueryUtils::buildProjection(key.first, props)).first;
+        }
+        return iter->second.get();
+    }
+
     RunTimeContext* context_;
     IterateNode<VertexID>* hashJoinNode_;
     IterateNode<VertexID>* upstream_;
     EdgeContext* edgeContext_;
     nebula::DataSet* resultDataSet_;
     int64_t limit_;
+    SuperVertices* superVertices_{nullptr};
+    bool isSuperVertex_{false};
+    std::atomic<int64_t>* edgeBudget_{nullptr};
+
+    std::unordered_map<std::pair<const meta::SchemaProviderIf*, const std::vector<PropContext>*>,
+                       std::unique_ptr<RowProjection>,
+                       folly::hasher<std::pair<const meta::SchemaProviderIf*,
+                                               const std::vector<PropContext>*>>> projections_;
+    // buffer of the decoded props of an edge
+    std::vector<Value> values_;
 };
 
 class GetNeighborsSampleNode : public GetNeighborsNode {
@@ -56,20 +56,24 @@ public:
             edges.emplace_back(std::move(edge));
             iter->next();
         }
-        for (const auto& edge : edges) {
-            auto prefix = NebulaKeyUtils::edgePrefix(context_->vIdLen(),
-                                                     partId,
-                                                     (*edge.src_ref()).getStr(),
-                                                     context_->edgeType_,
-                                                     edge.get_ranking(),
-                                                     (*edge.dst_ref()).getStr());
-            std::unique_ptr<kvstore::KVIterator> eIter;
-            ret = context_->env()->kvstore_->prefix(context_->spaceId(),
-                                                       partId, prefix, &eIter);
-            if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && eIter && eIter->valid()) {
-                data_.emplace_back(eIter->key(), eIter->val());
-            } else {
-                return ret;
+        // The rows are fetched by their exact keys with multiGet in batches
+        size_t batchSize = std::max(FLAGS_index_fetch_batch_size, 1);
+        std::vector<std::string> keys;
+        keys.reserve(std::min(batchSize, edges.size()));
+        data_.reserve(edges.size());
+        for (size_t i = 0; i < edges.size(); i++) {
+            const auto& edge = edges[i];
+            keys.emplace_back(NebulaKeyUtils::edgeKey(context_->vIdLen(),
+                                                      partId,
+                                                      (*edge.src_ref()).getStr(),
+                                                      context_->edgeType_,
+                                                      edge.get_ranking(),
+                                                      (*edge.dst_ref()).getStr()));
+            if (keys.size() >= batchSize || i + 1 == edges.size()) {
+                ret = fetchBatch(partId, keys, edges, i + 1 - keys.size());
+                if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    return ret;
+                }
             }
         }
         return nebula::cpp2::ErrorCode::SUCCEEDED;
@@ -88,6 +92,47 @@ public:
     }
 
 private:
+    // Read the rows of keys, which are the edges starting from edges[first], and clear the batch
+    nebula::cpp2::ErrorCode fetchBatch(PartitionID partId,
+                                       std::vector<std::string>& keys,
+                                       const std::vector<storage::cpp2::EdgeKey>& edges,
+                                       size_t first) {
+        std::vector<std::string> values;
+        auto ret = context_->env()->kvstore_->multiGet(context_->spaceId(),
+                                                       partId,
+                                                       keys,
+                                                       &values);
+        if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+            ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+            return ret.first;
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (ret.second[i].ok()) {
+                data_.emplace_back(std::move(keys[i]), std::move(values[i]));
+                continue;
+            }
+            // The edge may be written with another version, find it by the prefix
+            const auto& edge = edges[first + i];
+            auto prefix = NebulaKeyUtils::edgePrefix(context_->vIdLen(),
+                                                     partId,
+                                                     (*edge.src_ref()).getStr(),
+                                                     context_->edgeType_,
+                                                     edge.get_ranking(),
+                                                     (*edge.dst_ref()).getStr());
+            std::unique_ptr<kvstore::KVIterator> eIter;
+            auto code = context_->env()->kvstore_->prefix(context_->spaceId(),
+                                                          partId, prefix, &eIter);
+            if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                return code;
+            }
+            if (eIter && eIter->valid()) {
+                data_.emplace_back(eIter->key(), eIter->val());
+            }
+        }
+        keys.clear();
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
     RunTimeContext*                                                       context_;
     IndexScanNode<T>*                                                     indexScanNode_;
     const std::vector<std::shared_ptr<const meta::NebulaSchemaProvider>>& schemas_;
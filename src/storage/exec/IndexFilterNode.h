@@ -9,7 +9,9 @@
 #include "common/base/Base.h"
 #include "common/expression/Expression.h"
 #include "common/context/ExpressionContext.h"
+#include "storage/StorageFlags.h"
 #include "storage/exec/RelNode.h"
+#include "storage/exec/FilterProgram.h"
 
 namespace nebula {
 namespace storage {
@@ -40,6 +42,7 @@ public:
         , filterExp_(exp) {
         evalExprByIndex_ = false;
         isEdge_ = true;
+        compileFilter();
     }
 
     // evalExprByIndex_ is false, some fileds in filter is out of index, which need to read data.
@@ -51,6 +54,7 @@ public:
         , filterExp_(exp) {
         evalExprByIndex_ = false;
         isEdge_ = false;
+        compileFilter();
     }
 
     nebula::cpp2::ErrorCode execute(PartitionID partId) override {
@@ -79,7 +83,7 @@ public:
                 if (!reader) {
                     continue;
                 }
-                if (check(reader.get(), k.first)) {
+                if (check(reader.get(), k.first, k.second)) {
                     data_.emplace_back(k.first, k.second);
                 }
             }
@@ -118,8 +122,20 @@ private:
         return false;
     }
 
-    bool check(RowReader* reader, const std::string& raw) {
+    void compileFilter() {
+        if (FLAGS_enable_filter_program && filterExp_ != nullptr && exprCtx_ != nullptr) {
+            program_ = FilterProgram::compile(filterExp_, isEdge_);
+        }
+    }
+
+    bool check(RowReader* reader, const std::string& raw, const std::string& row) {
         if (filterExp_ != nullptr) {
+            if (program_ != nullptr) {
+                auto result = program_->check(exprCtx_->name(), exprCtx_->schema(), reader, row);
+                if (result != FilterProgram::Result::kUnknown) {
+                    return result == FilterProgram::Result::kTrue;
+                }
+            }
             exprCtx_->reset(reader, raw);
             auto result = filterExp_->eval(*exprCtx_);
             if (result.type() == Value::Type::BOOL) {
@@ -139,6 +155,8 @@ private:
     Expression                                        *filterExp_;
     bool                                              isEdge_;
     bool                                              evalExprByIndex_;
+    // only used when reading the data
+    std::unique_ptr<FilterProgram>                    program_;
     std::vector<kvstore::KV>                          data_{};
 };
 
@@ -119,11 +119,11 @@ private:
                 VLOG(3) << "Field " << col.get_column_name() << " not found ";
                 return Status::Error("Field not found");
             }
-            auto type = IndexKeyUtils::toValueType(iter->type.type);
-            if (type == Value::Type::STRING && !iter->type.type_length_ref().has_value()) {
+            if (iter->get_type().get_type() == meta::cpp2::PropertyType::FIXED_STRING &&
+                !iter->get_type().type_length_ref().has_value()) {
                 return Status::Error("String property index has not set prefix length.");
             }
-            prefix.append(encodeValue(*col.begin_value_ref(), type, iter->type.get_type_length()));
+            prefix.append(encodeValue(*col.begin_value_ref(), *iter));
         }
         return std::make_pair(prefix, "");
     }
@@ -141,31 +141,31 @@ private:
                 VLOG(3) << "Field " << col.get_column_name() << " not found ";
                 return Status::Error("Field not found");
             }
-            auto type = IndexKeyUtils::toValueType(iter->get_type().get_type());
-            if (type == Value::Type::STRING && !iter->get_type().type_length_ref().has_value()) {
+            if (iter->get_type().get_type() == meta::cpp2::PropertyType::FIXED_STRING &&
+                !iter->get_type().type_length_ref().has_value()) {
                 return Status::Error("String property index has not set prefix length.");
             }
             if (col.get_scan_type() == cpp2::ScanType::PREFIX) {
-                start.append(encodeValue(*col.begin_value_ref(),
-                            type, iter->type.get_type_length()));
-                end.append(encodeValue(*col.begin_value_ref(),
-                            type, iter->type.get_type_length()));
+                start.append(encodeValue(*col.begin_value_ref(), *iter));
+                end.append(encodeValue(*col.begin_value_ref(), *iter));
             } else {
-                start.append(encodeValue(*col.begin_value_ref(),
-                            type, iter->type.get_type_length()));
-                end.append(encodeValue(*col.end_value_ref(),
-                            type, iter->type.get_type_length()));
+                start.append(encodeValue(*col.begin_value_ref(), *iter));
+                end.append(encodeValue(*col.end_value_ref(), *iter));
             }
         }
         return std::make_pair(start, end);
     }
 
-    // precondition: if type is STRING, strLen must be valid
-    std::string encodeValue(const Value& val, Value::Type type, const int16_t* strLen) {
+    // Encode the value the same way as the column in the index key
+    std::string encodeValue(const Value& val, const meta::cpp2::ColumnDef& field) {
+        auto type = IndexKeyUtils::toValueType(field.get_type().get_type());
+        const auto* strLen = field.get_type().get_type_length();
         if (val.isNull()) {
             return IndexKeyUtils::encodeNullValue(type, strLen);
         }
-        if (type == Value::Type::STRING) {
+        if (type == Value::Type::STRING && IndexKeyUtils::isFullString(field)) {
+            return IndexKeyUtils::encodeString(val.getStr());
+        } else if (type == Value::Type::STRING) {
             return IndexKeyUtils::encodeValue(val, *strLen);
         } else {
             return IndexKeyUtils::encodeValue(val);
@@ -54,33 +54,56 @@ public:
             vids.emplace_back(iter->vId());
             iter->next();
         }
+        // The rows are fetched by multiGet in batches, the rows in the cache take their slots
+        // in data_ as well to keep the order of the index
+        size_t batchSize = std::max(FLAGS_index_fetch_batch_size, 1);
+        std::vector<std::string> keys;
+        std::vector<size_t> slots;
+        std::vector<bool> found;
+        keys.reserve(std::min(batchSize, vids.size()));
+        slots.reserve(std::min(batchSize, vids.size()));
+        data_.reserve(vids.size());
+        found.reserve(vids.size());
         for (const auto& vId : vids) {
             VLOG(1) << "partId " << partId << ", vId " << vId << ", tagId " << context_->tagId_;
+            auto vertexKey = NebulaKeyUtils::vertexKey(context_->vIdLen(),
+                                                       partId,
+                                                       vId,
+                                                       context_->tagId_);
             if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
                 auto result = vertexCache_->get(std::make_pair(vId, context_->tagId_));
                 if (result.ok()) {
-                    auto vertexKey = NebulaKeyUtils::vertexKey(context_->vIdLen(),
-                                                               partId,
-                                                               vId,
-                                                               context_->tagId_);
                     data_.emplace_back(std::move(vertexKey), std::move(result).value());
+                    found.emplace_back(true);
                     continue;
                 } else {
                     VLOG(1) << "Miss cache for vId " << vId << ", tagId " << context_->tagId_;
                 }
             }
 
-            std::unique_ptr<kvstore::KVIterator> vIter;
-            auto prefix = NebulaKeyUtils::vertexPrefix(context_->vIdLen(), partId,
-                                                       vId, context_->tagId_);
-            ret = context_->env()->kvstore_->prefix(context_->spaceId(),
-                                                       partId, prefix, &vIter);
-            if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && vIter && vIter->valid()) {
-                data_.emplace_back(vIter->key(), vIter->val());
-            } else {
+            slots.emplace_back(data_.size());
+            keys.emplace_back(vertexKey);
+            data_.emplace_back(std::move(vertexKey), "");
+            found.emplace_back(false);
+            if (keys.size() >= batchSize) {
+                ret = fetchBatch(partId, keys, slots, found);
+                if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    return ret;
+                }
+            }
+        }
+        if (!keys.empty()) {
+            ret = fetchBatch(partId, keys, slots, found);
+            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
                 return ret;
             }
         }
+
+        // Skip the index hits whose row is not found
+        size_t idx = 0;
+        data_.erase(std::remove_if(data_.begin(), data_.end(), [&found, &idx] (const auto&) {
+            return !found[idx++];
+        }), data_.end());
         return nebula::cpp2::ErrorCode::SUCCEEDED;
     }
 
@@ -97,6 +120,31 @@ public:
     }
 
 private:
+    // Read the rows of keys into their slots of data_, and clear the batch
+    nebula::cpp2::ErrorCode fetchBatch(PartitionID partId,
+                                       std::vector<std::string>& keys,
+                                       std::vector<size_t>& slots,
+                                       std::vector<bool>& found) {
+        std::vector<std::string> values;
+        auto ret = context_->env()->kvstore_->multiGet(context_->spaceId(),
+                                                       partId,
+                                                       keys,
+                                                       &values);
+        if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+            ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+            return ret.first;
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (ret.second[i].ok()) {
+                data_[slots[i]].second = std::move(values[i]);
+                found[slots[i]] = true;
+            }
+        }
+        keys.clear();
+        slots.clear();
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
     RunTimeContext*                                                       context_;
     VertexCache*                                                          vertexCache_;
     IndexScanNode<T>*                                                     indexScanNode_;
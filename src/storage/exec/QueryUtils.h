@@ -9,7 +9,9 @@
 
 #include "common/base/Base.h"
 #include "common/expression/Expression.h"
+#include "codec/RowProjection.h"
 #include "storage/CommonUtils.h"
+#include "storage/context/RequestTrace.h"
 #include "storage/query/QueryBaseProcessor.h"
 #include "utils/DefaultValueContext.h"
 
@@ -49,7 +51,14 @@ public:
     static StatusOr<nebula::Value> readValue(RowReader* reader,
                                              const std::string& propName,
                                              const meta::SchemaProviderIf::Field* field) {
-        auto value = reader->getValueByName(propName);
+        return checkValue(reader->getValueByName(propName), propName, field);
+    }
+
+    // If the value read from the row is null, check whether the field is nullable, or fill the
+    // default value of the field when the prop is not in the row
+    static StatusOr<nebula::Value> checkValue(nebula::Value value,
+                                              const std::string& propName,
+                                              const meta::SchemaProviderIf::Field* field) {
         if (value.type() == Value::Type::NULLVALUE) {
             // read null value
             auto nullType = value.getNull();
@@ -163,6 +172,7 @@ public:
                                      RowReader* reader,
                                      const std::vector<PropContext>* props,
                                      nebula::List& list) {
+        ScopedTrace decode(RequestTrace::kDecode);
         for (const auto& prop : *props) {
             if (prop.returned_) {
                 VLOG(2) << "Collect prop " << prop.name_;
@@ -182,6 +192,7 @@ public:
                                    RowReader* reader,
                                    const std::vector<PropContext>* props,
                                    nebula::List& list) {
+        ScopedTrace decode(RequestTrace::kDecode);
         for (const auto& prop : *props) {
             if (prop.returned_) {
                 VLOG(2) << "Collect prop " << prop.name_;
@@ -195,6 +206,57 @@ public:
         return Status::OK();
     }
 
+    // Build the projection of the returned props in value, which is used by collectEdgeProps
+    static std::unique_ptr<RowProjection> buildProjection(const meta::SchemaProviderIf* schema,
+                                                          const std::vector<PropContext>* props) {
+        std::vector<std::string> names;
+        for (const auto& prop : *props) {
+            if (prop.returned_ && prop.propInKeyType_ == PropContext::PropInKeyType::NONE) {
+                names.emplace_back(prop.name_);
+            }
+        }
+        return std::make_unique<RowProjection>(schema, names);
+    }
+
+    // Same as the one above, but the props in value are decoded by the projection built with
+    // buildProjection in one pass, the values are only a buffer which could be reused. Fall back
+    // to the reader if the projection could not decode the row.
+    static Status collectEdgeProps(folly::StringPiece key,
+                                   size_t vIdLen,
+                                   bool isIntId,
+                                   folly::StringPiece row,
+                                   const RowProjection* projection,
+                                   std::vector<nebula::Value>& values,
+                                   RowReader* reader,
+                                   const std::vector<PropContext>* props,
+                                   nebula::List& list) {
+        if (projection == nullptr || !projection->decode(row, values)) {
+            return collectEdgeProps(key, vIdLen, isIntId, reader, props, list);
+        }
+        ScopedTrace decode(RequestTrace::kDecode);
+        size_t idx = 0;
+        for (const auto& prop : *props) {
+            if (!prop.returned_) {
+                continue;
+            }
+            VLOG(2) << "Collect prop " << prop.name_;
+            if (prop.propInKeyType_ == PropContext::PropInKeyType::NONE) {
+                auto value = checkValue(std::move(values[idx++]), prop.name_, prop.field_);
+                if (!value.ok()) {
+                    return value.status();
+                }
+                list.emplace_back(std::move(value).value());
+            } else {
+                auto value = QueryUtils::readEdgeProp(key, vIdLen, isIntId, reader, prop);
+                if (!value.ok()) {
+                    return value.status();
+                }
+                list.emplace_back(std::move(value).value());
+            }
+        }
+        return Status::OK();
+    }
+
     // return none if no valid ttl, else return the ttl property name and time
     static folly::Optional<std::pair<std::string, int64_t>>
     getEdgeTTLInfo(EdgeContext* edgeContext, EdgeType edgeType) {
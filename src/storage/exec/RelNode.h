@@ -54,6 +54,17 @@ public:
         return nebula::cpp2::ErrorCode::SUCCEEDED;
     }
 
+    // Called before a batch of input of the same part is executed one by one, so the node could
+    // read the data of the whole batch at once. Each input of the batch is still passed to
+    // `execute` in order, and `endBatch` is called after the batch is done.
+    virtual nebula::cpp2::ErrorCode beginBatch(PartitionID partId, const std::vector<T>& input) {
+        UNUSED(partId);
+        UNUSED(input);
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    virtual void endBatch() {}
+
     void addDependency(RelNode<T>* dep) {
         dependencies_.emplace_back(dep);
         dep->hasDependents_ = true;
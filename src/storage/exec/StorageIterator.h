@@ -11,6 +11,7 @@
 #include "kvstore/KVIterator.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
+#include "storage/context/RequestTrace.h"
 
 namespace nebula {
 namespace storage {
@@ -102,6 +103,7 @@ public:
 protected:
     // return true when the value iter to a valid edge value
     bool check() {
+        RequestTrace::countKey(iter_->key().size() + iter_->val().size());
         reader_.reset(*schemas_, iter_->val());
         if (!reader_) {
             context_->resultStat_ = ResultStatus::ILLEGAL_DATA;
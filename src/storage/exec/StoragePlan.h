@@ -10,6 +10,7 @@
 #include "common/base/Base.h"
 #include "storage/exec/RelNode.h"
 #include "storage/CommonUtils.h"
+#include "storage/StorageFlags.h"
 
 namespace nebula {
 namespace storage {
@@ -52,6 +53,37 @@ public:
         return nodes_[outputIdx_]->execute(partId, input);
     }
 
+    // Execute the input of the same part in batches of query_batch_size. All nodes get the
+    // whole batch by `beginBatch` first, then the input of the batch is executed one by one.
+    // A failed input doesn't stop the others, the same as executing them one by one, and the
+    // first failure is returned. Only the failure of `beginBatch` stops the whole part.
+    nebula::cpp2::ErrorCode go(PartitionID partId, const std::vector<T>& input) {
+        auto code = nebula::cpp2::ErrorCode::SUCCEEDED;
+        if (FLAGS_query_batch_size <= 0) {
+            for (const auto& row : input) {
+                auto ret = go(partId, row);
+                if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    code = ret;
+                }
+            }
+            return code;
+        }
+        size_t batchSize = FLAGS_query_batch_size;
+        if (input.size() <= batchSize) {
+            auto ret = goBatch(partId, input, &code);
+            return ret != nebula::cpp2::ErrorCode::SUCCEEDED ? ret : code;
+        }
+        for (size_t start = 0; start < input.size(); start += batchSize) {
+            auto end = std::min(start + batchSize, input.size());
+            std::vector<T> batch(input.begin() + start, input.begin() + end);
+            auto ret = goBatch(partId, batch, &code);
+            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                return ret;
+            }
+        }
+        return code;
+    }
+
     nebula::cpp2::ErrorCode go(PartitionID partId) {
         // find all leaf nodes, and a dummy output node depends on all leaf node.
         if (firstLoop_) {
@@ -81,6 +113,43 @@ public:
     }
 
 private:
+    // Return the failure of `beginBatch`, the first failure of the input is kept in `code'
+    nebula::cpp2::ErrorCode goBatch(PartitionID partId,
+                                    const std::vector<T>& batch,
+                                    nebula::cpp2::ErrorCode* code) {
+        if (firstLoop_) {
+            auto output = std::make_unique<RelNode<T>>();
+            for (const auto& node : nodes_) {
+                if (!node->hasDependents_) {
+                    // add dependency of output node
+                    output->addDependency(node.get());
+                }
+            }
+            outputIdx_ = addNode(std::move(output));
+            firstLoop_ = false;
+        }
+        CHECK_GE(outputIdx_, 0);
+        CHECK_LT(outputIdx_, nodes_.size());
+        SCOPE_EXIT {
+            for (auto& node : nodes_) {
+                node->endBatch();
+            }
+        };
+        for (auto& node : nodes_) {
+            auto ret = node->beginBatch(partId, batch);
+            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                return ret;
+            }
+        }
+        for (const auto& row : batch) {
+            auto ret = nodes_[outputIdx_]->execute(partId, row);
+            if (*code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+                *code = ret;
+            }
+        }
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
     bool firstLoop_ = true;
     int32_t outputIdx_ = -1;
     std::vector<std::unique_ptr<RelNode<T>>> nodes_;
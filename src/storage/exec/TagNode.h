@@ -62,18 +62,71 @@ public:
             }
         }
 
+        // the vertex has been read along with the batch
+        auto idx = batchIndex(partId, vId);
+        if (idx >= 0) {
+            if (batchFound_[idx]) {
+                key_ = batchKeys_[idx];
+                value_ = batchValues_[idx];
+                RequestTrace::countKey(key_.size() + value_.size());
+                resetReader(vId);
+            }
+            return nebula::cpp2::ErrorCode::SUCCEEDED;
+        }
+
         std::unique_ptr<kvstore::KVIterator> iter;
         auto prefix = NebulaKeyUtils::vertexPrefix(context_->vIdLen(), partId, vId, tagId_);
         ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix, &iter);
         if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && iter->valid()) {
             key_ = iter->key().str();
             value_ = iter->val().str();
+            RequestTrace::countKey(key_.size() + value_.size());
             resetReader(vId);
             return nebula::cpp2::ErrorCode::SUCCEEDED;
         }
         return ret;
     }
 
+    // Read the tag of all vertices in the batch by one multiGet, instead of a prefix scan for
+    // each vertex. The vertex key is the same as the prefix used in execute.
+    nebula::cpp2::ErrorCode beginBatch(PartitionID partId,
+                                       const std::vector<VertexID>& vIds) override {
+        endBatch();
+        std::vector<std::string> keys;
+        keys.reserve(vIds.size());
+        for (const auto& vId : vIds) {
+            keys.emplace_back(NebulaKeyUtils::vertexKey(context_->vIdLen(), partId, vId, tagId_));
+        }
+        auto ret = context_->env()->kvstore_->multiGet(context_->spaceId(),
+                                                       partId,
+                                                       keys,
+                                                       &batchValues_);
+        if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+            ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+            batchValues_.clear();
+            return ret.first;
+        }
+        batchFound_.reserve(vIds.size());
+        for (const auto& status : ret.second) {
+            batchFound_.emplace_back(status.ok());
+        }
+        batchIdx_.reserve(vIds.size());
+        for (size_t i = 0; i < vIds.size(); i++) {
+            // the same vertex might be in the batch more than once, any of them is fine
+            batchIdx_.emplace(vIds[i], i);
+        }
+        batchPartId_ = partId;
+        batchKeys_ = std::move(keys);
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    void endBatch() override {
+        batchIdx_.clear();
+        batchKeys_.clear();
+        batchValues_.clear();
+        batchFound_.clear();
+    }
+
     nebula::cpp2::ErrorCode
     collectTagPropsIfValid(NullHandler nullHandler,
                            PropHandler valueHandler) {
@@ -113,6 +166,20 @@ public:
     }
 
 private:
+    // The index of the vertex in the batch, -1 if it is not in the batch. The vertices are
+    // looked up by id, so it doesn't matter in which order they are executed, or whether some of
+    // them are served by the vertex cache.
+    int64_t batchIndex(PartitionID partId, const VertexID& vId) const {
+        if (batchIdx_.empty() || partId != batchPartId_) {
+            return -1;
+        }
+        auto iter = batchIdx_.find(vId);
+        if (iter == batchIdx_.end()) {
+            return -1;
+        }
+        return iter->second;
+    }
+
     bool resetReader(const VertexID& vId) {
         reader_.reset(*schemas_, value_);
         if (!reader_ || (ttl_.hasValue() && CommonUtils::checkDataExpiredForTTL(
@@ -140,6 +207,13 @@ private:
     std::string                                                           key_;
     std::string                                                           value_;
     RowReaderWrapper                                                      reader_;
+
+    // columns of the batch, the value is valid only when it is found
+    PartitionID                                                           batchPartId_ = 0;
+    std::unordered_map<VertexID, size_t>                                  batchIdx_;
+    std::vector<std::string>                                              batchKeys_;
+    std::vector<std::string>                                              batchValues_;
+    std::vector<bool>                                                     batchFound_;
 };
 
 }  // namespace storage
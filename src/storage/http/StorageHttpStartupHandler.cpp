@@ -0,0 +1,75 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/http/StorageHttpStartupHandler.h"
+#include "kvstore/StartupProgress.h"
+#include <folly/json.h>
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+
+namespace nebula {
+namespace storage {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::UpgradeProtocol;
+using proxygen::ResponseBuilder;
+
+void StorageHttpStartupHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+    if (!unavailable_ && headers->getMethod().value() != HTTPMethod::GET) {
+        // Unsupported method
+        err_ = HttpCode::E_UNSUPPORTED_METHOD;
+        return;
+    }
+    resp_ = folly::toPrettyJson(kvstore::StartupProgress::instance().toJson());
+}
+
+
+void StorageHttpStartupHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+    // Do nothing, we only support GET
+}
+
+
+void StorageHttpStartupHandler::onEOM() noexcept {
+    if (err_ == HttpCode::E_UNSUPPORTED_METHOD) {
+        ResponseBuilder(downstream_)
+            .status(405, "Method Not Allowed")
+            .sendWithEOM();
+        return;
+    }
+    if (unavailable_) {
+        ResponseBuilder(downstream_)
+            .status(503, "Service Unavailable")
+            .body(resp_)
+            .sendWithEOM();
+        return;
+    }
+    ResponseBuilder(downstream_)
+        .status(200, "OK")
+        .body(resp_)
+        .sendWithEOM();
+}
+
+
+void StorageHttpStartupHandler::onUpgrade(UpgradeProtocol) noexcept {
+    // Do nothing
+}
+
+
+void StorageHttpStartupHandler::requestComplete() noexcept {
+    delete this;
+}
+
+
+void StorageHttpStartupHandler::onError(ProxygenError error) noexcept {
+    LOG(ERROR) << "Web service StorageHttpStartupHandler got error: "
+               << proxygen::getErrorString(error);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,50 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_HTTP_STORAGEHTTPSTARTUPHANDLER_H_
+#define STORAGE_HTTP_STORAGEHTTPSTARTUPHANDLER_H_
+
+#include "common/base/Base.h"
+#include "common/webservice/Common.h"
+#include <proxygen/httpserver/RequestHandler.h>
+
+namespace nebula {
+namespace storage {
+
+using nebula::HttpCode;
+
+/**
+ * Return the progress of loading the data when storaged starts in json, including the state,
+ * the engines or parts done and the time of each phase. It also answers the handlers which need
+ * the store with 503 before the store is ready, along with the progress.
+ * */
+class StorageHttpStartupHandler : public proxygen::RequestHandler {
+public:
+    explicit StorageHttpStartupHandler(bool unavailable = false)
+        : unavailable_(unavailable) {}
+
+    void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+    void onEOM() noexcept override;
+
+    void onUpgrade(proxygen::UpgradeProtocol protocol) noexcept override;
+
+    void requestComplete() noexcept override;
+
+    void onError(proxygen::ProxygenError error) noexcept override;
+
+private:
+    bool unavailable_{false};
+    HttpCode err_{HttpCode::SUCCEEDED};
+    std::string resp_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_HTTP_STORAGEHTTPSTARTUPHANDLER_H_
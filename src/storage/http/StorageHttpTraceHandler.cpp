@@ -0,0 +1,73 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/http/StorageHttpTraceHandler.h"
+#include "storage/context/RequestTrace.h"
+#include <folly/json.h>
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+
+namespace nebula {
+namespace storage {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::UpgradeProtocol;
+using proxygen::ResponseBuilder;
+
+void StorageHttpTraceHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+    if (headers->getMethod().value() != HTTPMethod::GET) {
+        // Unsupported method
+        err_ = HttpCode::E_UNSUPPORTED_METHOD;
+        return;
+    }
+    auto& log = SlowRequestLog::instance();
+    resp_ = folly::toPrettyJson(log.toJson());
+    auto* clear = headers->getQueryParamPtr("clear");
+    if (clear != nullptr && *clear == "true") {
+        log.clear();
+    }
+}
+
+
+void StorageHttpTraceHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+    // Do nothing, we only support GET
+}
+
+
+void StorageHttpTraceHandler::onEOM() noexcept {
+    if (err_ == HttpCode::E_UNSUPPORTED_METHOD) {
+        ResponseBuilder(downstream_)
+            .status(405, "Method Not Allowed")
+            .sendWithEOM();
+        return;
+    }
+    ResponseBuilder(downstream_)
+        .status(200, "OK")
+        .body(resp_)
+        .sendWithEOM();
+}
+
+
+void StorageHttpTraceHandler::onUpgrade(UpgradeProtocol) noexcept {
+    // Do nothing
+}
+
+
+void StorageHttpTraceHandler::requestComplete() noexcept {
+    delete this;
+}
+
+
+void StorageHttpTraceHandler::onError(ProxygenError error) noexcept {
+    LOG(ERROR) << "Web service StorageHttpTraceHandler got error: "
+               << proxygen::getErrorString(error);
+}
+
+}  // namespace storage
+}  // namespace nebula
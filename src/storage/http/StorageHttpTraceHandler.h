@@ -0,0 +1,47 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_HTTP_STORAGEHTTPTRACEHANDLER_H_
+#define STORAGE_HTTP_STORAGEHTTPTRACEHANDLER_H_
+
+#include "common/base/Base.h"
+#include "common/webservice/Common.h"
+#include <proxygen/httpserver/RequestHandler.h>
+
+namespace nebula {
+namespace storage {
+
+using nebula::HttpCode;
+
+/**
+ * Return the slowest traced requests in json, slowest first. They are cleared
+ * by /slow_requests?clear=true
+ * */
+class StorageHttpTraceHandler : public proxygen::RequestHandler {
+public:
+    StorageHttpTraceHandler() = default;
+
+    void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+    void onEOM() noexcept override;
+
+    void onUpgrade(proxygen::UpgradeProtocol protocol) noexcept override;
+
+    void requestComplete() noexcept override;
+
+    void onError(proxygen::ProxygenError error) noexcept override;
+
+private:
+    HttpCode err_{HttpCode::SUCCEEDED};
+    std::string resp_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_HTTP_STORAGEHTTPTRACEHANDLER_H_
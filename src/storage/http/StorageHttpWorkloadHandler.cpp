@@ -0,0 +1,110 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/http/StorageHttpWorkloadHandler.h"
+#include "storage/WorkloadPools.h"
+#include <folly/json.h>
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+
+namespace nebula {
+namespace storage {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::UpgradeProtocol;
+using proxygen::ResponseBuilder;
+
+void StorageHttpWorkloadHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+    if (headers->getMethod().value() != HTTPMethod::GET) {
+        // Unsupported method
+        err_ = HttpCode::E_UNSUPPORTED_METHOD;
+        return;
+    }
+    auto& pools = WorkloadPools::instance();
+    auto* name = headers->getQueryParamPtr("pool");
+    if (name != nullptr) {
+        auto* pool = pools.find(*name);
+        if (pool == nullptr) {
+            err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+            resp_ = folly::stringPrintf("Unknown pool %s, or the workload pools are disabled",
+                                        name->c_str());
+            return;
+        }
+        auto* threads = headers->getQueryParamPtr("threads");
+        auto* maxQueueSize = headers->getQueryParamPtr("max_queue_size");
+        folly::Expected<int32_t, folly::ConversionCode> numThreads = 1;
+        folly::Expected<int64_t, folly::ConversionCode> queueSize = 0;
+        if (threads != nullptr) {
+            numThreads = folly::tryTo<int32_t>(*threads);
+        }
+        if (maxQueueSize != nullptr) {
+            queueSize = folly::tryTo<int64_t>(*maxQueueSize);
+        }
+        if (!numThreads.hasValue() || numThreads.value() <= 0 ||
+            !queueSize.hasValue() || queueSize.value() < 0) {
+            err_ = HttpCode::E_ILLEGAL_ARGUMENT;
+            resp_ = "Usage: http://ip:port/workloads?pool=xx&threads=yy&max_queue_size=zz";
+            return;
+        }
+        if (threads != nullptr) {
+            pool->setNumThreads(numThreads.value());
+        }
+        if (maxQueueSize != nullptr) {
+            pool->setMaxQueueSize(queueSize.value());
+        }
+    }
+    resp_ = folly::toPrettyJson(pools.toJson());
+}
+
+
+void StorageHttpWorkloadHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+    // Do nothing, we only support GET
+}
+
+
+void StorageHttpWorkloadHandler::onEOM() noexcept {
+    switch (err_) {
+        case HttpCode::E_UNSUPPORTED_METHOD:
+            ResponseBuilder(downstream_)
+                .status(405, "Method Not Allowed")
+                .sendWithEOM();
+            return;
+        case HttpCode::E_ILLEGAL_ARGUMENT:
+            ResponseBuilder(downstream_)
+                .status(400, "Bad Request")
+                .body(resp_)
+                .sendWithEOM();
+            return;
+        default:
+            break;
+    }
+    ResponseBuilder(downstream_)
+        .status(200, "OK")
+        .body(resp_)
+        .sendWithEOM();
+}
+
+
+void StorageHttpWorkloadHandler::onUpgrade(UpgradeProtocol) noexcept {
+    // Do nothing
+}
+
+
+void StorageHttpWorkloadHandler::requestComplete() noexcept {
+    delete this;
+}
+
+
+void StorageHttpWorkloadHandler::onError(ProxygenError error) noexcept {
+    LOG(ERROR) << "Web service StorageHttpWorkloadHandler got error: "
+               << proxygen::getErrorString(error);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -11,12 +11,54 @@
 #include "storage/exec/FilterNode.h"
 #include "storage/exec/UpdateNode.h"
 #include "storage/exec/UpdateResultNode.h"
+#include "storage/MergeOperator.h"
+#include "kvstore/LogEncoder.h"
 
 namespace nebula {
 namespace storage {
 
 ProcessorCounters kUpdateVertexCounters;
 
+namespace {
+
+// Get the delta if `exp' is `tag.prop + c', `c + tag.prop' or `tag.prop - c' of an int constant
+folly::Optional<int64_t> propDelta(const Expression* exp,
+                                   const std::string& tagName,
+                                   const std::string& prop) {
+    if (exp->kind() != Expression::Kind::kAdd && exp->kind() != Expression::Kind::kMinus) {
+        return folly::none;
+    }
+    auto* ariExp = static_cast<const ArithmeticExpression*>(exp);
+    const Expression* propExp = ariExp->left();
+    const Expression* constExp = ariExp->right();
+    if (propExp->kind() == Expression::Kind::kConstant &&
+        exp->kind() == Expression::Kind::kAdd) {
+        std::swap(propExp, constExp);
+    }
+    if (propExp->kind() != Expression::Kind::kSrcProperty ||
+        constExp->kind() != Expression::Kind::kConstant) {
+        return folly::none;
+    }
+    auto* srcExp = static_cast<const SourcePropertyExpression*>(propExp);
+    if (srcExp->sym() != tagName || srcExp->prop() != prop) {
+        return folly::none;
+    }
+    const auto& value = static_cast<const ConstantExpression*>(constExp)->value();
+    if (!value.isInt()) {
+        return folly::none;
+    }
+    auto delta = value.getInt();
+    if (exp->kind() == Expression::Kind::kMinus) {
+        if (delta == std::numeric_limits<int64_t>::min()) {
+            return folly::none;
+        }
+        delta = -delta;
+    }
+    return delta;
+}
+
+}  // namespace
+
 void UpdateVertexProcessor::process(const cpp2::UpdateVertexRequest& req) {
     if (executor_ != nullptr) {
         executor_->add([req, this] () {
@@ -72,6 +114,26 @@ void UpdateVertexProcessor::doProcess(const cpp2::UpdateVertexRequest& req) {
     }
     indexes_ = std::move(iRet).value();
 
+    if (FLAGS_enable_update_by_merge) {
+        auto operands = buildMergeOperands();
+        if (operands.hasValue()) {
+            auto code = updateByMerge(partId, vId.getStr(), std::move(operands).value());
+            if (code.hasValue()) {
+                if (code.value() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    handleErrorCode(code.value(), spaceId_, partId);
+                } else {
+                    resultDataSet_.colNames.emplace_back("_inserted");
+                    std::vector<Value> row;
+                    row.emplace_back(false);
+                    resultDataSet_.rows.emplace_back(std::move(row));
+                    onProcessFinished();
+                }
+                onFinished();
+                return;
+            }
+        }
+    }
+
     VLOG(3) << "Update vertex, spaceId: " << spaceId_
             << ", partId: " << partId << ", vId: " << vId;
     auto plan = buildPlan(&resultDataSet_);
@@ -287,6 +349,96 @@ UpdateVertexProcessor::buildTagContext(const cpp2::UpdateVertexRequest& req) {
     return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+folly::Optional<std::vector<std::string>> UpdateVertexProcessor::buildMergeOperands() {
+    // The upsert needs to read the row, and the filter and return props need the values
+    if (insertable_ || filterExp_ != nullptr || !returnPropsExp_.empty() ||
+        updatedProps_.empty()) {
+        return folly::none;
+    }
+    // An expired row should be regarded as not existed, which only the plan checks
+    if (tagContext_.ttlInfo_.find(tagId_) != tagContext_.ttlInfo_.end()) {
+        return folly::none;
+    }
+
+    std::vector<std::string> operands;
+    auto pool = context_->objPool();
+    for (const auto& prop : updatedProps_) {
+        const auto& name = prop.get_name();
+        // The index entries are rebuilt from the new value, so the value must be read
+        for (const auto& index : indexes_) {
+            if (index->get_schema_id().get_tag_id() != tagId_) {
+                continue;
+            }
+            for (const auto& col : index->get_fields()) {
+                if (col.get_name() == name) {
+                    return folly::none;
+                }
+            }
+        }
+        // The narrower integers would be checked for overflow in the plan, int64 just wraps
+        auto field = context_->tagSchema_->field(name);
+        if (field == nullptr || field->type() != meta::cpp2::PropertyType::INT64) {
+            return folly::none;
+        }
+        auto delta = propDelta(Expression::decode(pool, prop.get_value()),
+                               context_->tagName_,
+                               name);
+        if (!delta.hasValue()) {
+            return folly::none;
+        }
+        auto operand = NebulaOperator::addFieldOperand(context_->tagSchema_, name, delta.value());
+        if (!operand.ok()) {
+            return folly::none;
+        }
+        operands.emplace_back(std::move(operand).value());
+    }
+    return operands;
+}
+
+folly::Optional<nebula::cpp2::ErrorCode>
+UpdateVertexProcessor::updateByMerge(PartitionID partId,
+                                     const VertexID& vId,
+                                     std::vector<std::string> operands) {
+    // This is not a blind write yet. The lock is still held, otherwise a read-modify-write
+    // update of the same vertex would overwrite the merge by a put of the row it read before.
+    // The row is still read, because an operand which doesn't match the row (vertex missing,
+    // schema changed) is dropped by NebulaOperator silently, while the update has to report it.
+    std::vector<VMLI> dummyLock = {std::make_tuple(spaceId_, partId, tagId_, vId)};
+    nebula::MemoryLockGuard<VMLI> lg(env_->verticesML_.get(), std::move(dummyLock));
+    if (!lg) {
+        return nebula::cpp2::ErrorCode::E_DATA_CONFLICT_ERROR;
+    }
+
+    auto key = NebulaKeyUtils::vertexKey(spaceVidLen_, partId, vId, tagId_);
+    std::string row;
+    auto ret = env_->kvstore_->get(spaceId_, partId, key, &row);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+        // Let the plan report the missing vertex or the leader changed
+        return folly::none;
+    }
+    // The operand only matches the rows encoded by RowWriterV2 with the latest schema
+    SchemaVer schemaVer;
+    int32_t readerVer;
+    RowReaderWrapper::getVersions(row, schemaVer, readerVer);
+    if (readerVer != 2 || schemaVer != context_->tagSchema_->getVersion()) {
+        return folly::none;
+    }
+
+    auto batchHolder = std::make_unique<kvstore::BatchHolder>();
+    for (auto& operand : operands) {
+        batchHolder->merge(std::string(key), std::move(operand));
+    }
+    folly::Baton<true, std::atomic> baton;
+    auto callback = [&ret, &baton] (nebula::cpp2::ErrorCode code) {
+        ret = code;
+        baton.post();
+    };
+    env_->kvstore_->asyncAppendBatch(
+        spaceId_, partId, encodeBatchValue(batchHolder->getBatch()), callback);
+    baton.wait();
+    return ret;
+}
+
 void UpdateVertexProcessor::onProcessFinished() {
     resp_.set_props(std::move(resultDataSet_));
 }
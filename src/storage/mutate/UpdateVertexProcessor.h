@@ -56,6 +56,15 @@ private:
 
     void onProcessFinished() override;
 
+    // When each updated prop is `prop = prop +/- constant', return the merge operands which add
+    // the constants. Return none if the update must be done by the read-modify-write plan.
+    folly::Optional<std::vector<std::string>> buildMergeOperands();
+
+    // Merge the operands into the existing vertex, return none if the row can't be merged
+    // (not exists, or not encoded by the latest schema), then the plan should be used instead.
+    folly::Optional<nebula::cpp2::ErrorCode>
+    updateByMerge(PartitionID partId, const VertexID& vId, std::vector<std::string> operands);
+
     std::vector<Expression*> getReturnPropsExp() {
         // std::vector<Expression*> result;
         // result.resize(returnPropsExp_.size());
@@ -19,8 +19,12 @@ namespace storage {
 ProcessorCounters kGetNeighborsCounters;
 
 void GetNeighborsProcessor::process(const cpp2::GetNeighborsRequest& req) {
+    trace_ = RequestTrace::sample("getNeighbors", req.get_space_id());
     if (executor_ != nullptr) {
-        executor_->add([req, this] () {
+        executor_->add([req, this, queued = time::Duration()] () {
+            if (trace_ != nullptr) {
+                trace_->addTime(RequestTrace::kQueue, queued.elapsedInUSec());
+            }
             this->doProcess(req);
         });
     } else {
@@ -29,6 +33,7 @@ void GetNeighborsProcessor::process(const cpp2::GetNeighborsRequest& req) {
 }
 
 void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
+    TraceGuard guard(trace_.get());
     spaceId_ = req.get_space_id();
     auto retCode = getSpaceVidLen(spaceId_);
     if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -61,6 +66,7 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
         }
     }
 
+    edgeBudget_ = FLAGS_max_edges_returned_per_response;
     // todo(doodle): specify by each query
     if (!FLAGS_query_concurrently) {
         runInSingleThread(req, limit, random);
@@ -78,8 +84,11 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
     std::unordered_set<PartitionID> failedParts;
     for (const auto& partEntry : req.get_parts()) {
         auto partId = partEntry.first;
+        std::vector<VertexID> vIds;
+        vIds.reserve(partEntry.second.size());
         for (const auto& row : partEntry.second) {
             CHECK_GE(row.values.size(), 1);
+            // the first column of each row would be the vertex id
             auto vId = row.values[0].getStr();
 
             if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
@@ -89,14 +98,19 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
                 onFinished();
                 return;
             }
+            vIds.emplace_back(std::move(vId));
+        }
 
-            // the first column of each row would be the vertex id
-            auto ret = plan.go(partId, vId);
-            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                if (failedParts.find(partId) == failedParts.end()) {
-                    failedParts.emplace(partId);
-                    handleErrorCode(ret, spaceId_, partId);
-                }
+        // the vertices of the same part are executed in batches
+        nebula::cpp2::ErrorCode ret;
+        {
+            ScopedTrace execute(RequestTrace::kExecute);
+            ret = plan.go(partId, vIds);
+        }
+        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            if (failedParts.find(partId) == failedParts.end()) {
+                failedParts.emplace(partId);
+                handleErrorCode(ret, spaceId_, partId);
             }
         }
     }
@@ -123,14 +137,21 @@ void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest&
 
     folly::collectAll(futures).via(executor_).thenTry([this] (auto&& t) mutable {
         CHECK(!t.hasException());
+        TraceGuard guard(trace_.get());
         const auto& tries = t.value();
-        for (size_t j = 0; j < tries.size(); j++) {
-            CHECK(!tries[j].hasException());
-            const auto& [code, partId] = tries[j].value();
-            if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                handleErrorCode(code, spaceId_, partId);
-            } else {
-                resultDataSet_.append(std::move(results_[j]));
+        {
+            ScopedTrace output(RequestTrace::kOutput);
+            for (size_t j = 0; j < tries.size(); j++) {
+                CHECK(!tries[j].hasException());
+                const auto& [code, partId] = tries[j].value();
+                if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    handleErrorCode(code, spaceId_, partId);
+                }
+                // the rows of a part out of the edge budget are returned as they are
+                if (code == nebula::cpp2::ErrorCode::SUCCEEDED ||
+                    code == nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+                    resultDataSet_.append(std::move(results_[j]));
+                }
             }
         }
         this->onProcessFinished();
@@ -148,10 +169,20 @@ GetNeighborsProcessor::runInExecutor(RunTimeContext* context,
                                      bool random) {
     return folly::via(
         executor_,
-        [this, context, expCtx, result, partId, input = std::move(rows), limit, random]() {
-            auto plan = buildPlan(context, expCtx, result, limit, random);
+        [this, context, expCtx, result, partId, input = std::move(rows), limit, random]()
+        -> folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> {
+            TraceGuard guard(trace_.get());
+            ScopedTrace execute(RequestTrace::kExecute);
+            // the super vertices are found by the plan, when their edges reach the threshold
+            auto superVertices = std::make_shared<GetNeighborsNode::SuperVertices>();
+            bool splitSuper = FLAGS_super_vertex_threshold > 0 && !random;
+            auto plan = buildPlan(context, expCtx, result, limit, random, nullptr, nullptr,
+                                  splitSuper ? superVertices.get() : nullptr);
+            std::vector<VertexID> vIds;
+            vIds.reserve(input.size());
             for (const auto& row : input) {
                 CHECK_GE(row.values.size(), 1);
+                // the first column of each row would be the vertex id
                 auto vId = row.values[0].getStr();
 
                 if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
@@ -159,22 +190,209 @@ GetNeighborsProcessor::runInExecutor(RunTimeContext* context,
                                << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
                     return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
                 }
+                vIds.emplace_back(std::move(vId));
+            }
+            auto code = plan.go(partId, vIds);
+            if (code != nebula::cpp2::ErrorCode::SUCCEEDED || superVertices->empty()) {
+                return std::make_pair(code, partId);
+            }
 
-                // the first column of each row would be the vertex id
-                auto ret = plan.go(partId, vId);
-                if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                    return std::make_pair(ret, partId);
+            std::vector<folly::Future<ErrorOr<nebula::cpp2::ErrorCode, nebula::Row>>> futures;
+            for (const auto& superVertex : *superVertices) {
+                const auto& vId = superVertex.second;
+                auto ranges = splitSuperVertex(partId, vId);
+                if (!nebula::ok(ranges)) {
+                    return std::make_pair(nebula::error(ranges), partId);
+                }
+                futures.emplace_back(
+                    goSuperVertex(partId, vId, std::move(nebula::value(ranges)), limit));
+            }
+            // the placeholder rows of super vertices are replaced in place, to keep the order
+            return folly::collectAll(futures).via(executor_).thenValue(
+                [result, partId, superVertices] (auto&& tries) {
+                    for (size_t j = 0; j < tries.size(); j++) {
+                        auto& t = tries[j];
+                        CHECK(!t.hasException());
+                        if (!nebula::ok(t.value())) {
+                            return std::make_pair(nebula::error(t.value()), partId);
+                        }
+                        auto rowIdx = (*superVertices)[j].first;
+                        result->rows[rowIdx] = std::move(nebula::value(t.value()));
+                    }
+                    return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
+                });
+        });
+}
+
+ErrorOr<nebula::cpp2::ErrorCode, std::vector<EdgeRange>>
+GetNeighborsProcessor::splitSuperVertex(PartitionID partId, const VertexID& vId) {
+    std::vector<EdgeRange> ranges;
+    int64_t threshold = FLAGS_super_vertex_threshold;
+    uint32_t splitNum = std::max(FLAGS_super_vertex_split_num, 1);
+    for (const auto& ec : edgeContext_.propContexts_) {
+        auto edgeType = ec.first;
+        auto prefix = NebulaKeyUtils::edgePrefix(spaceVidLen_, partId, vId, edgeType);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto ret = env_->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            return ret;
+        }
+        if (!iter || !iter->valid()) {
+            ranges.emplace_back(EdgeRange{edgeType, "", ""});
+            continue;
+        }
+
+        // sample the rank and the first byte of dst of the first edge
+        auto firstKey = iter->key();
+        std::string rank;
+        uint32_t lo = 0;
+        if (firstKey.size() > prefix.size() + sizeof(EdgeRanking)) {
+            rank = firstKey.subpiece(prefix.size(), sizeof(EdgeRanking)).str();
+            lo = static_cast<uint8_t>(firstKey[prefix.size() + sizeof(EdgeRanking)]);
+        }
+        // only count the keys, the probe stops at the threshold
+        int64_t count = 0;
+        for (; iter->valid() && count < threshold; iter->next()) {
+            ++count;
+        }
+        if (count < threshold || splitNum <= 1 || rank.empty()) {
+            ranges.emplace_back(EdgeRange{edgeType, "", ""});
+            continue;
+        }
+
+        // Split by the first byte of dst following the rank of the first edge. The boundaries
+        // only affect how balanced the sub-ranges are: edges of larger ranks all fall into the
+        // last one. Int vids are little endian, so the first byte is roughly uniform, and string
+        // vids are usually printable.
+        uint32_t hi = (isIntId_ || lo >= 0x80) ? 0x100 : 0x80;
+        uint32_t prev = lo;
+        std::string start;
+        for (uint32_t i = 1; i < splitNum; i++) {
+            uint32_t bound = lo + (hi - lo) * i / splitNum;
+            if (bound <= prev) {
+                continue;
+            }
+            prev = bound;
+            std::string end = rank;
+            end.push_back(static_cast<char>(bound));
+            ranges.emplace_back(EdgeRange{edgeType, std::move(start), end});
+            start = std::move(end);
+        }
+        ranges.emplace_back(EdgeRange{edgeType, std::move(start), ""});
+    }
+    return ranges;
+}
+
+folly::Future<ErrorOr<nebula::cpp2::ErrorCode, nebula::Row>>
+GetNeighborsProcessor::goSuperVertex(PartitionID partId,
+                                     const VertexID& vId,
+                                     std::vector<EdgeRange> ranges,
+                                     int64_t limit) {
+    std::vector<std::shared_ptr<SubRange>> subRanges;
+    std::vector<folly::Future<nebula::cpp2::ErrorCode>> futures;
+    for (auto& range : ranges) {
+        auto subRange = std::make_shared<SubRange>(
+            planContext_.get(), spaceVidLen_, isIntId_, std::move(range));
+        futures.emplace_back(folly::via(executor_, [this, subRange, partId, vId, limit] () {
+            AggregateNode<VertexID>* agg = nullptr;
+            auto plan = buildPlan(&subRange->context_, &subRange->expCtx_, &subRange->result_,
+                                  limit, false, &subRange->range_, &agg);
+            auto code = plan.go(partId, vId);
+            if (code == nebula::cpp2::ErrorCode::SUCCEEDED && agg != nullptr) {
+                subRange->stats_ = agg->stats();
+            }
+            return code;
+        }));
+        subRanges.emplace_back(std::move(subRange));
+    }
+    return folly::collectAll(futures).via(executor_).thenValue(
+        [this, subRanges = std::move(subRanges), partId, vId, limit] (auto&& tries)
+        -> ErrorOr<nebula::cpp2::ErrorCode, nebula::Row> {
+            for (auto& t : tries) {
+                CHECK(!t.hasException());
+                if (t.value() != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    return t.value();
                 }
             }
-            return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
+            return mergeSubRanges(partId, vId, subRanges, limit);
         });
 }
 
-StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RunTimeContext* context,
-                                                       StorageExpressionContext* expCtx,
-                                                       nebula::DataSet* result,
-                                                       int64_t limit,
-                                                       bool random) {
+ErrorOr<nebula::cpp2::ErrorCode, nebula::Row>
+GetNeighborsProcessor::mergeSubRanges(PartitionID partId,
+                                      const VertexID& vId,
+                                      const std::vector<std::shared_ptr<SubRange>>& subRanges,
+                                      int64_t limit) {
+    // vId, stat, tags and expr are the same in all sub-ranges, the edges are appended in the
+    // order of sub-ranges, which is the same as scanning serially
+    CHECK(!subRanges.empty());
+    auto edgeStart = edgeContext_.offset_;
+    auto edgeEnd = edgeStart + edgeContext_.propContexts_.size();
+    int64_t count = 0;
+    nebula::Row row;
+    for (const auto& subRange : subRanges) {
+        CHECK_EQ(1, subRange->result_.rows.size());
+        auto& subRow = subRange->result_.rows.front();
+        if (row.values.empty()) {
+            row.values = subRow.values;
+            for (size_t i = edgeStart; i < edgeEnd; i++) {
+                row.values[i] = Value();
+            }
+        }
+        for (size_t i = edgeStart; i < edgeEnd; i++) {
+            if (!subRow.values[i].isList()) {
+                continue;
+            }
+            for (auto& edge : subRow.values[i].mutableList().values) {
+                if (count >= limit) {
+                    break;
+                }
+                if (row.values[i].empty()) {
+                    row.values[i].setList(nebula::List());
+                }
+                row.values[i].mutableList().values.emplace_back(std::move(edge));
+                ++count;
+            }
+        }
+    }
+
+    if (edgeContext_.statCount_ > 0) {
+        if (count >= limit) {
+            // the stat only covers the edges returned, which is not known until the sub-ranges
+            // are merged, so scan the vertex serially once more, it stops at the limit anyway
+            RunTimeContext context(planContext_.get());
+            StorageExpressionContext expCtx(spaceVidLen_, isIntId_);
+            nebula::DataSet result;
+            auto plan = buildPlan(&context, &expCtx, &result, limit);
+            auto code = plan.go(partId, vId);
+            if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                return code;
+            }
+            CHECK_EQ(1, result.rows.size());
+            return std::move(result.rows.front());
+        }
+        auto stats = subRanges.front()->stats_;
+        for (size_t i = 1; i < subRanges.size(); i++) {
+            const auto& subStats = subRanges[i]->stats_;
+            CHECK_EQ(stats.size(), subStats.size());
+            for (size_t j = 0; j < stats.size(); j++) {
+                AggregateNode<VertexID>::mergeStat(subStats[j], stats[j]);
+            }
+        }
+        row.values[1].setList(AggregateNode<VertexID>::calculateStat(stats));
+    }
+    return row;
+}
+
+StoragePlan<VertexID>
+GetNeighborsProcessor::buildPlan(RunTimeContext* context,
+                                 StorageExpressionContext* expCtx,
+                                 nebula::DataSet* result,
+                                 int64_t limit,
+                                 bool random,
+                                 const EdgeRange* range,
+                                 AggregateNode<VertexID>** agg,
+                                 GetNeighborsNode::SuperVertices* superVertices) {
     /*
     The StoragePlan looks like this:
                  +--------+---------+
@@ -206,6 +424,7 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RunTimeContext* context,
     std::vector<EdgeNode<VertexID>*> edges;
     for (const auto& ec : edgeContext_.propContexts_) {
         auto edge = std::make_unique<SingleEdgeNode>(context, &edgeContext_, ec.first, &ec.second);
+        edge->setRange(range);
         edges.emplace_back(edge.get());
         plan.addNode(std::move(edge));
     }
@@ -225,16 +444,20 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RunTimeContext* context,
     if (filter_) {
         auto filter =
             std::make_unique<FilterNode<VertexID>>(context, upstream, expCtx, filter_->clone());
+        filter->compileFilter(true);
         filter->addDependency(upstream);
         upstream = filter.get();
         plan.addNode(std::move(filter));
     }
 
     if (edgeContext_.statCount_ > 0) {
-        auto agg = std::make_unique<AggregateNode<VertexID>>(context, upstream, &edgeContext_);
-        agg->addDependency(upstream);
-        upstream = agg.get();
-        plan.addNode(std::move(agg));
+        auto aggNode = std::make_unique<AggregateNode<VertexID>>(context, upstream, &edgeContext_);
+        aggNode->addDependency(upstream);
+        upstream = aggNode.get();
+        if (agg != nullptr) {
+            *agg = aggNode.get();
+        }
+        plan.addNode(std::move(aggNode));
     }
 
     std::unique_ptr<GetNeighborsNode> output;
@@ -242,8 +465,9 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RunTimeContext* context,
         output = std::make_unique<GetNeighborsSampleNode>(
             context, join, upstream, &edgeContext_, result, limit);
     } else {
+        auto* edgeBudget = FLAGS_max_edges_returned_per_response > 0 ? &edgeBudget_ : nullptr;
         output = std::make_unique<GetNeighborsNode>(
-            context, join, upstream, &edgeContext_, result, limit);
+            context, join, upstream, &edgeContext_, result, limit, superVertices, edgeBudget);
     }
     output->addDependency(upstream);
     plan.addNode(std::move(output));
@@ -458,6 +682,9 @@ GetNeighborsProcessor::checkStatType(const meta::SchemaProviderIf::Field* field,
 }
 
 void GetNeighborsProcessor::onProcessFinished() {
+    if (trace_ != nullptr) {
+        trace_->setRows(resultDataSet_.rowSize());
+    }
     resp_.set_vertices(std::move(resultDataSet_));
 }
 
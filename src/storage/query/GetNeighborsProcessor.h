@@ -11,6 +11,9 @@
 #include <gtest/gtest_prod.h>
 #include "storage/query/QueryBaseProcessor.h"
 #include "storage/exec/StoragePlan.h"
+#include "storage/exec/EdgeNode.h"
+#include "storage/exec/AggregateNode.h"
+#include "storage/exec/GetNeighborsNode.h"
 
 namespace nebula {
 namespace storage {
@@ -47,7 +50,10 @@ protected:
                                     StorageExpressionContext* expCtx,
                                     nebula::DataSet* result,
                                     int64_t limit = 0,
-                                    bool random = false);
+                                    bool random = false,
+                                    const EdgeRange* range = nullptr,
+                                    AggregateNode<VertexID>** agg = nullptr,
+                                    GetNeighborsNode::SuperVertices* superVertices = nullptr);
 
     void onProcessFinished() override;
 
@@ -84,10 +90,44 @@ private:
         int64_t limit,
         bool random);
 
+    // The edges of a super vertex in one sub-range, which are scanned by a plan of its own
+    struct SubRange {
+        SubRange(PlanContext* planCtx, size_t vIdLen, bool isIntId, EdgeRange range)
+            : context_(planCtx)
+            , expCtx_(vIdLen, isIntId)
+            , range_(std::move(range)) {}
+
+        RunTimeContext              context_;
+        StorageExpressionContext    expCtx_;
+        EdgeRange                   range_;
+        nebula::DataSet             result_;
+        std::vector<PropStat>       stats_;
+    };
+
+    // Split the edges of the super vertex into sub-ranges by edge type, then the edge types with
+    // at least super_vertex_threshold edges by the sampled rank and dst boundaries.
+    ErrorOr<nebula::cpp2::ErrorCode, std::vector<EdgeRange>>
+    splitSuperVertex(PartitionID partId, const VertexID& vId);
+
+    // Scan the sub-ranges of a super vertex in parallel, and merge them into one row
+    folly::Future<ErrorOr<nebula::cpp2::ErrorCode, nebula::Row>> goSuperVertex(
+        PartitionID partId,
+        const VertexID& vId,
+        std::vector<EdgeRange> ranges,
+        int64_t limit);
+
+    ErrorOr<nebula::cpp2::ErrorCode, nebula::Row> mergeSubRanges(
+        PartitionID partId,
+        const VertexID& vId,
+        const std::vector<std::shared_ptr<SubRange>>& subRanges,
+        int64_t limit);
+
 private:
     std::vector<RunTimeContext>               contexts_;
     std::vector<StorageExpressionContext>     expCtxs_;
     std::vector<nebula::DataSet>              results_;
+    // edges the response could still hold, see max_edges_returned_per_response
+    std::atomic<int64_t>                      edgeBudget_{0};
 };
 
 }  // namespace storage
@@ -13,8 +13,12 @@ namespace storage {
 ProcessorCounters kGetPropCounters;
 
 void GetPropProcessor::process(const cpp2::GetPropRequest& req) {
+    trace_ = RequestTrace::sample("getProps", req.get_space_id());
     if (executor_ != nullptr) {
-        executor_->add([req, this] () {
+        executor_->add([req, this, queued = time::Duration()] () {
+            if (trace_ != nullptr) {
+                trace_->addTime(RequestTrace::kQueue, queued.elapsedInUSec());
+            }
             this->doProcess(req);
         });
     } else {
@@ -23,6 +27,7 @@ void GetPropProcessor::process(const cpp2::GetPropRequest& req) {
 }
 
 void GetPropProcessor::doProcess(const cpp2::GetPropRequest& req) {
+    TraceGuard guard(trace_.get());
     spaceId_ = req.get_space_id();
     auto retCode = getSpaceVidLen(spaceId_);
     if (retCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -58,6 +63,8 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
         auto plan = buildTagPlan(&contexts_.front(), &resultDataSet_);
         for (const auto& partEntry : req.get_parts()) {
             auto partId = partEntry.first;
+            std::vector<VertexID> vIds;
+            vIds.reserve(partEntry.second.size());
             for (const auto& row : partEntry.second) {
                 auto vId = row.values[0].getStr();
 
@@ -68,13 +75,18 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
                     onFinished();
                     return;
                 }
+                vIds.emplace_back(std::move(vId));
+            }
 
-                auto ret = plan.go(partId, vId);
-                if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
-                    failedParts.find(partId) == failedParts.end()) {
-                    failedParts.emplace(partId);
-                    handleErrorCode(ret, spaceId_, partId);
-                }
+            nebula::cpp2::ErrorCode ret;
+            {
+                ScopedTrace execute(RequestTrace::kExecute);
+                ret = plan.go(partId, vIds);
+            }
+            if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
+                failedParts.find(partId) == failedParts.end()) {
+                failedParts.emplace(partId);
+                handleErrorCode(ret, spaceId_, partId);
             }
         }
     } else {
@@ -101,7 +113,11 @@ void GetPropProcessor::runInSingleThread(const cpp2::GetPropRequest& req) {
                     return;
                 }
 
-                auto ret = plan.go(partId, edgeKey);
+                nebula::cpp2::ErrorCode ret;
+                {
+                    ScopedTrace execute(RequestTrace::kExecute);
+                    ret = plan.go(partId, edgeKey);
+                }
                 if (ret != nebula::cpp2::ErrorCode::SUCCEEDED &&
                     failedParts.find(partId) == failedParts.end()) {
                     failedParts.emplace(partId);
@@ -129,14 +145,18 @@ void GetPropProcessor::runInMultipleThread(const cpp2::GetPropRequest& req) {
 
     folly::collectAll(futures).via(executor_).thenTry([this] (auto&& t) mutable {
         CHECK(!t.hasException());
+        TraceGuard guard(trace_.get());
         const auto& tries = t.value();
-        for (size_t j = 0; j < tries.size(); j++) {
-            CHECK(!tries[j].hasException());
-            const auto& [code, partId] = tries[j].value();
-            if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                handleErrorCode(code, spaceId_, partId);
-            } else {
-                resultDataSet_.append(std::move(results_[j]));
+        {
+            ScopedTrace output(RequestTrace::kOutput);
+            for (size_t j = 0; j < tries.size(); j++) {
+                CHECK(!tries[j].hasException());
+                const auto& [code, partId] = tries[j].value();
+                if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    handleErrorCode(code, spaceId_, partId);
+                } else {
+                    resultDataSet_.append(std::move(results_[j]));
+                }
             }
         }
         this->onProcessFinished();
@@ -152,8 +172,12 @@ GetPropProcessor::runInExecutor(RunTimeContext* context,
     return folly::via(
         executor_,
         [this, context, result, partId, input = std::move(rows)]() {
+            TraceGuard guard(trace_.get());
+            ScopedTrace execute(RequestTrace::kExecute);
             if (!isEdge_) {
                 auto plan = buildTagPlan(context, result);
+                std::vector<VertexID> vIds;
+                vIds.reserve(input.size());
                 for (const auto& row : input) {
                     auto vId = row.values[0].getStr();
 
@@ -162,13 +186,9 @@ GetPropProcessor::runInExecutor(RunTimeContext* context,
                                 << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
                         return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
                     }
-
-                    auto ret = plan.go(partId, vId);
-                    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                        return std::make_pair(ret, partId);
-                    }
+                    vIds.emplace_back(std::move(vId));
                 }
-                return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
+                return std::make_pair(plan.go(partId, vIds), partId);
             } else {
                 auto plan = buildEdgePlan(context, result);
                 for (const auto& row : input) {
@@ -318,6 +338,9 @@ void GetPropProcessor::buildEdgeColName(const std::vector<cpp2::EdgeProp>& edgeP
 }
 
 void GetPropProcessor::onProcessFinished() {
+    if (trace_ != nullptr) {
+        trace_->setRows(resultDataSet_.rowSize());
+    }
     resp_.set_props(std::move(resultDataSet_));
 }
 
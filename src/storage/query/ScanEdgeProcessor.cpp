@@ -61,6 +61,13 @@ void ScanEdgeProcessor::doProcess(const cpp2::ScanEdgeRequest& req) {
 
     auto rowLimit = req.get_limit();
     RowReaderWrapper reader;
+    // the returned props are decoded by the projection of each schema version of each edge type,
+    // which is built when the first edge of them is met
+    using ProjectionKey = std::pair<const meta::SchemaProviderIf*, const std::vector<PropContext>*>;
+    std::unordered_map<ProjectionKey,
+                       std::unique_ptr<RowProjection>,
+                       folly::hasher<ProjectionKey>> projections;
+    std::vector<nebula::Value> values;
 
     for (int64_t rowCount = 0; iter->valid() && rowCount < rowLimit; iter->next()) {
         auto key = iter->key();
@@ -85,7 +92,15 @@ void ScanEdgeProcessor::doProcess(const cpp2::ScanEdgeRequest& req) {
         nebula::List list;
         auto idx = edgeIter->second;
         auto props = &(edgeContext_.propContexts_[idx].second);
-        if (!QueryUtils::collectEdgeProps(key, spaceVidLen_, isIntId_,
+        const RowProjection* projection = nullptr;
+        if (reader->readerVer() == 2) {
+            auto& proj = projections[std::make_pair(reader->getSchema(), props)];
+            if (proj == nullptr) {
+                proj = QueryUtils::buildProjection(reader->getSchema(), props);
+            }
+            projection = proj.get();
+        }
+        if (!QueryUtils::collectEdgeProps(key, spaceVidLen_, isIntId_, val, projection, values,
                                           reader.get(), props, list).ok()) {
             continue;
         }
@@ -10,6 +10,7 @@
 #include "utils/IndexKeyUtils.h"
 #include <gtest/gtest.h>
 #include "storage/CommonUtils.h"
+#include "storage/CompactionFilter.h"
 #include "storage/test/QueryTestUtils.h"
 #include "storage/test/TestUtils.h"
 #include "codec/RowWriterV2.h"
@@ -499,6 +500,124 @@ TEST(CompactionFilterTest, TTLFilterDataIndexNotExpiredTest) {
     FLAGS_mock_ttl_col = false;
 }
 
+// version 0 is (name, age), version 1 adds insertTime as the ttl column
+static std::shared_ptr<meta::NebulaSchemaProvider> buildTtlSchema(SchemaVer ver,
+                                                                  int64_t ttlDuration) {
+    auto schema = std::make_shared<meta::NebulaSchemaProvider>(ver);
+    schema->addField("name", meta::cpp2::PropertyType::STRING);
+    schema->addField("age", meta::cpp2::PropertyType::INT64);
+    if (ver > 0) {
+        schema->addField("insertTime", meta::cpp2::PropertyType::INT64);
+        meta::cpp2::SchemaProp prop;
+        prop.set_ttl_col("insertTime");
+        prop.set_ttl_duration(ttlDuration);
+        schema->setProp(prop);
+    }
+    return schema;
+}
+
+static std::string encodeRow(const meta::NebulaSchemaProvider* schema, int64_t insertTime) {
+    RowWriterV2 writer(schema);
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("name", "Tim Duncan"));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("age", 44L));
+    if (schema->getVersion() > 0) {
+        EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("insertTime", insertTime));
+    }
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.finish());
+    return std::move(writer).moveEncodedStr();
+}
+
+TEST(CompactionFilterTest, SnapshotNewerSchemaVersionTest) {
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    size_t vIdLen = 8;
+    mock::AdHocSchemaManager schemaMan;
+    mock::AdHocIndexManager indexMan;
+    schemaMan.addEdgeSchema(spaceId, 101, buildTtlSchema(0, 5));
+    schemaMan.addTagSchema(spaceId, tagId, buildTtlSchema(0, 5));
+
+    auto snapshot = CompactionSnapshot::build(&schemaMan, &indexMan, spaceId);
+    ASSERT_NE(nullptr, snapshot);
+    ASSERT_EQ(1, snapshot->tag(tagId)->schemas.size());
+    ASSERT_FALSE(snapshot->tag(tagId)->hasTtl);
+
+    // version 1 is altered after the snapshot, its rows are checked by the schema manager
+    auto newer = buildTtlSchema(1, 5);
+    schemaMan.addTagSchema(spaceId, tagId, newer);
+    StorageCompactionFilter filter(&schemaMan, &indexMan, vIdLen, std::move(snapshot));
+
+    auto key = NebulaKeyUtils::vertexKey(vIdLen, 1, "v1", tagId);
+    auto older = schemaMan.getTagSchema(spaceId, tagId, 0);
+    auto now = time::WallClock::fastNowInSec();
+    EXPECT_FALSE(filter.filter(spaceId, key, encodeRow(older.get(), 0)));
+    EXPECT_FALSE(filter.filter(spaceId, key, encodeRow(newer.get(), now)));
+    EXPECT_TRUE(filter.filter(spaceId, key, encodeRow(newer.get(), now - 10)));
+
+    schemaMan.removeTagSchema(spaceId, tagId);
+    EXPECT_TRUE(filter.filter(spaceId, key, encodeRow(newer.get(), now)));
+}
+
+TEST(CompactionFilterTest, SnapshotOlderVersionWithoutTtlColTest) {
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    size_t vIdLen = 8;
+    mock::AdHocSchemaManager schemaMan;
+    mock::AdHocIndexManager indexMan;
+    schemaMan.addEdgeSchema(spaceId, 101, buildTtlSchema(0, 5));
+    auto older = buildTtlSchema(0, 5);
+    auto newer = buildTtlSchema(1, 5);
+    schemaMan.addTagSchema(spaceId, tagId, older);
+    schemaMan.addTagSchema(spaceId, tagId, newer);
+
+    auto snapshot = CompactionSnapshot::build(&schemaMan, &indexMan, spaceId);
+    ASSERT_NE(nullptr, snapshot);
+    const auto* entry = snapshot->tag(tagId);
+    ASSERT_NE(nullptr, entry);
+    ASSERT_TRUE(entry->hasTtl);
+    EXPECT_EQ(5, entry->ttlDuration);
+    EXPECT_EQ((std::vector<int64_t>{-1, 2}), entry->ttlIndex);
+    StorageCompactionFilter filter(&schemaMan, &indexMan, vIdLen, std::move(snapshot));
+
+    auto key = NebulaKeyUtils::vertexKey(vIdLen, 1, "v1", tagId);
+    auto now = time::WallClock::fastNowInSec();
+    // the row of the version without the ttl column never expires
+    EXPECT_FALSE(filter.filter(spaceId, key, encodeRow(older.get(), 0)));
+    EXPECT_FALSE(filter.filter(spaceId, key, encodeRow(newer.get(), now)));
+    EXPECT_TRUE(filter.filter(spaceId, key, encodeRow(newer.get(), now - 10)));
+}
+
+TEST(CompactionFilterTest, SnapshotIndexOfDroppedSchemaTest) {
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    IndexID indexId = 1;
+    size_t vIdLen = 8;
+    mock::AdHocSchemaManager schemaMan;
+    mock::AdHocIndexManager indexMan;
+    schemaMan.addEdgeSchema(spaceId, 101, buildTtlSchema(0, 5));
+    auto schema = buildTtlSchema(1, 5);
+    schemaMan.addTagSchema(spaceId, tagId, buildTtlSchema(0, 5));
+    schemaMan.addTagSchema(spaceId, tagId, schema);
+    indexMan.addTagIndex(spaceId, tagId, indexId, {});
+    schemaMan.removeTagSchema(spaceId, tagId);
+
+    auto snapshot = CompactionSnapshot::build(&schemaMan, &indexMan, spaceId);
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ(nullptr, snapshot->tag(tagId));
+    const auto* index = snapshot->index(indexId);
+    ASSERT_NE(nullptr, index);
+    EXPECT_EQ(nullptr, index->schema);
+    StorageCompactionFilter filter(&schemaMan, &indexMan, vIdLen, std::move(snapshot));
+
+    auto now = time::WallClock::fastNowInSec();
+    auto vertexKey = NebulaKeyUtils::vertexKey(vIdLen, 1, "v1", tagId);
+    EXPECT_TRUE(filter.filter(spaceId, vertexKey, encodeRow(schema.get(), now)));
+
+    auto indexKey = IndexKeyUtils::vertexIndexKey(vIdLen, 1, indexId, "v1", "");
+    // the index without ttl value is kept as without the snapshot, the one with it is removed
+    EXPECT_FALSE(filter.filter(spaceId, indexKey, ""));
+    EXPECT_TRUE(filter.filter(spaceId, indexKey, IndexKeyUtils::indexVal(Value(now))));
+}
+
 }  // namespace storage
 }  // namespace nebula
 
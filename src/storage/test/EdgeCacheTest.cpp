@@ -0,0 +1,280 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
+#include "utils/NebulaKeyUtils.h"
+#include "storage/StorageFlags.h"
+#include "storage/cache/EdgeCache.h"
+#include "storage/query/GetNeighborsProcessor.h"
+#include "storage/test/QueryTestUtils.h"
+#include "mock/MockCluster.h"
+#include "mock/MockData.h"
+
+namespace nebula {
+namespace storage {
+
+static std::string encodeRows(const std::vector<kvstore::KV>& kvs) {
+    std::string rows;
+    for (const auto& kv : kvs) {
+        uint32_t keyLen = kv.first.size();
+        uint32_t valLen = kv.second.size();
+        rows.append(reinterpret_cast<const char*>(&keyLen), sizeof(uint32_t))
+            .append(kv.first)
+            .append(reinterpret_cast<const char*>(&valLen), sizeof(uint32_t))
+            .append(kv.second);
+    }
+    return rows;
+}
+
+static std::vector<kvstore::KV> collect(kvstore::KVIterator* iter) {
+    std::vector<kvstore::KV> result;
+    for (; iter->valid(); iter->next()) {
+        result.emplace_back(iter->key().str(), iter->val().str());
+    }
+    return result;
+}
+
+TEST(EdgeCacheTest, FillAndInvalidate) {
+    size_t vIdLen = 8;
+    GraphSpaceID spaceId = 1;
+    PartitionID partId = 1;
+    EdgeType edgeType = 101;
+    auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, partId, "src", edgeType);
+    std::vector<kvstore::KV> kvs;
+    for (int i = 0; i < 10; i++) {
+        auto key = NebulaKeyUtils::edgeKey(vIdLen, partId, "src", edgeType, i, "dst");
+        kvs.emplace_back(std::move(key), folly::to<std::string>(i));
+    }
+
+    EdgeCache cache(100, 4, 1024);
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix));
+    EXPECT_EQ(1, cache.misses());
+
+    auto version = cache.version(spaceId, prefix);
+    auto iter = cache.fill(spaceId,
+                           prefix,
+                           version,
+                           std::make_unique<EdgeCacheIterator>(encodeRows(kvs)));
+    EXPECT_EQ(kvs, collect(iter.get()));
+
+    iter = cache.get(spaceId, prefix);
+    ASSERT_NE(nullptr, iter);
+    EXPECT_EQ(1, cache.hits());
+    EXPECT_EQ(kvs, collect(iter.get()));
+
+    // the same vertex in another space is not cached
+    EXPECT_EQ(nullptr, cache.get(spaceId + 1, prefix));
+
+    // write to a vertex key or an edge of other type won't evict the list
+    cache.invalidate(spaceId, vIdLen, {NebulaKeyUtils::vertexKey(vIdLen, partId, "src", 1),
+                                       NebulaKeyUtils::edgeKey(vIdLen, partId, "src", 102,
+                                                               0, "dst")});
+    EXPECT_NE(nullptr, cache.get(spaceId, prefix));
+
+    // write any edge of the list will evict it
+    cache.invalidate(spaceId, vIdLen, {kvs[5].first});
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix));
+    EXPECT_EQ(2, cache.invalidations());
+
+    // a write happened during scanning, the list should not be cached
+    version = cache.version(spaceId, prefix);
+    cache.invalidate(spaceId, vIdLen, {kvs[0].first});
+    iter = cache.fill(spaceId,
+                      prefix,
+                      version,
+                      std::make_unique<EdgeCacheIterator>(encodeRows(kvs)));
+    EXPECT_EQ(kvs, collect(iter.get()));
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix));
+}
+
+TEST(EdgeCacheTest, InvalidatePart) {
+    size_t vIdLen = 8;
+    GraphSpaceID spaceId = 1;
+    EdgeType edgeType = 101;
+    EdgeCache cache(100, 4, 1024);
+    auto fill = [&] (GraphSpaceID space, PartitionID partId) {
+        auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, partId, "src", edgeType);
+        std::vector<kvstore::KV> kvs;
+        kvs.emplace_back(NebulaKeyUtils::edgeKey(vIdLen, partId, "src", edgeType, 0, "dst"),
+                         "val");
+        cache.fill(space,
+                   prefix,
+                   cache.version(space, prefix),
+                   std::make_unique<EdgeCacheIterator>(encodeRows(kvs)));
+        return prefix;
+    };
+    auto prefix1 = fill(spaceId, 1);
+    auto prefix2 = fill(spaceId, 2);
+    fill(spaceId + 1, 1);
+    ASSERT_NE(nullptr, cache.get(spaceId, prefix1));
+    ASSERT_NE(nullptr, cache.get(spaceId, prefix2));
+    ASSERT_NE(nullptr, cache.get(spaceId + 1, prefix1));
+
+    // only the lists of the part in the space are evicted
+    cache.invalidatePart(spaceId, 1);
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix1));
+    EXPECT_NE(nullptr, cache.get(spaceId, prefix2));
+    EXPECT_NE(nullptr, cache.get(spaceId + 1, prefix1));
+
+    // the part is invalidated during scanning, the list filled should not be served
+    auto version = cache.version(spaceId, prefix2);
+    cache.invalidatePart(spaceId, 2);
+    std::vector<kvstore::KV> kvs;
+    kvs.emplace_back(NebulaKeyUtils::edgeKey(vIdLen, 2, "src", edgeType, 0, "dst"), "val");
+    cache.fill(spaceId, prefix2, version, std::make_unique<EdgeCacheIterator>(encodeRows(kvs)));
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix2));
+
+    // filled again after the invalidation
+    fill(spaceId, 1);
+    EXPECT_NE(nullptr, cache.get(spaceId, prefix1));
+}
+
+TEST(EdgeCacheTest, TooLargeToCache) {
+    size_t vIdLen = 8;
+    GraphSpaceID spaceId = 1;
+    auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, 1, "src", 101);
+    std::vector<kvstore::KV> kvs;
+    for (int i = 0; i < 100; i++) {
+        auto key = NebulaKeyUtils::edgeKey(vIdLen, 1, "src", 101, i, "dst");
+        kvs.emplace_back(std::move(key), std::string(32, 'a'));
+    }
+
+    // only part of the edges could be put in one entry
+    EdgeCache cache(100, 4, 1024);
+    auto iter = cache.fill(spaceId,
+                           prefix,
+                           cache.version(spaceId, prefix),
+                           std::make_unique<EdgeCacheIterator>(encodeRows(kvs)));
+    EXPECT_EQ(kvs, collect(iter.get()));
+    EXPECT_EQ(nullptr, cache.get(spaceId, prefix));
+}
+
+TEST(EdgeCacheTest, GetNeighborsTest) {
+    FLAGS_enable_edge_cache = true;
+    fs::TempDir rootPath("/tmp/EdgeCacheTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto* cache = cluster.edgeCache_.get();
+    ASSERT_NE(nullptr, cache);
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+
+    TagID player = 1;
+    EdgeType serve = 101;
+    std::vector<VertexID> vertices = {"Tim Duncan"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(player, std::vector<std::string>{"name", "age", "avgScore"});
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+
+    auto getNeighbors = [&] () {
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        return std::move(*resp.vertices_ref());
+    };
+
+    {
+        auto dataSet = getNeighbors();
+        // vId, stat, player, serve, expr
+        QueryTestUtils::checkResponse(dataSet, vertices, over, tags, edges, 1, 5);
+        EXPECT_EQ(0, cache->hits());
+    }
+    size_t serveCount = 0;
+    {
+        auto dataSet = getNeighbors();
+        QueryTestUtils::checkResponse(dataSet, vertices, over, tags, edges, 1, 5);
+        EXPECT_EQ(1, cache->hits());
+        serveCount = dataSet.rows[0].values[3].getList().values.size();
+        ASSERT_LT(0, serveCount);
+    }
+    {
+        // remove one serve edge of Tim Duncan, the commit of raft will evict the cache
+        auto vIdLen = env->schemaMan_->getSpaceVidLen(1).value();
+        std::hash<std::string> hash;
+        PartitionID partId = (hash("Tim Duncan") % totalParts) + 1;
+        auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, partId, "Tim Duncan", serve);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+                  env->kvstore_->prefix(1, partId, prefix, &iter));
+        ASSERT_TRUE(iter->valid());
+        auto key = iter->key().str();
+        auto invalidations = cache->invalidations();
+
+        folly::Baton<true, std::atomic> baton;
+        env->kvstore_->asyncRemove(1, partId, key, [&baton] (nebula::cpp2::ErrorCode code) {
+            EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+        EXPECT_LT(invalidations, cache->invalidations());
+
+        auto dataSet = getNeighbors();
+        ASSERT_EQ(1, dataSet.rows.size());
+        EXPECT_EQ(serveCount - 1, dataSet.rows[0].values[3].getList().values.size());
+    }
+    FLAGS_enable_edge_cache = false;
+}
+
+TEST(EdgeCacheTest, RemovePartTest) {
+    FLAGS_enable_edge_cache = true;
+    fs::TempDir rootPath("/tmp/EdgeCacheTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto* cache = cluster.edgeCache_.get();
+    ASSERT_NE(nullptr, cache);
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+
+    GraphSpaceID spaceId = 1;
+    EdgeType serve = 101;
+    std::vector<VertexID> vertices = {"Tim Duncan"};
+    std::vector<EdgeType> over = {serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+    {
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    }
+
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+    PartitionID partId = (std::hash<std::string>()("Tim Duncan") % totalParts) + 1;
+    auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, partId, "Tim Duncan", serve);
+    ASSERT_NE(nullptr, cache->get(spaceId, prefix));
+
+    // the part might be added back to this host later, the cached lists are not served any more
+    auto invalidations = cache->invalidations();
+    cluster.storageKV_->removePart(spaceId, partId);
+    EXPECT_LT(invalidations, cache->invalidations());
+    EXPECT_EQ(nullptr, cache->get(spaceId, prefix));
+    FLAGS_enable_edge_cache = false;
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,250 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/base/ObjectPool.h"
+#include <gtest/gtest.h>
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "common/meta/NebulaSchemaProvider.h"
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "storage/exec/FilterProgram.h"
+
+namespace nebula {
+namespace storage {
+
+ObjectPool objPool;
+auto pool = &objPool;
+
+const char kEdgeName[] = "serve";
+const char kTagName[] = "player";
+
+static std::shared_ptr<meta::NebulaSchemaProvider> buildSchema(SchemaVer ver) {
+    auto schema = std::make_shared<meta::NebulaSchemaProvider>(ver);
+    schema->addField("teamName", meta::cpp2::PropertyType::STRING);
+    schema->addField("startYear", meta::cpp2::PropertyType::INT64);
+    schema->addField("score", meta::cpp2::PropertyType::DOUBLE);
+    schema->addField("champion", meta::cpp2::PropertyType::BOOL);
+    schema->addField("games", meta::cpp2::PropertyType::INT32, 0, true);
+    if (ver > 0) {
+        schema->addField("endYear", meta::cpp2::PropertyType::INT64, 0, true);
+    }
+    return schema;
+}
+
+static std::string encode(const meta::NebulaSchemaProvider* schema,
+                          const std::string& teamName,
+                          int64_t startYear,
+                          double score,
+                          bool champion,
+                          Value games) {
+    RowWriterV2 writer(schema);
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("teamName", Value(teamName)));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("startYear", Value(startYear)));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("score", Value(score)));
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("champion", Value(champion)));
+    if (!games.isNull()) {
+        EXPECT_EQ(WriteResult::SUCCEEDED, writer.setValue("games", games));
+    }
+    EXPECT_EQ(WriteResult::SUCCEEDED, writer.finish());
+    return writer.moveEncodedStr();
+}
+
+using Rows = std::vector<std::pair<const meta::NebulaSchemaProvider*, std::string>>;
+
+static Expression* edgeProp(const std::string& prop) {
+    return EdgePropertyExpression::make(pool, kEdgeName, prop);
+}
+
+// Check each row by the program, the decided result should be the same as the expression
+static void verify(Expression* exp,
+                   const meta::NebulaSchemaProvider* latest,
+                   const Rows& rows,
+                   size_t expectDecided,
+                   const std::unordered_map<std::string, Value>& srcProps = {}) {
+    auto program = FilterProgram::compile(exp, true);
+    ASSERT_NE(nullptr, program) << exp->toString();
+
+    StorageExpressionContext expCtx(8, false, kEdgeName, latest, true);
+    for (const auto& prop : srcProps) {
+        expCtx.setTagProp(kTagName, prop.first, prop.second);
+    }
+    program->bindSrcProps(expCtx);
+
+    size_t decided = 0;
+    for (const auto& row : rows) {
+        auto reader = RowReaderWrapper::getRowReader(row.first, row.second);
+        ASSERT_TRUE(reader);
+        expCtx.reset(reader.get(), "");
+        auto value = exp->eval(expCtx).toBool();
+        bool expected = value.isBool() && value.getBool();
+
+        auto result = program->check(kEdgeName, latest, reader.get(), row.second);
+        if (result != FilterProgram::Result::kUnknown) {
+            decided++;
+            EXPECT_EQ(expected, result == FilterProgram::Result::kTrue) << exp->toString();
+        }
+    }
+    EXPECT_EQ(expectDecided, decided) << exp->toString();
+}
+
+TEST(FilterProgramTest, Compile) {
+    // supported
+    EXPECT_NE(nullptr, FilterProgram::compile(
+        RelationalExpression::makeGT(pool, edgeProp("startYear"),
+                                     ConstantExpression::make(pool, Value(2000))), true));
+    EXPECT_NE(nullptr, FilterProgram::compile(
+        LogicalExpression::makeAnd(
+            pool,
+            RelationalExpression::makeLE(pool, ConstantExpression::make(pool, Value(1.5)),
+                                         edgeProp("score")),
+            UnaryExpression::makeNot(
+                pool, UnaryExpression::makeIsNull(pool, edgeProp("games")))), true));
+    EXPECT_NE(nullptr, FilterProgram::compile(
+        RelationalExpression::makeIn(
+            pool, TagPropertyExpression::make(pool, kTagName, "teamName"),
+            ConstantExpression::make(pool, Value(List({"Spurs", "Rockets"})))), false));
+
+    // prop compared with prop
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeGT(pool, edgeProp("endYear"), edgeProp("startYear")), true));
+    // arithmetic
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeGT(
+            pool,
+            ArithmeticExpression::makeAdd(pool, edgeProp("startYear"),
+                                          ConstantExpression::make(pool, Value(1))),
+            ConstantExpression::make(pool, Value(2000))), true));
+    // props in the key
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeEQ(pool, edgeProp(kDst),
+                                     ConstantExpression::make(pool, Value("Spurs"))), true));
+    // ordering of bool
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeLT(pool, edgeProp("champion"),
+                                     ConstantExpression::make(pool, Value(true))), true));
+    // list of mixed types
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeIn(
+            pool, edgeProp("startYear"),
+            ConstantExpression::make(pool, Value(List({Value(2000), Value(1.0)})))), true));
+    // edge prop when checking vertices
+    EXPECT_EQ(nullptr, FilterProgram::compile(
+        RelationalExpression::makeGT(pool, edgeProp("startYear"),
+                                     ConstantExpression::make(pool, Value(2000))), false));
+}
+
+TEST(FilterProgramTest, Check) {
+    auto schema = buildSchema(0);
+    Rows rows;
+    rows.emplace_back(schema.get(), encode(schema.get(), "Spurs", 1997, 21.5, true, Value(82)));
+    rows.emplace_back(schema.get(), encode(schema.get(), "Rockets", 2004, 24.6, false, Value(78)));
+    rows.emplace_back(schema.get(), encode(schema.get(), "Magic", 2000, 32.1, false,
+                                           Value(NullType::__NULL__)));
+    rows.emplace_back(schema.get(), encode(schema.get(), "Raptors", 1997, 15.4, false, Value(64)));
+
+    // serve.startYear > 1999
+    verify(RelationalExpression::makeGT(pool, edgeProp("startYear"),
+                                        ConstantExpression::make(pool, Value(1999))),
+           schema.get(), rows, 4);
+    // 2000 >= serve.startYear
+    verify(RelationalExpression::makeGE(pool, ConstantExpression::make(pool, Value(2000)),
+                                        edgeProp("startYear")),
+           schema.get(), rows, 4);
+    // serve.score < 22.0 and serve.champion == false
+    verify(LogicalExpression::makeAnd(
+               pool,
+               RelationalExpression::makeLT(pool, edgeProp("score"),
+                                            ConstantExpression::make(pool, Value(22.0))),
+               RelationalExpression::makeEQ(pool, edgeProp("champion"),
+                                            ConstantExpression::make(pool, Value(false)))),
+           schema.get(), rows, 4);
+    // serve.teamName in ["Spurs", "Magic"] or not (serve.teamName != "Raptors")
+    verify(LogicalExpression::makeOr(
+               pool,
+               RelationalExpression::makeIn(
+                   pool, edgeProp("teamName"),
+                   ConstantExpression::make(pool, Value(List({"Spurs", "Magic"})))),
+               UnaryExpression::makeNot(
+                   pool,
+                   RelationalExpression::makeNE(pool, edgeProp("teamName"),
+                                                ConstantExpression::make(pool,
+                                                                         Value("Raptors"))))),
+           schema.get(), rows, 4);
+    // serve.games is null, decided for the null row too
+    verify(UnaryExpression::makeIsNull(pool, edgeProp("games")), schema.get(), rows, 4);
+    verify(UnaryExpression::makeIsNotNull(pool, edgeProp("games")), schema.get(), rows, 4);
+    // serve.games not in [82, 64], null is left to the expression
+    verify(RelationalExpression::makeNotIn(
+               pool, edgeProp("games"),
+               ConstantExpression::make(pool, Value(List({Value(82), Value(64)})))),
+           schema.get(), rows, 3);
+    // int prop compared with double, left to the expression
+    verify(RelationalExpression::makeGT(pool, edgeProp("games"),
+                                        ConstantExpression::make(pool, Value(70.0))),
+           schema.get(), rows, 0);
+    // prop of another edge, or not in the schema
+    verify(RelationalExpression::makeGT(pool,
+                                        EdgePropertyExpression::make(pool, "like", "startYear"),
+                                        ConstantExpression::make(pool, Value(1999))),
+           schema.get(), rows, 0);
+    verify(RelationalExpression::makeGT(pool, edgeProp("notExist"),
+                                        ConstantExpression::make(pool, Value(1999))),
+           schema.get(), rows, 0);
+}
+
+TEST(FilterProgramTest, SchemaVersions) {
+    auto oldSchema = buildSchema(0);
+    auto newSchema = buildSchema(1);
+    Rows rows;
+    rows.emplace_back(oldSchema.get(),
+                      encode(oldSchema.get(), "Spurs", 1997, 21.5, true, Value(82)));
+    rows.emplace_back(newSchema.get(),
+                      encode(newSchema.get(), "Rockets", 2004, 24.6, false, Value(78)));
+    rows.emplace_back(oldSchema.get(),
+                      encode(oldSchema.get(), "Magic", 2000, 32.1, false, Value(64)));
+
+    // The props in both versions are decided for all rows
+    verify(RelationalExpression::makeLT(pool, edgeProp("startYear"),
+                                        ConstantExpression::make(pool, Value(2001))),
+           newSchema.get(), rows, 3);
+    // endYear is missing in the rows of the old version, which may have a default value
+    verify(UnaryExpression::makeIsNull(pool, edgeProp("endYear")), newSchema.get(), rows, 1);
+}
+
+TEST(FilterProgramTest, SrcProps) {
+    auto schema = buildSchema(0);
+    Rows rows;
+    rows.emplace_back(schema.get(), encode(schema.get(), "Spurs", 1997, 21.5, true, Value(82)));
+    rows.emplace_back(schema.get(), encode(schema.get(), "Rockets", 2004, 24.6, false, Value(78)));
+
+    // $^.player.age > 30 and serve.champion == true
+    auto* exp = LogicalExpression::makeAnd(
+        pool,
+        RelationalExpression::makeGT(pool, SourcePropertyExpression::make(pool, kTagName, "age"),
+                                     ConstantExpression::make(pool, Value(30))),
+        RelationalExpression::makeEQ(pool, edgeProp("champion"),
+                                     ConstantExpression::make(pool, Value(true))));
+    verify(exp, schema.get(), rows, 2, {{"age", Value(35)}});
+    verify(exp, schema.get(), rows, 2, {{"age", Value(25)}});
+    // vertex without the tag
+    verify(exp, schema.get(), rows, 0);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
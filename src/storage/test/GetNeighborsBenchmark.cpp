@@ -10,6 +10,8 @@
 #include "storage/query/GetNeighborsProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 #include "storage/exec/EdgeNode.h"
+#include "storage/StorageFlags.h"
+#include "mock/MockData.h"
 
 DEFINE_uint64(max_rank, 1000, "max rank of each edge");
 DEFINE_double(filter_ratio, 0.1, "ratio of data would pass filter");
@@ -107,6 +109,25 @@ void go(int32_t iters,
     }
 }
 
+// All players, executed with the given query_batch_size
+void goAllPlayers(int32_t iters,
+                  const std::vector<std::string>& playerProps,
+                  const std::vector<std::string>& serveProps,
+                  int32_t batchSize) {
+    std::vector<nebula::VertexID> vertex;
+    int32_t oldBatchSize = FLAGS_query_batch_size;
+    BENCHMARK_SUSPEND {
+        for (const auto& player : nebula::mock::MockData::players_) {
+            vertex.emplace_back(player.name_);
+        }
+        FLAGS_query_batch_size = batchSize;
+    }
+    go(iters, vertex, playerProps, serveProps);
+    BENCHMARK_SUSPEND {
+        FLAGS_query_batch_size = oldBatchSize;
+    }
+}
+
 void goFilter(int32_t iters,
               const std::vector<nebula::VertexID>& vertex,
               const std::vector<std::string>& playerProps,
@@ -436,6 +457,21 @@ BENCHMARK_RELATIVE(TenVertexOneProperyOnlyKV, iters) {
         {"teamName"});
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(AllVertexOnePropertyNoBatch, iters) {
+    goAllPlayers(iters, {"name"}, {"teamName"}, 0);
+}
+BENCHMARK_RELATIVE(AllVertexOnePropertyInBatch, iters) {
+    goAllPlayers(iters, {"name"}, {"teamName"}, 256);
+}
+BENCHMARK(AllVertexFiveTagPropertyNoBatch, iters) {
+    goAllPlayers(iters, {"name", "age", "avgScore", "serveTeams", "country"}, {nebula::kDst}, 0);
+}
+BENCHMARK_RELATIVE(AllVertexFiveTagPropertyInBatch, iters) {
+    goAllPlayers(iters, {"name", "age", "avgScore", "serveTeams", "country"}, {nebula::kDst}, 256);
+}
+
 int main(int argc, char** argv) {
     folly::init(&argc, &argv, true);
     nebula::fs::TempDir rootPath("/tmp/GetNeighborsBenchmark.XXXXXX");
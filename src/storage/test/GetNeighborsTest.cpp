@@ -882,6 +882,57 @@ TEST(GetNeighborsTest, MaxEdgReturnedPerVertexTest) {
 }
 
 
+TEST(GetNeighborsTest, MaxEdgesReturnedPerResponseTest) {
+    fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+    TagID team = 2;
+    EdgeType serve = 101;
+    std::vector<VertexID> vertices = {"Spurs"};
+    std::vector<EdgeType> over = {-serve};
+    std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+    std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+    tags.emplace_back(team, std::vector<std::string>{"name"});
+    edges.emplace_back(-serve, std::vector<std::string>{"playerName", "startYear", "teamCareer"});
+    auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+    auto defaultVal = FLAGS_max_edges_returned_per_response;
+    for (auto concurrently : {false, true}) {
+        FLAGS_query_concurrently = concurrently;
+        {
+            LOG(INFO) << "WithinLimit, concurrently " << concurrently;
+            FLAGS_max_edges_returned_per_response = 1000;
+            auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+            auto fut = processor->getFuture();
+            processor->process(req);
+            auto resp = std::move(fut).get();
+            ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+            ASSERT_EQ(1, (*resp.vertices_ref()).rows.size());
+        }
+        {
+            // Spurs has more than 5 -serve edges, the part is not finished
+            LOG(INFO) << "OutOfLimit, concurrently " << concurrently;
+            FLAGS_max_edges_returned_per_response = 5;
+            auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+            auto fut = processor->getFuture();
+            processor->process(req);
+            auto resp = std::move(fut).get();
+            ASSERT_EQ(1, (*resp.result_ref()).failed_parts.size());
+            ASSERT_EQ(nebula::cpp2::ErrorCode::E_PARTIAL_RESULT,
+                      (*resp.result_ref()).failed_parts[0].code);
+            ASSERT_EQ(0, (*resp.vertices_ref()).rows.size());
+        }
+    }
+    FLAGS_query_concurrently = false;
+    FLAGS_max_edges_returned_per_response = defaultVal;
+}
+
 TEST(GetNeighborsTest, VertexCacheTest) {
     fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
     mock::MockCluster cluster;
@@ -1846,6 +1897,86 @@ TEST(GetNeighborsTest, FilterTest) {
     }
 }
 
+TEST(GetNeighborsTest, SuperVertexTest) {
+    FLAGS_query_concurrently = true;
+    fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+    TagID player = 1;
+    EdgeType serve = 101;
+    EdgeType teammate = 102;
+
+    auto go = [&] (int32_t threshold, int64_t limit) {
+        FLAGS_super_vertex_threshold = threshold;
+        std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker", "LeBron James",
+                                          "Dwight Howard", "Not Exist"};
+        std::vector<EdgeType> over = {serve, teammate};
+        std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+        std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+        tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+        edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", kDst});
+        edges.emplace_back(teammate, std::vector<std::string>{"player2", "teamName"});
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+        std::vector<cpp2::StatProp> statProps;
+        std::vector<std::pair<std::string, cpp2::StatType>> stats = {
+            {"teamGames", cpp2::StatType::SUM},
+            {"teamGames", cpp2::StatType::AVG},
+            {"teamCareer", cpp2::StatType::MAX},
+            {"startYear", cpp2::StatType::MIN},
+            {"teamGames", cpp2::StatType::COUNT}};
+        for (const auto& stat : stats) {
+            cpp2::StatProp statProp;
+            statProp.set_alias(stat.first);
+            const auto& exp =
+                *EdgePropertyExpression::make(pool, folly::to<std::string>(serve), stat.first);
+            statProp.set_prop(Expression::encode(exp));
+            statProp.set_stat(stat.second);
+            statProps.emplace_back(std::move(statProp));
+        }
+        (*req.traverse_spec_ref()).set_stat_props(std::move(statProps));
+        if (limit > 0) {
+            (*req.traverse_spec_ref()).set_limit(limit);
+        }
+
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        // the rows of super vertices are in the same order as the others
+        return std::move(*resp.vertices_ref());
+    };
+
+    {
+        LOG(INFO) << "SplitByEdgeTypeAndDst";
+        FLAGS_super_vertex_split_num = 4;
+        auto expected = go(0, 0);
+        ASSERT_EQ(5, expected.rows.size());
+        EXPECT_EQ(expected, go(1, 0));
+        EXPECT_EQ(expected, go(3, 0));
+    }
+    {
+        LOG(INFO) << "SplitByEdgeTypeOnly";
+        FLAGS_super_vertex_split_num = 1;
+        EXPECT_EQ(go(0, 0), go(1, 0));
+    }
+    {
+        LOG(INFO) << "Limit";
+        FLAGS_super_vertex_split_num = 4;
+        EXPECT_EQ(go(0, 3), go(1, 3));
+        EXPECT_EQ(go(0, 100), go(1, 100));
+    }
+    FLAGS_super_vertex_threshold = 0;
+    FLAGS_super_vertex_split_num = 8;
+    FLAGS_query_concurrently = false;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
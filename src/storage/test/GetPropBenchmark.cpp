@@ -0,0 +1,170 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include <gtest/gtest.h>
+#include <folly/Benchmark.h>
+#include "common/fs/TempDir.h"
+#include "storage/query/GetPropProcessor.h"
+#include "storage/test/QueryTestUtils.h"
+#include "storage/StorageFlags.h"
+#include "mock/MockData.h"
+
+DEFINE_int32(vertex_repeat, 100, "times each player is repeated in the large requests");
+
+std::unique_ptr<nebula::mock::MockCluster> gCluster;
+
+namespace nebula {
+namespace storage {
+
+cpp2::GetPropRequest buildRequest(const std::vector<VertexID>& vertices,
+                                  const std::vector<std::string>& playerProps) {
+    TagID player = 1;
+    std::hash<std::string> hash;
+    auto totalParts = gCluster->getTotalParts();
+    cpp2::GetPropRequest req;
+    req.set_space_id(1);
+    for (const auto& vertex : vertices) {
+        PartitionID partId = (hash(vertex) % totalParts) + 1;
+        nebula::Row row;
+        row.values.emplace_back(vertex);
+        (*req.parts_ref())[partId].emplace_back(std::move(row));
+    }
+    std::vector<cpp2::VertexProp> vertexProps;
+    cpp2::VertexProp tagProp;
+    tagProp.set_tag(player);
+    for (const auto& prop : playerProps) {
+        (*tagProp.props_ref()).emplace_back(prop);
+    }
+    vertexProps.emplace_back(std::move(tagProp));
+    req.set_vertex_props(std::move(vertexProps));
+    return req;
+}
+
+void setUp(const char* path) {
+    gCluster = std::make_unique<nebula::mock::MockCluster>();
+    gCluster->initStorageKV(path);
+    auto* env = gCluster->storageEnv_.get();
+    auto totalParts = gCluster->getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+std::vector<nebula::VertexID> players(int32_t repeat) {
+    std::vector<nebula::VertexID> vertices;
+    for (int32_t i = 0; i < repeat; i++) {
+        for (const auto& player : nebula::mock::MockData::players_) {
+            vertices.emplace_back(player.name_);
+        }
+    }
+    return vertices;
+}
+
+// Get the props of the players by GetPropProcessor, executed with the given query_batch_size
+void getProp(int32_t iters,
+             int32_t repeat,
+             const std::vector<std::string>& playerProps,
+             int32_t batchSize) {
+    nebula::storage::cpp2::GetPropRequest req;
+    int32_t oldBatchSize = FLAGS_query_batch_size;
+    BENCHMARK_SUSPEND {
+        req = nebula::storage::buildRequest(players(repeat), playerProps);
+        FLAGS_query_batch_size = batchSize;
+    }
+    auto* env = gCluster->storageEnv_.get();
+    for (decltype(iters) i = 0; i < iters; i++) {
+        auto* processor = nebula::storage::GetPropProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        CHECK_EQ(0, resp.result.failed_parts.size());
+        folly::doNotOptimizeAway(resp);
+    }
+    BENCHMARK_SUSPEND {
+        FLAGS_query_batch_size = oldBatchSize;
+    }
+}
+
+// Read the vertex keys of each part directly, by a prefix iterator for each key or by multiGet
+void kv(int32_t iters, int32_t repeat, bool multiGet) {
+    nebula::GraphSpaceID spaceId = 1;
+    nebula::TagID player = 1;
+    auto* env = gCluster->storageEnv_.get();
+    std::unordered_map<nebula::PartitionID, std::vector<std::string>> keys;
+    BENCHMARK_SUSPEND {
+        std::hash<std::string> hash;
+        auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+        auto totalParts = gCluster->getTotalParts();
+        for (const auto& vId : players(repeat)) {
+            nebula::PartitionID partId = (hash(vId) % totalParts) + 1;
+            keys[partId].emplace_back(
+                nebula::NebulaKeyUtils::vertexKey(vIdLen, partId, vId, player));
+        }
+    }
+    for (decltype(iters) i = 0; i < iters; i++) {
+        for (const auto& [partId, partKeys] : keys) {
+            if (multiGet) {
+                std::vector<std::string> values;
+                auto ret = env->kvstore_->multiGet(spaceId, partId, partKeys, &values);
+                CHECK_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret.first);
+                folly::doNotOptimizeAway(values);
+            } else {
+                for (const auto& key : partKeys) {
+                    std::unique_ptr<nebula::kvstore::KVIterator> iter;
+                    auto code = env->kvstore_->prefix(spaceId, partId, key, &iter);
+                    CHECK_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+                    CHECK(iter->valid());
+                    auto val = iter->val();
+                    folly::doNotOptimizeAway(val);
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(AllPlayersOnePropertyNoBatch, iters) {
+    getProp(iters, 1, {"name"}, 0);
+}
+BENCHMARK_RELATIVE(AllPlayersOnePropertyInBatch, iters) {
+    getProp(iters, 1, {"name"}, 256);
+}
+BENCHMARK(AllPlayersFivePropertyNoBatch, iters) {
+    getProp(iters, 1, {"name", "age", "avgScore", "serveTeams", "country"}, 0);
+}
+BENCHMARK_RELATIVE(AllPlayersFivePropertyInBatch, iters) {
+    getProp(iters, 1, {"name", "age", "avgScore", "serveTeams", "country"}, 256);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RepeatedPlayersNoBatch, iters) {
+    getProp(iters, FLAGS_vertex_repeat, {"name"}, 0);
+}
+BENCHMARK_RELATIVE(RepeatedPlayersInBatch, iters) {
+    getProp(iters, FLAGS_vertex_repeat, {"name"}, 256);
+}
+BENCHMARK_RELATIVE(RepeatedPlayersInLargeBatch, iters) {
+    getProp(iters, FLAGS_vertex_repeat, {"name"}, 4096);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RepeatedPlayersOnlyKVPrefix, iters) {
+    kv(iters, FLAGS_vertex_repeat, false);
+}
+BENCHMARK_RELATIVE(RepeatedPlayersOnlyKVMultiGet, iters) {
+    kv(iters, FLAGS_vertex_repeat, true);
+}
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    nebula::fs::TempDir rootPath("/tmp/GetPropBenchmark.XXXXXX");
+    nebula::storage::setUp(rootPath.path());
+    folly::runBenchmarks();
+    gCluster.reset();
+    return 0;
+}
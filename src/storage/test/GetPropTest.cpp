@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include "common/fs/TempDir.h"
 #include "kvstore/RocksEngineConfig.h"
+#include "storage/StorageFlags.h"
 #include "storage/query/GetPropProcessor.h"
 #include "storage/test/QueryTestUtils.h"
 
@@ -680,6 +681,64 @@ TEST(QueryVertexPropsTest, PrefixBloomFilterTest) {
     FLAGS_enable_rocksdb_prefix_filtering = false;
 }
 
+TEST(GetPropTest, TraceTest) {
+    fs::TempDir rootPath("/tmp/GetPropTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+
+    TagID player = 1;
+    FLAGS_request_trace_sample_rate = 1;
+    FLAGS_slow_request_log_size = 2;
+    SlowRequestLog::instance().clear();
+    std::vector<VertexID> vertices = {"Tim Duncan", "Tony Parker", "Manu Ginobili"};
+    for (size_t i = 1; i <= vertices.size(); i++) {
+        std::vector<VertexID> request(vertices.begin(), vertices.begin() + i);
+        std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+        tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+        auto req = buildVertexRequest(totalParts, request, tags);
+
+        auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        ASSERT_EQ(i, (*resp.props_ref()).rows.size());
+    }
+
+    // only the slowest two are kept, slowest first
+    auto traces = SlowRequestLog::instance().toJson();
+    ASSERT_EQ(2, traces.size());
+    ASSERT_GE(traces[0]["latency_us"].asInt(), traces[1]["latency_us"].asInt());
+    for (const auto& trace : traces) {
+        ASSERT_EQ("getProps", trace["name"].asString());
+        ASSERT_EQ(1, trace["space"].asInt());
+        ASSERT_EQ(0, trace["failed_parts"].asInt());
+        auto rows = trace["rows_returned"].asInt();
+        ASSERT_GE(rows, 1);
+        ASSERT_GT(trace["keys_read"].asInt(), 0);
+        ASSERT_GT(trace["bytes_read"].asInt(), 0);
+    }
+
+    // not traced when the sample rate is 0
+    SlowRequestLog::instance().clear();
+    FLAGS_request_trace_sample_rate = 0;
+    {
+        std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+        tags.emplace_back(player, std::vector<std::string>{"name"});
+        auto req = buildVertexRequest(totalParts, vertices, tags);
+        auto* processor = GetPropProcessor::instance(env, nullptr, nullptr);
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    }
+    ASSERT_EQ(0, SlowRequestLog::instance().toJson().size());
+    FLAGS_slow_request_log_size = 100;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -1096,6 +1096,63 @@ TEST_P(LookupIndexTest, EdgeIndexWithDataTest) {
     }
 }
 
+// The rows of the index hits are fetched in batches of different sizes
+TEST_P(LookupIndexTest, TagIndexWithDataInBatchesTest) {
+    fs::TempDir rootPath("/tmp/TagIndexWithDataInBatchesTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    GraphSpaceID spaceId = 1;
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_TRUE(QueryTestUtils::mockVertexData(env, totalParts, true, false));
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+    auto batchSize = FLAGS_index_fetch_batch_size;
+    for (int32_t size : {1, 7, 256}) {
+        FLAGS_index_fetch_batch_size = size;
+        auto* processor = LookupProcessor::instance(env, nullptr, threadPool.get());
+        cpp2::LookupIndexRequest req;
+        nebula::storage::cpp2::IndexSpec indices;
+        req.set_space_id(spaceId);
+        indices.set_tag_or_edge_id(1);
+        indices.set_is_edge(false);
+        std::vector<PartitionID> parts;
+        for (int32_t p = 1; p <= totalParts; p++) {
+            parts.emplace_back(p);
+        }
+        req.set_parts(std::move(parts));
+        cpp2::IndexQueryContext context1;
+        context1.set_filter("");
+        context1.set_index_id(4);
+        decltype(indices.contexts) contexts;
+        contexts.emplace_back(std::move(context1));
+        indices.set_contexts(std::move(contexts));
+        req.set_indices(std::move(indices));
+        // name is not in the index, so the rows are read
+        req.set_return_columns({kVid, kTag, "name"});
+
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        std::vector<std::string> expectCols = {std::string("1.").append(kVid),
+                                               std::string("1.").append(kTag),
+                                               "1.name"};
+        decltype(resp.get_data()->rows) expectRows;
+
+        auto playerVerticeId = mock::MockData::mockPlayerVerticeIds();
+        for (auto& vId : playerVerticeId) {
+            Row row;
+            row.emplace_back(vId);
+            row.emplace_back(1);
+            row.emplace_back(vId);
+            expectRows.emplace_back(std::move(row));
+        }
+
+        QueryTestUtils::checkResponse(resp, expectCols, expectRows);
+    }
+    FLAGS_index_fetch_batch_size = batchSize;
+}
+
 // Tag has prop, statistics vertices
 TEST_P(LookupIndexTest, TagWithPropStatisVerticesIndexTest) {
     fs::TempDir rootPath("/tmp/TagWithPropStatisVerticesIndexTest.XXXXXX");
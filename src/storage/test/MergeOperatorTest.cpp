@@ -0,0 +1,172 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
+#include "codec/RowReaderWrapper.h"
+#include "codec/RowWriterV2.h"
+#include "common/meta/NebulaSchemaProvider.h"
+#include "kvstore/LogEncoder.h"
+#include "kvstore/RocksEngine.h"
+#include "storage/MergeOperator.h"
+#include "mock/MockCluster.h"
+
+namespace nebula {
+namespace storage {
+
+static void merge(kvstore::KVEngine* engine, std::vector<kvstore::KV> operands) {
+    auto batch = engine->startBatchWrite();
+    for (auto& kv : operands) {
+        ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, batch->merge(kv.first, kv.second));
+    }
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              engine->commitBatchWrite(std::move(batch), false, false, true));
+}
+
+static int64_t toInt64(const std::string& val) {
+    CHECK_EQ(sizeof(int64_t), val.size());
+    int64_t v;
+    memcpy(reinterpret_cast<void*>(&v), val.data(), sizeof(int64_t));
+    return v;
+}
+
+TEST(MergeOperatorTest, AddAndAppend) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    auto engine = std::make_unique<kvstore::RocksEngine>(
+        0, 8, rootPath.path(), "", std::make_shared<NebulaOperator>());
+
+    merge(engine.get(), {{"counter", NebulaOperator::addOperand(5)},
+                         {"counter", NebulaOperator::addOperand(-2)},
+                         {"list", NebulaOperator::appendOperand("a")}});
+    merge(engine.get(), {{"counter", NebulaOperator::addOperand(10)},
+                         {"list", NebulaOperator::appendOperand("bc")}});
+
+    std::string val;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("counter", &val));
+    EXPECT_EQ(13, toInt64(val));
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("list", &val));
+    EXPECT_EQ("abc", val);
+
+    // Operands are folded during compaction, the result should be the same
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+    merge(engine.get(), {{"counter", NebulaOperator::addOperand(1)}});
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->compact());
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("counter", &val));
+    EXPECT_EQ(14, toInt64(val));
+
+    // Put overwrites the value, merge works on the new one
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put("list", "x"));
+    merge(engine.get(), {{"list", NebulaOperator::appendOperand("y")}});
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("list", &val));
+    EXPECT_EQ("xy", val);
+
+    // An operand which doesn't match the value is dropped
+    merge(engine.get(), {{"list", NebulaOperator::addOperand(1)}});
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("list", &val));
+    EXPECT_EQ("xy", val);
+}
+
+TEST(MergeOperatorTest, AddField) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    auto engine = std::make_unique<kvstore::RocksEngine>(
+        0, 8, rootPath.path(), "", std::make_shared<NebulaOperator>());
+
+    meta::NebulaSchemaProvider schema(3);
+    schema.addField("name", meta::cpp2::PropertyType::STRING);
+    schema.addField("count", meta::cpp2::PropertyType::INT64);
+    schema.addField("nullableCount", meta::cpp2::PropertyType::INT32, 0, true);
+    schema.addField("smallCount", meta::cpp2::PropertyType::INT16, 0, true);
+
+    RowWriterV2 writer(&schema);
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.setValue("name", Value("Tim Duncan")));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.setValue("count", Value(10L)));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.setValue("smallCount", Value(1L)));
+    ASSERT_EQ(WriteResult::SUCCEEDED, writer.finish());
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->put("row", writer.getEncodedStr()));
+
+    auto operand = [&] (const std::string& prop, int64_t delta) {
+        auto ret = NebulaOperator::addFieldOperand(&schema, prop, delta);
+        CHECK(ret.ok());
+        return std::move(ret).value();
+    };
+    merge(engine.get(), {{"row", operand("count", 5)},
+                         {"row", operand("count", 7)},
+                         {"row", operand("nullableCount", 1)},
+                         {"row", operand("smallCount", 2)}});
+    EXPECT_FALSE(NebulaOperator::addFieldOperand(&schema, "name", 1).ok());
+    EXPECT_FALSE(NebulaOperator::addFieldOperand(&schema, "notExist", 1).ok());
+
+    std::string val;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("row", &val));
+    auto reader = RowReaderWrapper::getRowReader(&schema, val);
+    ASSERT_TRUE(reader);
+    EXPECT_EQ("Tim Duncan", reader->getValueByName("name").getStr());
+    EXPECT_EQ(22, reader->getValueByName("count").getInt());
+    // null + 1 is still null
+    EXPECT_EQ(Value(NullType::__NULL__), reader->getValueByName("nullableCount"));
+    EXPECT_EQ(3, reader->getValueByName("smallCount").getInt());
+
+    // The operand of another schema version is dropped
+    meta::NebulaSchemaProvider newSchema(4);
+    newSchema.addField("name", meta::cpp2::PropertyType::STRING);
+    newSchema.addField("count", meta::cpp2::PropertyType::INT64);
+    auto ret = NebulaOperator::addFieldOperand(&newSchema, "count", 100);
+    ASSERT_TRUE(ret.ok());
+    merge(engine.get(), {{"row", std::move(ret).value()}});
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->get("row", &val));
+    auto newReader = RowReaderWrapper::getRowReader(&schema, val);
+    ASSERT_TRUE(newReader);
+    EXPECT_EQ(22, newReader->getValueByName("count").getInt());
+}
+
+TEST(MergeOperatorTest, ReplicatedMerge) {
+    fs::TempDir rootPath("/tmp/MergeOperatorTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* kv = cluster.storageEnv_->kvstore_;
+
+    for (int i = 0; i < 10; i++) {
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMerge(1, 1, "counter", NebulaOperator::addOperand(i),
+                       [&baton] (nebula::cpp2::ErrorCode code) {
+            EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+    {
+        // merge in a batch along with put
+        kvstore::BatchHolder batchHolder;
+        batchHolder.put("list", "a");
+        batchHolder.merge("list", NebulaOperator::appendOperand("b"));
+        batchHolder.merge("counter", NebulaOperator::addOperand(100));
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncAppendBatch(1, 1, kvstore::encodeBatchValue(batchHolder.getBatch()),
+                             [&baton] (nebula::cpp2::ErrorCode code) {
+            EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+            baton.post();
+        });
+        baton.wait();
+    }
+
+    std::string val;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, kv->get(1, 1, "counter", &val));
+    EXPECT_EQ(145, toInt64(val));
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, kv->get(1, 1, "list", &val));
+    EXPECT_EQ("ab", val);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
+#include "kvstore/Part.h"
+#include "storage/StorageFlags.h"
 #include "storage/admin/AdminTaskManager.h"
 #include "storage/admin/RebuildTagIndexTask.h"
 #include "storage/admin/RebuildEdgeIndexTask.h"
@@ -17,6 +19,7 @@
 #include "storage/mutate/DeleteVerticesProcessor.h"
 #include "storage/mutate/DeleteEdgesProcessor.h"
 #include "storage/test/TestUtils.h"
+#include "utils/OperationKeyUtils.h"
 
 namespace nebula {
 namespace storage {
@@ -397,6 +400,136 @@ TEST_F(RebuildIndexTest, RebuildTagIndex) {
     sleep(1);
 }
 
+TEST_F(RebuildIndexTest, RebuildTagIndexByIngest) {
+    // Each batch is dumped into a SST file, so that there are overlapped runs
+    FLAGS_rebuild_index_sst_buffer_mb = 0;
+    FLAGS_rebuild_index_batch_num = 10;
+
+    // Add Vertices
+    auto* processor = AddVerticesProcessor::instance(RebuildIndexTest::env_, nullptr);
+    cpp2::AddVerticesRequest req = mock::MockData::mockAddVerticesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+
+    std::vector<PartitionID> parts = {1, 2, 3, 4, 5, 6};
+    auto runTask = [&] (TaskID taskId, std::vector<std::string> paras) {
+        cpp2::TaskPara parameter;
+        parameter.set_space_id(1);
+        parameter.set_parts(parts);
+        parameter.set_task_specfic_paras(std::move(paras));
+
+        cpp2::AddAdminTaskRequest request;
+        request.set_cmd(meta::cpp2::AdminCmd::REBUILD_TAG_INDEX);
+        request.set_job_id(4);
+        request.set_task_id(taskId);
+        request.set_para(std::move(parameter));
+
+        auto callback = [](nebula::cpp2::ErrorCode, nebula::meta::cpp2::StatisItem&) {};
+        TaskContext context(request, callback);
+
+        auto task = std::make_shared<RebuildTagIndexTask>(RebuildIndexTest::env_,
+                                                          std::move(context));
+        manager_->addAsyncTask(task);
+
+        // Wait for the task finished
+        do {
+            usleep(50);
+        } while (!manager_->isFinished(context.jobId_, context.taskId_));
+    };
+
+    // The ingest round, the leaders stay BUILDING until the operation logs are replayed
+    runTask(14, {kRebuildIndexIngest, "4", "5"});
+    for (auto part : parts) {
+        auto iter = RebuildIndexTest::env_->rebuildIndexGuard_->find(std::make_tuple(1, part));
+        ASSERT_NE(RebuildIndexTest::env_->rebuildIndexGuard_->cend(), iter);
+        EXPECT_EQ(IndexState::BUILDING, iter->second);
+    }
+
+    // The replay round
+    runTask(15, {kRebuildIndexReplay, "4", "5"});
+    for (auto part : parts) {
+        auto iter = RebuildIndexTest::env_->rebuildIndexGuard_->find(std::make_tuple(1, part));
+        ASSERT_NE(RebuildIndexTest::env_->rebuildIndexGuard_->cend(), iter);
+        EXPECT_EQ(IndexState::FINISHED, iter->second);
+    }
+
+    // Check the result
+    LOG(INFO) << "Check rebuild tag index by ingest...";
+    for (auto& key : mock::MockData::mockPlayerIndexKeys()) {
+        std::string value;
+        auto code = RebuildIndexTest::env_->kvstore_->get(1, key.first, key.second, &value);
+        EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+    }
+
+    FLAGS_rebuild_index_sst_buffer_mb = 64;
+    FLAGS_rebuild_index_batch_num = 1024;
+    RebuildIndexTest::env_->rebuildIndexGuard_->clear();
+    sleep(1);
+}
+
+TEST_F(RebuildIndexTest, RebuildTagIndexByIngestOnFollower) {
+    fs::TempDir rootPath("/tmp/RebuildTagIndexByIngestOnFollower.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+
+    // Add Vertices
+    auto* processor = AddVerticesProcessor::instance(env, nullptr);
+    cpp2::AddVerticesRequest req = mock::MockData::mockAddVerticesReq();
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, resp.result.failed_parts.size());
+
+    // Stop the raft of the parts, so that they are followers
+    std::vector<PartitionID> parts = {1, 2, 3, 4, 5, 6};
+    for (auto part : parts) {
+        auto partRet = env->kvstore_->part(1, part);
+        ASSERT_TRUE(nebula::ok(partRet));
+        nebula::value(partRet)->stop();
+        ASSERT_FALSE(nebula::value(partRet)->isLeader());
+    }
+
+    cpp2::TaskPara parameter;
+    parameter.set_space_id(1);
+    parameter.set_parts(parts);
+    parameter.set_task_specfic_paras({kRebuildIndexIngest, "4", "5"});
+
+    cpp2::AddAdminTaskRequest request;
+    request.set_cmd(meta::cpp2::AdminCmd::REBUILD_TAG_INDEX);
+    request.set_job_id(5);
+    request.set_task_id(16);
+    request.set_para(std::move(parameter));
+
+    auto callback = [](nebula::cpp2::ErrorCode, nebula::meta::cpp2::StatisItem&) {};
+    TaskContext context(request, callback);
+
+    auto task = std::make_shared<RebuildTagIndexTask>(env, std::move(context));
+    manager_->addAsyncTask(task);
+
+    // Wait for the task finished
+    do {
+        usleep(50);
+    } while (!manager_->isFinished(context.jobId_, context.taskId_));
+
+    // The followers are FINISHED after ingesting, nothing is left to replay on them
+    for (auto part : parts) {
+        auto iter = env->rebuildIndexGuard_->find(std::make_tuple(1, part));
+        ASSERT_NE(env->rebuildIndexGuard_->cend(), iter);
+        EXPECT_EQ(IndexState::FINISHED, iter->second);
+    }
+
+    // Check the result
+    LOG(INFO) << "Check rebuild tag index on follower...";
+    for (auto& key : mock::MockData::mockPlayerIndexKeys()) {
+        std::string value;
+        auto ret = env->kvstore_->get(1, key.first, key.second, &value, true);
+        EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+    }
+}
+
 TEST_F(RebuildIndexTest, RebuildEdgeIndexWithDelete) {
     auto writer = std::make_unique<thread::GenericWorker>();
     EXPECT_TRUE(writer->start());
@@ -227,6 +227,43 @@ BENCHMARK_RELATIVE(recursive_chain, iters) {
     }
 }
 
+BENCHMARK_DRAW_LINE();
+
+// Execute 100 vertices of the same part, one by one or in a batch
+std::vector<std::string> batchInput() {
+    std::vector<std::string> input;
+    for (size_t i = 0; i < 100; i++) {
+        input.emplace_back(folly::to<std::string>(i));
+    }
+    return input;
+}
+
+BENCHMARK(recursive_chain_one_by_one, iters) {
+    StoragePlan<std::string> dag;
+    std::vector<std::string> input;
+    BENCHMARK_SUSPEND {
+        dag = chainStorageDAG();
+        input = batchInput();
+    }
+    for (size_t i = 0; i < iters; i++) {
+        for (const auto& vId : input) {
+            dag.go(0, vId);
+        }
+    }
+}
+
+BENCHMARK_RELATIVE(recursive_chain_batch, iters) {
+    StoragePlan<std::string> dag;
+    std::vector<std::string> input;
+    BENCHMARK_SUSPEND {
+        dag = chainStorageDAG();
+        input = batchInput();
+    }
+    for (size_t i = 0; i < iters; i++) {
+        dag.go(0, input);
+    }
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -6,6 +6,7 @@
 
 #include "common/base/Base.h"
 #include <gtest/gtest.h>
+#include "storage/StorageFlags.h"
 #include "storage/exec/StoragePlan.h"
 
 namespace nebula {
@@ -72,6 +73,86 @@ TEST_F(StorageDAGTest, RerunTest) {
     }
 }
 
+// Record the batches and the input it executes
+class BatchNode : public RelNode<VertexID> {
+public:
+    nebula::cpp2::ErrorCode execute(PartitionID partId, const VertexID& vId) override {
+        auto ret = RelNode::execute(partId, vId);
+        if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            return ret;
+        }
+        if (vId == failed_) {
+            return nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND;
+        }
+        executed_.emplace_back(vId, inBatch_);
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    nebula::cpp2::ErrorCode beginBatch(PartitionID, const std::vector<VertexID>& vIds) override {
+        batches_.emplace_back(vIds);
+        inBatch_ = true;
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+
+    void endBatch() override {
+        inBatch_ = false;
+    }
+
+    VertexID failed_;
+    bool inBatch_ = false;
+    std::vector<std::vector<VertexID>> batches_;
+    std::vector<std::pair<VertexID, bool>> executed_;
+};
+
+TEST_F(StorageDAGTest, BatchTest) {
+    StoragePlan<VertexID> dag;
+    auto node = std::make_unique<BatchNode>();
+    auto* batchNode = node.get();
+    dag.addNode(std::move(node));
+
+    std::vector<VertexID> vIds;
+    for (size_t i = 0; i < 5; i++) {
+        vIds.emplace_back(folly::to<std::string>(i));
+    }
+    FLAGS_query_batch_size = 2;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, dag.go(partId_, vIds));
+    ASSERT_EQ(3, batchNode->batches_.size());
+    EXPECT_EQ((std::vector<VertexID>{"0", "1"}), batchNode->batches_[0]);
+    EXPECT_EQ((std::vector<VertexID>{"4"}), batchNode->batches_[2]);
+    ASSERT_EQ(5, batchNode->executed_.size());
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_EQ(vIds[i], batchNode->executed_[i].first);
+        EXPECT_TRUE(batchNode->executed_[i].second);
+    }
+    EXPECT_FALSE(batchNode->inBatch_);
+
+    // a failure doesn't stop the others, and it is returned
+    batchNode->executed_.clear();
+    batchNode->failed_ = "1";
+    ASSERT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, dag.go(partId_, vIds));
+    ASSERT_EQ(4, batchNode->executed_.size());
+    EXPECT_EQ("0", batchNode->executed_[0].first);
+    EXPECT_EQ("2", batchNode->executed_[1].first);
+    EXPECT_FALSE(batchNode->inBatch_);
+
+    // executed one by one
+    batchNode->batches_.clear();
+    batchNode->executed_.clear();
+    batchNode->failed_ = "";
+    FLAGS_query_batch_size = 0;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, dag.go(partId_, vIds));
+    EXPECT_TRUE(batchNode->batches_.empty());
+    ASSERT_EQ(5, batchNode->executed_.size());
+    EXPECT_FALSE(batchNode->executed_[0].second);
+
+    // so is it when executed one by one
+    batchNode->executed_.clear();
+    batchNode->failed_ = "3";
+    ASSERT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND, dag.go(partId_, vIds));
+    ASSERT_EQ(4, batchNode->executed_.size());
+    FLAGS_query_batch_size = 256;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
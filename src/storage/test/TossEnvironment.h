@@ -10,7 +10,9 @@
 
 #include "TossTestUtils.h"
 
+#include "codec/RowReaderWrapper.h"
 #include "common/meta/ServerBasedSchemaManager.h"
+#include "utils/IndexKeyUtils.h"
 
 #define FLOG_FMT(...) LOG(INFO) << folly::sformat(__VA_ARGS__)
 
@@ -140,6 +142,33 @@ struct TossEnvironment {
         return fCreateEdgeSchema.value().value();
     }
 
+    /*
+     * setup an index on the first column of the edge, the storaged loads it by the heartbeat
+     * */
+    int32_t setupEdgeIndex(const std::string& indexName) {
+        if (edgeIndexId_ != 0) {
+            return edgeIndexId_;
+        }
+        meta::cpp2::IndexFieldDef field;
+        field.set_name(makeColNames(1).back());
+        auto fCreateEdgeIndex = mClient_->createEdgeIndex(spaceId_,
+                                                          indexName,
+                                                          "test_edge",
+                                                          {field});
+        fCreateEdgeIndex.wait();
+        if (!fCreateEdgeIndex.valid() || !fCreateEdgeIndex.value().ok()) {
+            LOG(FATAL) << "createEdgeIndex failed";
+        }
+        edgeIndexId_ = fCreateEdgeIndex.value().value();
+
+        int sleepSecs = FLAGS_heartbeat_interval_secs + 2;
+        while (sleepSecs) {
+            LOG(INFO) << "sleep for " << sleepSecs-- << " sec";
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        return edgeIndexId_;
+    }
+
     cpp2::EdgeKey generateEdgeKey(int64_t srcId, int rank, int dstId = 0) {
         cpp2::EdgeKey edgeKey;
         edgeKey.set_src(srcId);
@@ -579,6 +608,34 @@ struct TossEnvironment {
         return rawKey;
     }
 
+    /**
+     * @brief gen the key of edge e in the index set up by setupEdgeIndex()
+     */
+    std::string makeIndexKey(const cpp2::NewEdge& e) {
+        auto index = mClient_->getEdgeIndexFromCache(spaceId_, edgeIndexId_);
+        LOG_IF(FATAL, !index.ok()) << "mClient_->getEdgeIndexFromCache failed";
+        auto encodedProps = encodeProps(e);
+        auto reader = RowReaderWrapper::getEdgePropReader(schemaMan_.get(),
+                                                          spaceId_,
+                                                          std::abs(e.get_key().get_edge_type()),
+                                                          encodedProps);
+        LOG_IF(FATAL, !reader) << "Bad format row";
+        auto values = IndexKeyUtils::collectIndexValues(reader.get(),
+                                                        index.value()->get_fields());
+        LOG_IF(FATAL, !values.ok()) << "collectIndexValues failed";
+
+        std::string rawKey;
+        int32_t partId = 0;
+        std::tie(rawKey, partId) = makeRawKey(e.get_key());
+        return IndexKeyUtils::edgeIndexKey(vIdLen_,
+                                           partId,
+                                           edgeIndexId_,
+                                           NebulaKeyUtils::getSrcId(vIdLen_, rawKey).str(),
+                                           NebulaKeyUtils::getRank(vIdLen_, rawKey),
+                                           NebulaKeyUtils::getDstId(vIdLen_, rawKey).str(),
+                                           std::move(values).value());
+    }
+
     cpp2::EdgeKey reverseEdgeKey(const cpp2::EdgeKey& input) {
         cpp2::EdgeKey ret(input);
         std::swap(*ret.src_ref(), *ret.dst_ref());
@@ -629,6 +686,18 @@ struct TossEnvironment {
         }
     }
 
+    // A reader waits at most toss_resume_wait_ms for the locks it meets, which keep being
+    // resumed in background after that, so wait for the lock to be removed for a while
+    bool waitLockResumed(folly::StringPiece lockKey, int32_t timeoutMs = 10000) {
+        for (auto i = 0; i < timeoutMs / 10; i++) {
+            if (!keyExist(lockKey)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return !keyExist(lockKey);
+    }
+
     bool keyExist(folly::StringPiece key) {
         auto sf = interClient_->getValue(vIdLen_, spaceId_, key);
         sf.wait();
@@ -677,6 +746,7 @@ public:
 
     int32_t                                             spaceId_{0};
     int32_t                                             edgeType_{0};
+    int32_t                                             edgeIndexId_{0};
     int32_t                                             vIdLen_{0};
 };
 
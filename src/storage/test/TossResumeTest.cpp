@@ -0,0 +1,240 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include "common/fs/TempDir.h"
+#include "common/stats/StatsManager.h"
+#include <gtest/gtest.h>
+#include "storage/StorageFlags.h"
+#include "storage/query/GetNeighborsProcessor.h"
+#include "storage/test/QueryTestUtils.h"
+#include "storage/transaction/TransactionManager.h"
+
+namespace nebula {
+namespace storage {
+
+// The locks are never resumed until finish() is called, and all spaces are in TOSS mode
+class FakeTransactionManager : public TransactionManager {
+public:
+    explicit FakeTransactionManager(StorageEnv* env) : TransactionManager(env) {}
+
+    folly::Future<nebula::cpp2::ErrorCode>
+    resumeTransaction(size_t, GraphSpaceID, std::string lockKey, ResumedResult result) override {
+        std::lock_guard<std::mutex> g(lock_);
+        resumes_.emplace_back();
+        auto& resume = resumes_.back();
+        resume.lockKey = std::move(lockKey);
+        resume.result = std::move(result);
+        return resume.promise.getFuture();
+    }
+
+    size_t numResumes() {
+        std::lock_guard<std::mutex> g(lock_);
+        return resumes_.size();
+    }
+
+    std::string resumedLock(size_t i) {
+        std::lock_guard<std::mutex> g(lock_);
+        return resumes_[i].lockKey;
+    }
+
+    // finish the i-th resume started, with the edge resumed from the lock
+    void finish(size_t i, KV resumed) {
+        std::lock_guard<std::mutex> g(lock_);
+        auto& resume = resumes_[i];
+        if (resume.result != nullptr) {
+            *resume.result->wlock() = std::move(resumed);
+        }
+        resume.promise.setValue(nebula::cpp2::ErrorCode::SUCCEEDED);
+    }
+
+
+protected:
+    nebula::meta::cpp2::IsolationLevel getSpaceIsolationLvel(GraphSpaceID) override {
+        return nebula::meta::cpp2::IsolationLevel::TOSS;
+    }
+
+private:
+    struct Resume {
+        std::string                                 lockKey;
+        ResumedResult                               result;
+        folly::Promise<nebula::cpp2::ErrorCode>     promise;
+    };
+
+    std::mutex              lock_;
+    std::deque<Resume>      resumes_;
+};
+
+// the locks are resumed in the executor of the transaction manager, wait for it at most 10s
+static bool waitFor(std::function<bool()> cond) {
+    for (auto i = 0; i < 10000; i++) {
+        if (cond()) {
+            return true;
+        }
+        usleep(1000);
+    }
+    return cond();
+}
+
+static std::string mockLockKey(PartitionID partId, const std::string& dst) {
+    return NebulaKeyUtils::toLockKey(NebulaKeyUtils::edgeKey(8, partId, "src", 101, 0, dst));
+}
+
+TEST(TossResumeTest, SharedResumeTest) {
+    fs::TempDir rootPath("/tmp/TossResumeTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    FakeTransactionManager txnMan(cluster.storageEnv_.get());
+
+    auto lockKey = mockLockKey(1, "dst");
+    auto reader1 = txnMan.resumeLockAsync(8, 1, lockKey);
+    auto reader2 = txnMan.resumeLockAsync(8, 1, lockKey);
+    // the second reader waits for the resume started by the first one
+    EXPECT_EQ(1, txnMan.numResumes());
+    EXPECT_EQ(1, txnMan.numPendingLocks());
+
+    auto edgeKey = NebulaKeyUtils::toEdgeKey(lockKey);
+    txnMan.finish(0, std::make_pair(edgeKey, "resumed"));
+    auto resumed1 = std::move(reader1).get();
+    auto resumed2 = std::move(reader2).get();
+    EXPECT_EQ(edgeKey, resumed1.first);
+    EXPECT_EQ("resumed", resumed1.second);
+    EXPECT_EQ(resumed1, resumed2);
+    ASSERT_TRUE(waitFor([&] { return txnMan.numPendingLocks() == 0; }));
+
+    // a lock met again after its resume is resumed again
+    auto reader3 = txnMan.resumeLockAsync(8, 1, lockKey);
+    EXPECT_EQ(2, txnMan.numResumes());
+    txnMan.finish(1, std::make_pair(edgeKey, "resumed again"));
+    EXPECT_EQ("resumed again", std::move(reader3).get().second);
+    ASSERT_TRUE(waitFor([&] { return txnMan.numPendingLocks() == 0; }));
+}
+
+TEST(TossResumeTest, ResumeConcurrencyTest) {
+    fs::TempDir rootPath("/tmp/TossResumeTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    FakeTransactionManager txnMan(cluster.storageEnv_.get());
+
+    auto defaultConcurrency = FLAGS_toss_resume_concurrency;
+    FLAGS_toss_resume_concurrency = 2;
+    // the locks of part 1 and part 2 are met alternately
+    std::vector<folly::SemiFuture<KV>> readers;
+    for (auto i = 0; i < 5; i++) {
+        auto lockKey = mockLockKey(1 + i % 2, folly::to<std::string>(i));
+        readers.emplace_back(txnMan.resumeLockAsync(8, 1, std::move(lockKey)));
+    }
+    EXPECT_EQ(5, txnMan.numPendingLocks());
+    EXPECT_EQ(2, txnMan.numResumes());
+
+    // a queued lock is resumed only when a running one is finished
+    for (size_t i = 0; i < 5; i++) {
+        txnMan.finish(i, KV());
+        ASSERT_TRUE(waitFor([&] { return txnMan.numPendingLocks() == 5 - i - 1; }));
+        ASSERT_TRUE(waitFor([&] { return txnMan.numResumes() == std::min<size_t>(i + 3, 5); }));
+        // the locks beyond the two running are still queued
+        usleep(10000);
+        EXPECT_EQ(std::min<size_t>(i + 3, 5), txnMan.numResumes());
+    }
+    for (auto& reader : readers) {
+        EXPECT_TRUE(std::move(reader).get().first.empty());
+    }
+
+    // the locks of part 1 are drained before those of part 2
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_EQ(i < 3 ? 1 : 2, NebulaKeyUtils::getPart(txnMan.resumedLock(i)));
+    }
+    FLAGS_toss_resume_concurrency = defaultConcurrency;
+}
+
+TEST(TossResumeTest, TimedOutReadTest) {
+    fs::TempDir rootPath("/tmp/TossResumeTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto totalParts = cluster.getTotalParts();
+    ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+    ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+    auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+    FakeTransactionManager txnMan(env);
+    env->txnMan_ = &txnMan;
+
+    GraphSpaceID spaceId = 1;
+    EdgeType serve = 101;
+    VertexID vId = "Tim Duncan";
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId);
+    ASSERT_TRUE(vIdLen.ok());
+    PartitionID partId = (std::hash<std::string>()(vId) % totalParts) + 1;
+
+    // put a dangling lock ahead of the only serve edge of Tim Duncan
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto prefix = NebulaKeyUtils::edgePrefix(vIdLen.value(), partId, vId, serve);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              env->kvstore_->prefix(spaceId, partId, prefix, &iter));
+    ASSERT_TRUE(iter->valid());
+    auto edgeKey = iter->key().str();
+    auto edgeVal = iter->val().str();
+    auto lockKey = NebulaKeyUtils::toLockKey(edgeKey);
+    folly::Baton<true, std::atomic> baton;
+    env->kvstore_->asyncMultiPut(spaceId, partId, {{lockKey, edgeVal}},
+                                 [&baton] (nebula::cpp2::ErrorCode code) {
+        EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+        baton.post();
+    });
+    baton.wait();
+
+    auto defaultWait = FLAGS_toss_resume_wait_ms;
+    FLAGS_toss_resume_wait_ms = 10;
+    auto pendingReads = [] () {
+        auto ret = stats::StatsManager::readValue("num_toss_pending_reads.sum.60");
+        return ret.ok() ? ret.value() : 0;
+    };
+    auto pendingReadsBefore = pendingReads();
+    {
+        std::vector<VertexID> vertices = {vId};
+        std::vector<EdgeType> over = {serve};
+        std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+        std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+        edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+        auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+        auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+
+        // the lock is not resumed in time, the last committed edge is returned
+        ASSERT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        ASSERT_EQ(1, (*resp.vertices_ref()).rows.size());
+        // vId, stat, serve, expr
+        const auto& cell = (*resp.vertices_ref()).rows[0].values[2];
+        ASSERT_TRUE(cell.isList());
+        ASSERT_EQ(1, cell.getList().values.size());
+        const auto& edge = cell.getList().values[0].getList();
+        EXPECT_EQ("Spurs", edge.values[0].getStr());
+        EXPECT_EQ(1997, edge.values[1].getInt());
+    }
+    EXPECT_EQ(pendingReadsBefore + 1, pendingReads());
+    // the lock keeps being resumed after the read returns
+    EXPECT_EQ(1, txnMan.numPendingLocks());
+    EXPECT_EQ(1, txnMan.numResumes());
+
+    txnMan.finish(0, KV());
+    ASSERT_TRUE(waitFor([&] { return txnMan.numPendingLocks() == 0; }));
+    env->txnMan_ = nullptr;
+    FLAGS_toss_resume_wait_ms = defaultWait;
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
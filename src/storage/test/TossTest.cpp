@@ -363,7 +363,7 @@ TEST_F(TossTest, lock_test_1) {
     auto props = env_->getNeiProps(edges);
     auto svec = TossTestUtils::splitNeiResults(props);
 
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     auto rawKey = NebulaKeyUtils::toEdgeKey(lockKey);
     ASSERT_TRUE(env_->keyExist(rawKey));
@@ -392,7 +392,7 @@ TEST_F(TossTest, lock_test_2) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     // auto rawKey = NebulaKeyUtils::toEdgeKey(lockKey);
@@ -403,7 +403,10 @@ TEST_F(TossTest, lock_test_2) {
     auto reversedRawKey = env_->makeRawKey(reversedEdgeKey);
     ASSERT_TRUE(env_->keyExist(reversedRawKey.first));
 
-    // step 4th: the get neighbors result is from lock
+    // step 4th: the get neighbors result is from lock. The first read may return the edge
+    // before the lock if the resume took longer than toss_resume_wait_ms, so read it again
+    props = env_->getNeiProps(edges);
+    svec = TossTestUtils::splitNeiResults(props);
     auto lockStrVal = edges[0].get_props()[1].toString();
     ASSERT_TRUE(svec.back().size() > lockStrVal.size());
     auto neighborStrVal = svec.back().substr(svec.back().size() - lockStrVal.size());
@@ -429,7 +432,7 @@ TEST_F(TossTest, lock_test_3) {
     EXPECT_EQ(svec.size(), 0);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 }
 
 /**
@@ -452,7 +455,7 @@ TEST_F(TossTest, lock_test_4) {
     ASSERT_EQ(svec.size(), num);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     // auto rawKey = NebulaKeyUtils::toEdgeKey(lockKey);
@@ -507,7 +510,7 @@ TEST_F(TossTest, neighbors_test_2) {
     ASSERT_TRUE(TossTestUtils::compareSize(svec, num));
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     auto rawKey = NebulaKeyUtils::toEdgeKey(lockKey);
@@ -539,7 +542,7 @@ TEST_F(TossTest, neighbors_test_3) {
     ASSERT_TRUE(TossTestUtils::compareSize(svec, num));
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey1));
@@ -586,7 +589,7 @@ TEST_F(TossTest, neighbors_test_4) {
     ASSERT_TRUE(TossTestUtils::compareSize(svec, num-1));
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey1));
@@ -626,7 +629,7 @@ TEST_F(TossTest, neighbors_test_5) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey1));
@@ -670,7 +673,7 @@ TEST_F(TossTest, neighbors_test_6) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey1));
@@ -717,8 +720,8 @@ TEST_F(TossTest, neighbors_test_7) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0.first));
@@ -766,8 +769,8 @@ TEST_F(TossTest, neighbors_test_8) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -815,8 +818,8 @@ TEST_F(TossTest, neighbors_test_9) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -864,8 +867,8 @@ TEST_F(TossTest, neighbors_test_10) {
     auto svec = TossTestUtils::splitNeiResults(props);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -914,7 +917,7 @@ TEST_F(TossTest, neighbors_test_11) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
     // ASSERT_FALSE(env_->keyExist(lockKey1));
 
     // step 2nd: edge key exist
@@ -962,8 +965,8 @@ TEST_F(TossTest, neighbors_test_12) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_FALSE(env_->keyExist(rawKey0));
@@ -1010,8 +1013,8 @@ TEST_F(TossTest, neighbors_test_13) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_FALSE(env_->keyExist(rawKey0));
@@ -1058,8 +1061,8 @@ TEST_F(TossTest, neighbors_test_14) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_FALSE(env_->keyExist(rawKey0));
@@ -1106,8 +1109,8 @@ TEST_F(TossTest, neighbors_test_15) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_FALSE(env_->keyExist(rawKey0));
@@ -1154,8 +1157,8 @@ TEST_F(TossTest, neighbors_test_16) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -1202,8 +1205,8 @@ TEST_F(TossTest, neighbors_test_17) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -1254,8 +1257,8 @@ TEST_F(TossTest, neighbors_test_18) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -1306,8 +1309,8 @@ TEST_F(TossTest, neighbors_test_19) {
     auto props = env_->getNeiProps(edges);
 
     // step 1st: lock key not exist
-    ASSERT_FALSE(env_->keyExist(lockKey0));
-    ASSERT_FALSE(env_->keyExist(lockKey1));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey0));
+    ASSERT_TRUE(env_->waitLockResumed(lockKey1));
 
     // step 2nd: edge key exist
     ASSERT_TRUE(env_->keyExist(rawKey0));
@@ -1371,6 +1374,117 @@ TEST_F(TossTest, get_props_test_1) {
     }
 }
 
+/**
+ * @brief the locks of a chain are removed by the commit of its edges,
+ *        not by a reader resuming them later
+ */
+TEST_F(TossTest, chain_lock_test) {
+    LOG(INFO) << __func__ << " b_=" << b_;
+    auto num = 10;
+    auto values = TossTestUtils::genValues(num);
+
+    // same local part, same remote part
+    std::vector<cpp2::NewEdge> edges;
+    for (auto i = 0; i != num; ++i) {
+        edges.emplace_back(env_->generateEdge(b_, 0, values[i], b_ + kPart * (i + 1)));
+    }
+
+    auto code = env_->syncAddMultiEdges(edges, kUseToss);
+    ASSERT_EQ(code, nebula::cpp2::ErrorCode::SUCCEEDED);
+
+    for (auto& e : edges) {
+        auto rawKey = env_->makeRawKey(e.get_key()).first;
+        EXPECT_FALSE(env_->keyExist(NebulaKeyUtils::toLockKey(rawKey)));
+        EXPECT_TRUE(env_->keyExist(rawKey));
+        auto reversedRawKey = env_->makeRawKey(env_->reverseEdgeKey(e.get_key()));
+        EXPECT_TRUE(env_->keyExist(reversedRawKey.first));
+    }
+
+    std::vector<cpp2::NewEdge> first{edges[0]};
+    auto props = env_->getNeiProps(first);
+    EXPECT_EQ(env_->countSquareBrackets(props), num);
+}
+
+/**
+ * @brief the same edge twice in a chain conflicts in the memory locks,
+ *        so nothing of the chain is written
+ */
+TEST_F(TossTest, chain_duplicate_edge_test) {
+    LOG(INFO) << __func__ << " b_=" << b_;
+    auto num = 2;
+    auto values = TossTestUtils::genValues(num);
+
+    std::vector<cpp2::NewEdge> edges;
+    edges.emplace_back(env_->generateEdge(b_, 0, values[0], b_ + kPart));
+    edges.emplace_back(env_->generateEdge(b_, 0, values[1], b_ + kPart * 2));
+    edges.emplace_back(env_->dupEdge(edges[0]));
+
+    auto f = env_->addEdgesAsync(edges, kUseToss);
+    f.wait();
+    ASSERT_TRUE(f.valid());
+    std::vector<nebula::cpp2::ErrorCode> codes;
+    for (auto& part : f.value().failedParts()) {
+        codes.emplace_back(part.second);
+    }
+    for (auto& execResp : f.value().responses()) {
+        for (auto& part : execResp.get_result().get_failed_parts()) {
+            codes.emplace_back(part.code);
+        }
+    }
+    ASSERT_FALSE(codes.empty());
+    for (auto& c : codes) {
+        EXPECT_EQ(c, nebula::cpp2::ErrorCode::E_MUTATE_EDGE_CONFLICT)
+            << apache::thrift::util::enumNameSafe(c);
+    }
+
+    for (auto& e : edges) {
+        auto rawKey = env_->makeRawKey(e.get_key()).first;
+        EXPECT_FALSE(env_->keyExist(NebulaKeyUtils::toLockKey(rawKey)));
+        EXPECT_FALSE(env_->keyExist(rawKey));
+        auto reversedRawKey = env_->makeRawKey(env_->reverseEdgeKey(e.get_key()));
+        EXPECT_FALSE(env_->keyExist(reversedRawKey.first));
+    }
+
+    // the chain is written once the duplicate is gone
+    edges.pop_back();
+    auto code = env_->syncAddMultiEdges(edges, kUseToss);
+    ASSERT_EQ(code, nebula::cpp2::ErrorCode::SUCCEEDED);
+    std::vector<cpp2::NewEdge> first{edges[0]};
+    auto props = env_->getNeiProps(first);
+    EXPECT_EQ(env_->countSquareBrackets(props), num);
+}
+
+/**
+ * @brief the index of the edges of a chain is committed along with them,
+ *        the index is set up here, so it is the last case of TossTest
+ */
+TEST_F(TossTest, chain_index_test) {
+    LOG(INFO) << __func__ << " b_=" << b_;
+    env_->setupEdgeIndex("test_edge_index");
+    auto num = 10;
+    auto values = TossTestUtils::genValues(num);
+
+    // same local part, same remote part
+    std::vector<cpp2::NewEdge> edges;
+    for (auto i = 0; i != num; ++i) {
+        edges.emplace_back(env_->generateEdge(b_, 0, values[i], b_ + kPart * (i + 1)));
+    }
+
+    auto code = env_->syncAddMultiEdges(edges, kUseToss);
+    ASSERT_EQ(code, nebula::cpp2::ErrorCode::SUCCEEDED);
+
+    for (auto& e : edges) {
+        auto rawKey = env_->makeRawKey(e.get_key()).first;
+        EXPECT_FALSE(env_->keyExist(NebulaKeyUtils::toLockKey(rawKey)));
+        EXPECT_TRUE(env_->keyExist(rawKey));
+        EXPECT_TRUE(env_->keyExist(env_->makeIndexKey(e)));
+    }
+
+    std::vector<cpp2::NewEdge> first{edges[0]};
+    auto props = env_->getNeiProps(first);
+    EXPECT_EQ(env_->countSquareBrackets(props), num);
+}
+
 }  // namespace storage
 }  // namespace nebula
 
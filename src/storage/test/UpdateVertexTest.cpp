@@ -8,6 +8,7 @@
 #include "common/fs/TempDir.h"
 #include "storage/mutate/UpdateVertexProcessor.h"
 #include "utils/NebulaKeyUtils.h"
+#include "utils/IndexKeyUtils.h"
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
 #include "storage/test/TestUtils.h"
@@ -15,8 +16,10 @@
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
 #include "common/expression/ConstantExpression.h"
+#include "common/expression/ArithmeticExpression.h"
 
 DECLARE_bool(mock_ttl_col);
+DECLARE_bool(enable_update_by_merge);
 DECLARE_int32(mock_ttl_duration);
 
 namespace nebula {
@@ -1484,6 +1487,149 @@ TEST(UpdateVertexTest, Upsert_Field_Type_And_Value_Match_Test) {
 }
 
 
+// update the int props by merge, and fall back to the plan when the merge can't be used
+TEST(UpdateVertexTest, Update_By_Merge_Test) {
+    FLAGS_enable_update_by_merge = true;
+    fs::TempDir rootPath("/tmp/UpdateVertexTest.XXXXXX");
+    mock::MockCluster cluster;
+    cluster.initStorageKV(rootPath.path());
+    auto* env = cluster.storageEnv_.get();
+    auto parts = cluster.getTotalParts();
+
+    GraphSpaceID spaceId = 1;
+    TagID tagId = 1;
+    auto status = env->schemaMan_->getSpaceVidLen(spaceId);
+    ASSERT_TRUE(status.ok());
+    auto spaceVidLen = status.value();
+
+    EXPECT_TRUE(mockVertexData(env, parts, spaceVidLen));
+
+    auto partId = std::hash<std::string>()("Tim Duncan") % parts + 1;
+    VertexID vertexId("Tim Duncan");
+    auto key = NebulaKeyUtils::vertexKey(spaceVidLen, partId, vertexId, tagId);
+    auto getProp = [&] (const std::string& prop) {
+        std::string row;
+        auto ret = env->kvstore_->get(spaceId, partId, key, &row);
+        EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+        auto reader = RowReaderWrapper::getTagPropReader(env->schemaMan_, spaceId, tagId, row);
+        return reader->getValueByName(prop);
+    };
+    auto propPlus = [] (const std::string& prop, int64_t delta) {
+        cpp2::UpdatedProp uProp;
+        uProp.set_name(prop);
+        const auto& val = *ArithmeticExpression::makeAdd(
+            pool,
+            SourcePropertyExpression::make(pool, "1", prop),
+            ConstantExpression::make(pool, delta));
+        uProp.set_value(Expression::encode(val));
+        return uProp;
+    };
+    auto update = [&] (std::vector<cpp2::UpdatedProp> updatedProps,
+                       std::vector<std::string> returnProps) {
+        cpp2::UpdateVertexRequest req;
+        req.set_space_id(spaceId);
+        req.set_part_id(partId);
+        req.set_vertex_id(vertexId);
+        req.set_tag_id(tagId);
+        req.set_updated_props(std::move(updatedProps));
+        req.set_return_props(std::move(returnProps));
+        req.set_insertable(false);
+        auto* processor = UpdateVertexProcessor::instance(env, nullptr);
+        auto f = processor->getFuture();
+        processor->process(req);
+        return std::move(f).get();
+    };
+
+    auto games = getProp("games").getInt();
+    auto career = getProp("career").getInt();
+    auto age = getProp("age").getInt();
+
+    LOG(INFO) << "games = games + 3, career = career - 1, updated by merge";
+    {
+        std::vector<cpp2::UpdatedProp> updatedProps;
+        updatedProps.emplace_back(propPlus("games", 3));
+        cpp2::UpdatedProp uProp;
+        uProp.set_name("career");
+        const auto& val = *ArithmeticExpression::makeMinus(
+            pool,
+            SourcePropertyExpression::make(pool, "1", "career"),
+            ConstantExpression::make(pool, 1L));
+        uProp.set_value(Expression::encode(val));
+        updatedProps.emplace_back(std::move(uProp));
+
+        auto resp = update(std::move(updatedProps), {});
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        ASSERT_EQ(1, (*resp.props_ref()).colNames.size());
+        EXPECT_EQ("_inserted", (*resp.props_ref()).colNames[0]);
+        ASSERT_EQ(1, (*resp.props_ref()).rows.size());
+        EXPECT_EQ(false, (*resp.props_ref()).rows[0].values[0].getBool());
+        EXPECT_EQ(games + 3, getProp("games").getInt());
+        EXPECT_EQ(career - 1, getProp("career").getInt());
+    }
+
+    LOG(INFO) << "games = games + 3 with return props, updated by the plan";
+    {
+        std::vector<cpp2::UpdatedProp> updatedProps;
+        updatedProps.emplace_back(propPlus("games", 3));
+        std::vector<std::string> returnProps;
+        const auto& exp = *SourcePropertyExpression::make(pool, "1", "games");
+        returnProps.emplace_back(Expression::encode(exp));
+
+        auto resp = update(std::move(updatedProps), std::move(returnProps));
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        ASSERT_EQ(1, (*resp.props_ref()).rows.size());
+        EXPECT_EQ(games + 6, (*resp.props_ref()).rows[0].values[1].getInt());
+        EXPECT_EQ(games + 6, getProp("games").getInt());
+    }
+
+    LOG(INFO) << "age = age + 1, the indexed prop is updated by the plan";
+    {
+        std::vector<cpp2::UpdatedProp> updatedProps;
+        updatedProps.emplace_back(propPlus("age", 1));
+        auto resp = update(std::move(updatedProps), {});
+        EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+        EXPECT_EQ(age + 1, getProp("age").getInt());
+
+        // the index entry of the old value is replaced by the new one
+        std::string paddedVid = vertexId;
+        paddedVid.append(spaceVidLen - vertexId.size(), '\0');
+        auto indexPrefix = IndexKeyUtils::indexPrefix(partId, 1);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto ret = env->kvstore_->prefix(spaceId, partId, indexPrefix, &iter);
+        ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+        int32_t count = 0;
+        for (; iter->valid(); iter->next()) {
+            if (IndexKeyUtils::getIndexVertexID(spaceVidLen, iter->key()) == paddedVid) {
+                count++;
+            }
+        }
+        EXPECT_EQ(1, count);
+    }
+
+    LOG(INFO) << "Update a vertex not existed";
+    {
+        std::vector<cpp2::UpdatedProp> updatedProps;
+        updatedProps.emplace_back(propPlus("games", 1));
+        cpp2::UpdateVertexRequest req;
+        req.set_space_id(spaceId);
+        auto notExisted = std::hash<std::string>()("Not Existed") % parts + 1;
+        req.set_part_id(notExisted);
+        req.set_vertex_id("Not Existed");
+        req.set_tag_id(tagId);
+        req.set_updated_props(std::move(updatedProps));
+        req.set_insertable(false);
+        auto* processor = UpdateVertexProcessor::instance(env, nullptr);
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        ASSERT_EQ(1, (*resp.result_ref()).failed_parts.size());
+        EXPECT_EQ(nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND,
+                  (*resp.result_ref()).failed_parts[0].code);
+    }
+    FLAGS_enable_update_by_merge = false;
+}
+
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -0,0 +1,109 @@
+/* Copyright (c) 2021 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "common/base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
+#include "storage/StorageFlags.h"
+#include "storage/WorkloadPools.h"
+
+namespace nebula {
+namespace storage {
+
+TEST(WorkloadPoolsTest, AdmitTest) {
+    WorkloadExecutor pool("admit_test", 1, 2);
+    folly::Baton<> running;
+    folly::Baton<> blocked;
+    std::atomic<int32_t> finished{0};
+    pool.add([&] {
+        running.post();
+        blocked.wait();
+        finished++;
+    });
+    running.wait();
+    ASSERT_TRUE(pool.admit());
+
+    // the only thread is blocked, so the tasks are pending until the queue is full
+    for (int32_t i = 0; i < 2; i++) {
+        pool.add([&] {
+            finished++;
+        });
+    }
+    ASSERT_EQ(2, pool.pending());
+    ASSERT_FALSE(pool.admit());
+    ASSERT_EQ(1, pool.toJson()["rejections"].asInt());
+
+    // unlimited
+    pool.setMaxQueueSize(0);
+    ASSERT_TRUE(pool.admit());
+    pool.setMaxQueueSize(2);
+    ASSERT_FALSE(pool.admit());
+
+    blocked.post();
+    while (finished.load() < 3) {
+        usleep(1000);
+    }
+    ASSERT_EQ(0, pool.pending());
+    ASSERT_TRUE(pool.admit());
+    pool.join();
+}
+
+TEST(WorkloadPoolsTest, ResizeTest) {
+    WorkloadExecutor pool("resize_test", 2, 0);
+    ASSERT_EQ(2, pool.toJson()["threads"].asInt());
+    pool.setNumThreads(4);
+    ASSERT_EQ(4, pool.toJson()["threads"].asInt());
+
+    // all tasks are executed by the resized pool
+    std::atomic<int32_t> finished{0};
+    for (int32_t i = 0; i < 100; i++) {
+        pool.add([&] {
+            finished++;
+        });
+    }
+    pool.setNumThreads(1);
+    ASSERT_EQ(1, pool.toJson()["threads"].asInt());
+    pool.join();
+    ASSERT_EQ(100, finished.load());
+}
+
+TEST(WorkloadPoolsTest, PoolsTest) {
+    auto& pools = WorkloadPools::instance();
+    FLAGS_enable_workload_pools = false;
+    pools.init();
+    ASSERT_EQ(nullptr, pools.get(Workload::kPointRead));
+    ASSERT_EQ(nullptr, pools.find("scan"));
+    ASSERT_TRUE(pools.admit(Workload::kScan));
+
+    FLAGS_enable_workload_pools = true;
+    FLAGS_scan_threads = 3;
+    pools.init();
+    for (auto workload : {Workload::kPointRead, Workload::kTraversal, Workload::kScan,
+                          Workload::kMutation, Workload::kAdmin}) {
+        auto* pool = pools.get(workload);
+        ASSERT_NE(nullptr, pool);
+        ASSERT_EQ(pool, pools.find(WorkloadPools::name(workload)));
+        ASSERT_TRUE(pools.admit(workload));
+    }
+    ASSERT_EQ(nullptr, pools.find("unknown"));
+    ASSERT_EQ(3, pools.get(Workload::kScan)->toJson()["threads"].asInt());
+
+    auto json = pools.toJson();
+    ASSERT_EQ(5, json.size());
+    ASSERT_EQ("point_read", json[0]["name"].asString());
+    pools.stop();
+    FLAGS_enable_workload_pools = false;
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
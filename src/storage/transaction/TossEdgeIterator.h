@@ -165,10 +165,10 @@ public:
                 }
 
                 resumeTasks_.emplace_back(
-                    context_->env()->txnMan_->resumeTransaction(context_->vIdLen(),
-                                                                   context_->spaceId(),
-                                                                   iter_->key().str(),
-                                                                   recoverEdges_.back()));
+                    recoverEdges_.back(),
+                    context_->env()->txnMan_->resumeLockAsync(context_->vIdLen(),
+                                                              context_->spaceId(),
+                                                              iter_->key().str()));
                 lastRank_ = NebulaKeyUtils::getRank(context_->vIdLen(), rawKey);
                 lastDstId_ = NebulaKeyUtils::getDstId(context_->vIdLen(), rawKey).str();
                 lastIsLock_ = true;
@@ -186,7 +186,7 @@ public:
         // set recoverEdgesIter_ as begin() at first time. else ++recoverEdgesIter_
         if (needWaitResumeTask_) {
             LOG_IF(INFO, FLAGS_trace_toss) << "next(), waiting resume finished";
-            folly::collectAll(std::move(resumeTasks_)).wait();
+            waitResumeTasks();
             needWaitResumeTask_ = false;
             recoverEdgesIter_ = recoverEdges_.begin();
         } else {
@@ -210,6 +210,30 @@ public:
         LOG_IF(INFO, FLAGS_trace_toss) << "next(), exit";
     }
 
+    /**
+     * Wait the locks to be resumed for at most FLAGS_toss_resume_wait_ms. The edge of a resumed
+     * lock is returned, the others return the last committed version of the edge if any, and
+     * keep being resumed in background.
+     */
+    void waitResumeTasks() {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(std::max(FLAGS_toss_resume_wait_ms, 0));
+        for (auto& [item, task] : resumeTasks_) {
+            auto now = std::chrono::steady_clock::now();
+            if (!task.isReady() && now < deadline) {
+                task.wait(std::chrono::duration_cast<folly::HighResDuration>(deadline - now));
+            }
+            if (!task.isReady()) {
+                context_->env()->txnMan_->countPendingRead();
+                continue;
+            }
+            if (task.hasValue() && !task.value().second.empty()) {
+                *item->wlock() = std::move(task).value();
+            }
+        }
+        resumeTasks_.clear();
+    }
+
     bool isEdge(const folly::StringPiece& key) {
         return NebulaKeyUtils::isEdge(context_->vIdLen(), key);
     }
@@ -244,7 +268,7 @@ public:
 
 private:
     // using shared_ptr because this Iterator may be deleted if there is a limit in nGQL
-    // using folly::Synchronized because the scan thread and the resume thread may write same ptr
+    // the edges are filled by the scan first, then overwritten by the locks resumed in time
     using TResultsItem = std::shared_ptr<folly::Synchronized<KV>>;
     bool                                                 needWaitResumeTask_{true};
     bool                                                 lastIsLock_{false};
@@ -255,7 +279,7 @@ private:
      */
     bool                                                     stopAtFirstEdge_{false};
     bool                                                     calledByCtor_{true};
-    std::list<folly::SemiFuture<nebula::cpp2::ErrorCode>>    resumeTasks_;
+    std::list<std::pair<TResultsItem, folly::SemiFuture<KV>>> resumeTasks_;
     std::list<TResultsItem>                                  recoverEdges_;
     std::list<TResultsItem>::iterator                        recoverEdgesIter_;
 };
@@ -8,6 +8,7 @@
 
 #include "codec/RowWriterV2.h"
 #include "common/clients/storage/InternalStorageClient.h"
+#include "common/stats/StatsManager.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
 #include "storage/mutate/AddEdgesProcessor.h"
@@ -18,6 +19,8 @@
 namespace nebula {
 namespace storage {
 
+stats::CounterId kNumTossPendingReads;
+
 /*
  * edgeKey : thrift data structure
  * rawKey  : NebulaKeyUtils::edgeKey
@@ -28,6 +31,10 @@ TransactionManager::TransactionManager(StorageEnv* env) : env_(env) {
     interClient_ = std::make_unique<storage::InternalStorageClient>(
                             exec_,
                             env_->metaClient_);
+    if (!kNumTossPendingReads.valid()) {
+        kNumTossPendingReads =
+            stats::StatsManager::registerStats("num_toss_pending_reads", "rate, sum");
+    }
 }
 
 /*
@@ -81,51 +88,46 @@ TransactionManager::addSamePartEdges(size_t vIdLen,
     }
 
     // steps 2: batch commit persist locks
+    // The operations of all edges, including their indexes, are built in one pass and committed
+    // along with the removal of the locks in step 4, so the locks only keep the props of edges
     std::string batch;
-    std::vector<KV> lockData = localEdges;
-    // insert don't have BatchGetter
+    std::string opsBatch;
+    std::vector<std::string> lockKeys;
     if (!optBatchGetter) {
         // insert don't have batch Getter
-        auto addEdgeErrorCode = nebula::cpp2::ErrorCode::SUCCEEDED;
-        std::transform(lockData.begin(), lockData.end(), lockData.begin(), [&](auto& kv) {
-            if (processor) {
-                processor->spaceId_ = spaceId;
-                processor->spaceVidLen_ = vIdLen;
-                std::vector<KV> data{std::make_pair(kv.first, kv.second)};
-                auto optVal = processor->addEdges(localPart, data);
-                if (nebula::ok(optVal)) {
-                    return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
-                                          nebula::value(optVal));
-                } else {
-                    addEdgeErrorCode = nebula::cpp2::ErrorCode::E_ATOMIC_OP_FAILED;
-                    return std::make_pair(NebulaKeyUtils::toLockKey(kv.first), std::string(""));
-                }
-            } else {
-                std::vector<KV> data{std::make_pair(kv.first, kv.second)};
-                return std::make_pair(NebulaKeyUtils::toLockKey(kv.first),
-                                      encodeBatch(std::move(data)));
+        if (processor) {
+            processor->spaceId_ = spaceId;
+            processor->spaceVidLen_ = vIdLen;
+            auto optVal = processor->addEdges(localPart, localEdges);
+            if (!nebula::ok(optVal)) {
+                cleanup();
+                return nebula::cpp2::ErrorCode::E_ATOMIC_OP_FAILED;
             }
-        });
-        if (addEdgeErrorCode != nebula::cpp2::ErrorCode::SUCCEEDED) {
-            cleanup();
-            return addEdgeErrorCode;
+            opsBatch = std::move(nebula::value(optVal));
+        } else {
+            std::vector<KV> data = localEdges;
+            opsBatch = encodeBatch(std::move(data));
         }
-        auto lockDataSink = lockData;
-        batch = encodeBatch(std::move(lockDataSink));
+        kvstore::BatchHolder bat;
+        lockKeys.reserve(localEdges.size());
+        for (const auto& kv : localEdges) {
+            lockKeys.emplace_back(NebulaKeyUtils::toLockKey(kv.first));
+            bat.put(std::string(lockKeys.back()), std::string(kv.second));
+        }
+        batch = kvstore::encodeBatchValue(bat.getBatch());
     } else {   // only update should enter here
         auto optBatch = (*optBatchGetter)();
         if (!optBatch) {
             cleanup();
             return nebula::cpp2::ErrorCode::E_ATOMIC_OP_FAILED;
         }
-        lockData.back().first = NebulaKeyUtils::toLockKey(localEdges.back().first);
         batch = *optBatch;
         auto decodeKV = kvstore::decodeBatchValue(batch);
         localEdges.back().first = decodeKV.back().second.first.str();
         localEdges.back().second = decodeKV.back().second.second.str();
 
-        lockData.back().first = localEdges.back().first;
-        lockData.back().second = batch;
+        lockKeys.emplace_back(localEdges.back().first);
+        opsBatch = batch;
     }
 
     auto c = folly::makePromiseContract<nebula::cpp2::ErrorCode>();
@@ -185,29 +187,32 @@ TransactionManager::addSamePartEdges(size_t vIdLen,
 
                     // steps 4 & 5: multi put local edges & multi remove persist locks
                     kvstore::BatchHolder bat;
-                    for (auto& lock : lockData) {
+                    for (auto& lockKey : lockKeys) {
                         LOG_IF(INFO, FLAGS_trace_toss)
-                            << "remove lock, hex=" << folly::hexlify(lock.first)
+                            << "remove lock, hex=" << folly::hexlify(lockKey)
                             << ", txnId=" << txnId;
-                        bat.remove(std::move(lock.first));
-                        auto operations = kvstore::decodeBatchValue(lock.second);
-                        for (auto& op : operations) {
-                            auto opType = op.first;
-                            auto& kv = op.second;
-                            LOG_IF(INFO, FLAGS_trace_toss)
-                                        << "bat op=" << static_cast<int32_t>(opType)
-                                        << ", hex=" << folly::hexlify(kv.first)
-                                        << ", txnId=" << txnId;
-                            switch (opType) {
-                                case kvstore::BatchLogType::OP_BATCH_PUT:
-                                    bat.put(kv.first.str(), kv.second.str());
-                                    break;
-                                case kvstore::BatchLogType::OP_BATCH_REMOVE:
-                                    bat.remove(kv.first.str());
-                                    break;
-                                default:
-                                    LOG(ERROR) << "unexpected opType: " << static_cast<int>(opType);
-                            }
+                        bat.remove(std::move(lockKey));
+                    }
+                    auto operations = kvstore::decodeBatchValue(opsBatch);
+                    for (auto& op : operations) {
+                        auto opType = op.first;
+                        auto& kv = op.second;
+                        LOG_IF(INFO, FLAGS_trace_toss)
+                                    << "bat op=" << static_cast<int32_t>(opType)
+                                    << ", hex=" << folly::hexlify(kv.first)
+                                    << ", txnId=" << txnId;
+                        switch (opType) {
+                            case kvstore::BatchLogType::OP_BATCH_PUT:
+                                bat.put(kv.first.str(), kv.second.str());
+                                break;
+                            case kvstore::BatchLogType::OP_BATCH_REMOVE:
+                                bat.remove(kv.first.str());
+                                break;
+                            case kvstore::BatchLogType::OP_BATCH_MERGE:
+                                bat.merge(kv.first.str(), kv.second.str());
+                                break;
+                            default:
+                                LOG(ERROR) << "unexpected opType: " << static_cast<int>(opType);
                         }
                     }
                     auto _batch = kvstore::encodeBatchValue(bat.getBatch());
@@ -334,6 +339,85 @@ TransactionManager::resumeTransaction(size_t vIdLen,
     return std::move(c.second).via(exec_.get());
 }
 
+folly::SemiFuture<KV> TransactionManager::resumeLockAsync(size_t vIdLen,
+                                                          GraphSpaceID spaceId,
+                                                          std::string lockKey) {
+    folly::Promise<KV> promise;
+    auto future = promise.getSemiFuture();
+    {
+        std::lock_guard<std::mutex> g(resumeLock_);
+        auto it = pendingLocks_.find(lockKey);
+        if (it == pendingLocks_.end()) {
+            LOG_IF(INFO, FLAGS_trace_toss) << "queue lock " << folly::hexlify(lockKey);
+            auto partId = NebulaKeyUtils::getPart(lockKey);
+            queuedLocks_[std::make_pair(spaceId, partId)].emplace_back(lockKey);
+            it = pendingLocks_.emplace(std::move(lockKey), PendingLock{spaceId, vIdLen}).first;
+        }
+        it->second.waiters.emplace_back(std::move(promise));
+    }
+    scheduleResume();
+    return future;
+}
+
+size_t TransactionManager::numPendingLocks() {
+    std::lock_guard<std::mutex> g(resumeLock_);
+    return pendingLocks_.size();
+}
+
+void TransactionManager::countPendingRead() {
+    stats::StatsManager::addValue(kNumTossPendingReads);
+}
+
+void TransactionManager::scheduleResume() {
+    std::vector<std::tuple<std::string, GraphSpaceID, size_t>> locks;
+    {
+        std::lock_guard<std::mutex> g(resumeLock_);
+        // drain the locks of a partition before moving to the next one
+        while (numResuming_ < FLAGS_toss_resume_concurrency && !queuedLocks_.empty()) {
+            auto& queue = queuedLocks_.begin()->second;
+            auto& pending = pendingLocks_[queue.front()];
+            pending.resuming = true;
+            locks.emplace_back(std::move(queue.front()), pending.spaceId, pending.vIdLen);
+            queue.pop_front();
+            if (queue.empty()) {
+                queuedLocks_.erase(queuedLocks_.begin());
+            }
+            numResuming_++;
+        }
+    }
+    for (auto& [lockKey, spaceId, vIdLen] : locks) {
+        auto result = std::make_shared<folly::Synchronized<KV>>();
+        resumeTransaction(vIdLen, spaceId, lockKey, result)
+            .via(exec_.get())
+            .thenTry([this, lockKey = lockKey, result](auto&& t) {
+                KV resumed;
+                if (t.hasValue() && t.value() == nebula::cpp2::ErrorCode::SUCCEEDED) {
+                    resumed = result->copy();
+                }
+                onLockResumed(lockKey, std::move(resumed));
+            });
+    }
+}
+
+void TransactionManager::onLockResumed(const std::string& lockKey, KV resumed) {
+    std::vector<folly::Promise<KV>> waiters;
+    {
+        std::lock_guard<std::mutex> g(resumeLock_);
+        auto it = pendingLocks_.find(lockKey);
+        if (it != pendingLocks_.end()) {
+            waiters = std::move(it->second.waiters);
+            pendingLocks_.erase(it);
+        }
+        numResuming_--;
+    }
+    LOG_IF(INFO, FLAGS_trace_toss) << "resumed lock " << folly::hexlify(lockKey)
+                                   << ", waiters=" << waiters.size();
+    for (auto& waiter : waiters) {
+        waiter.setValue(resumed);
+    }
+    scheduleResume();
+}
+
 // combine multi put and remove in a batch
 // this may sometimes reduce some raft operation
 folly::SemiFuture<nebula::cpp2::ErrorCode>
@@ -35,7 +35,7 @@ class TransactionManager {
 public:
     explicit TransactionManager(storage::StorageEnv* env);
 
-    ~TransactionManager() = default;
+    virtual ~TransactionManager() = default;
 
     /**
      * @brief edges have same localPart and remotePart will share
@@ -80,12 +80,28 @@ public:
      * 2. if mvcc enabled, will commit the value of lock
      *       else, get props from in-edge, then re-check index and commit
      * */
-    folly::Future<nebula::cpp2::ErrorCode>
+    virtual folly::Future<nebula::cpp2::ErrorCode>
     resumeTransaction(size_t vIdLen,
                       GraphSpaceID spaceId,
                       std::string lockKey,
                       ResumedResult result = nullptr);
 
+    /**
+     * @brief resume a dangling lock met by a reader in background.
+     *        The locks are indexed by their partition and resumed part by part, at most
+     *        FLAGS_toss_resume_concurrency of them at the same time. A lock which is already
+     *        queued or being resumed is not resumed again, the readers share its result.
+     * @return the resumed edge, or an empty KV if the lock is not committed
+     * */
+    folly::SemiFuture<KV> resumeLockAsync(size_t vIdLen,
+                                          GraphSpaceID spaceId,
+                                          std::string lockKey);
+
+    size_t numPendingLocks();
+
+    // a reader returns the last committed edge since a lock is not resumed in time
+    void countPendingRead();
+
     folly::SemiFuture<nebula::cpp2::ErrorCode>
     commitBatch(GraphSpaceID spaceId,
                 PartitionID partId,
@@ -118,15 +134,34 @@ protected:
 
     void eraseMemoryLock(const std::string& rawKey, int64_t ver);
 
-    nebula::meta::cpp2::IsolationLevel getSpaceIsolationLvel(GraphSpaceID spaceId);
+    virtual nebula::meta::cpp2::IsolationLevel getSpaceIsolationLvel(GraphSpaceID spaceId);
 
     std::string encodeBatch(std::vector<KV>&& data);
 
+    // start resuming the queued locks until FLAGS_toss_resume_concurrency is reached
+    void scheduleResume();
+
+    void onLockResumed(const std::string& lockKey, KV resumed);
+
 protected:
+    struct PendingLock {
+        GraphSpaceID                                    spaceId;
+        size_t                                          vIdLen;
+        bool                                            resuming{false};
+        std::vector<folly::Promise<KV>>                 waiters;
+    };
+
     StorageEnv*                                         env_{nullptr};
     std::shared_ptr<folly::IOThreadPoolExecutor>        exec_;
     std::unique_ptr<storage::InternalStorageClient>     interClient_;
     MemEdgeLocks                                        memLock_;
+
+    std::mutex                                          resumeLock_;
+    // all the locks queued or being resumed
+    std::unordered_map<std::string, PendingLock>        pendingLocks_;
+    // the queued locks of each partition
+    std::map<std::pair<GraphSpaceID, PartitionID>, std::deque<std::string>> queuedLocks_;
+    int32_t                                             numResuming_{0};
 };
 
 }  // namespace storage
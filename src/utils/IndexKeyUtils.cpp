@@ -28,6 +28,8 @@ std::string IndexKeyUtils::encodeValues(std::vector<Value>&& values,
             if (cols[i].type.type == meta::cpp2::PropertyType::FIXED_STRING) {
                 auto len = static_cast<size_t>(*cols[i].type.get_type_length());
                 index.append(encodeValue(values[i], len));
+            } else if (isFullString(cols[i])) {
+                index.append(encodeString(values[i].getStr()));
             } else {
                 index.append(encodeValue(values[i]));
             }
@@ -55,7 +55,81 @@ public:
         return Value::Type::__EMPTY__;
     }
 
+    /**
+     * A string column of an index without the type length keeps the full string, which is
+     * encoded by encodeString. Otherwise the string is truncated or padded to the type length.
+     * */
+    static bool isFullString(const meta::cpp2::ColumnDef& col) {
+        return col.get_type().get_type() == PropertyType::STRING &&
+               !col.get_type().type_length_ref().has_value();
+    }
+
+    /**
+     * A full string starts with the byte kFullString, while its null is the single byte
+     * kFullStringNull, so the null never equals a string and is after all of them, the same as
+     * the padded 0xFF of fixed length strings. In the string, each '\0' is escaped as "\0\xFF",
+     * and "\0\0" terminates it, so the encoded strings are in the same order as the strings, and
+     * the length of an encoded string could be found without knowing the columns after it.
+     * */
+    static constexpr char kFullString = 0x00;
+    static constexpr char kFullStringNull = static_cast<char>(0xFF);
+
+    static std::string encodeString(folly::StringPiece str) {
+        std::string raw;
+        raw.reserve(str.size() + 3);
+        raw.push_back(kFullString);
+        for (auto c : str) {
+            raw.push_back(c);
+            if (c == '\0') {
+                raw.push_back(static_cast<char>(0xFF));
+            }
+        }
+        raw.append(2, '\0');
+        return raw;
+    }
+
+    // Return the length of the string or null encoded at the beginning of raw
+    static size_t encodedStringLen(folly::StringPiece raw) {
+        if (raw.empty() || raw[0] == kFullStringNull) {
+            return std::min(raw.size(), static_cast<size_t>(1));
+        }
+        size_t i = 1;
+        while (i + 1 < raw.size()) {
+            if (raw[i] == '\0') {
+                if (raw[i + 1] == '\0') {
+                    return i + 2;
+                }
+                // escaped '\0'
+                i += 2;
+            } else {
+                i++;
+            }
+        }
+        return raw.size();
+    }
+
+    // Decode the string encoded by encodeString, it must not be the null
+    static std::string decodeString(folly::StringPiece raw) {
+        DCHECK(!raw.empty() && raw[0] == kFullString);
+        std::string str;
+        str.reserve(raw.size());
+        for (size_t i = 1; i < raw.size(); i++) {
+            if (raw[i] == '\0') {
+                if (i + 1 >= raw.size() || raw[i + 1] == '\0') {
+                    break;
+                }
+                // skip the escape byte
+                i++;
+            }
+            str.push_back(raw[i]);
+        }
+        return str;
+    }
+
     static std::string encodeNullValue(Value::Type type, const int16_t* strLen) {
+        if (type == Value::Type::STRING && strLen == nullptr) {
+            return std::string(1, kFullStringNull);
+        }
         size_t len = 0;
         switch (type) {
             case Value::Type::INT: {
@@ -390,7 +464,9 @@ public:
                     break;
                 }
                 case Value::Type::STRING: {
-                    len = *col.type.get_type_length();
+                    len = isFullString(col)
+                        ? encodedStringLen(key.subpiece(offset))
+                        : *col.type.get_type_length();
                     break;
                 }
                 case Value::Type::TIME: {
@@ -417,6 +493,9 @@ public:
             offset += len;
         }
         auto propVal = key.subpiece(offset, len);
+        if (isFullString(*it)) {
+            return Value(decodeString(propVal));
+        }
         return decodeValue(propVal, type);
     }
 
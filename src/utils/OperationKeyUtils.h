@@ -34,6 +34,13 @@ private:
     OperationKeyUtils() = delete;
 };
 
+// When the index is rebuilt by ingest, the first parameter of the job and of its tasks is one of
+// the marks below. In the ingest round every replica builds and ingests the index of its own
+// data, and the leaders replay the operation logs in the replay round, which starts only after
+// all replicas have ingested. They could not be an index name.
+static constexpr char kRebuildIndexIngest[] = "#ingest";
+static constexpr char kRebuildIndexReplay[] = "#replay";
+
 }  // namespace nebula
 
 #endif  // COMMON_BASE_OPERATIONKEYUTILS_H_
@@ -497,6 +497,63 @@ TEST(IndexKeyUtilsTest, getValueFromIndexKeyTest) {
     }
 }
 
+TEST(IndexKeyUtilsTest, fullStringValue) {
+    // The strings are escaped and terminated, in the same order as the raw strings
+    std::vector<std::string> strs = {"", std::string("\0", 1), std::string("\0\0", 2), "a",
+                                     std::string("a\0", 2), "a\x01", "ab", "b", "\xFF"};
+    for (size_t i = 0; i < strs.size(); i++) {
+        auto raw = IndexKeyUtils::encodeString(strs[i]);
+        EXPECT_EQ(raw.size(), IndexKeyUtils::encodedStringLen(raw + "suffix"));
+        EXPECT_EQ(strs[i], IndexKeyUtils::decodeString(raw));
+        if (i > 0) {
+            EXPECT_LT(IndexKeyUtils::encodeString(strs[i - 1]), raw);
+        }
+    }
+
+    // The null is different from any string, and after all of them
+    auto nullRaw = IndexKeyUtils::encodeNullValue(Value::Type::STRING, nullptr);
+    EXPECT_EQ(1, IndexKeyUtils::encodedStringLen(nullRaw + "suffix"));
+    for (const auto& str : strs) {
+        EXPECT_LT(IndexKeyUtils::encodeString(str), nullRaw);
+    }
+    EXPECT_LT(IndexKeyUtils::encodeString(std::string(300, '\xFF')), nullRaw);
+
+    size_t vIdLen = 8;
+    std::vector<meta::cpp2::ColumnDef> cols;
+    {
+        meta::cpp2::ColumnDef col;
+        col.set_name("col_string");
+        col.type.set_type(meta::cpp2::PropertyType::STRING);
+        col.set_nullable(true);
+        cols.emplace_back(col);
+    }
+    {
+        meta::cpp2::ColumnDef col;
+        col.set_name("col_int");
+        col.type.set_type(meta::cpp2::PropertyType::INT64);
+        col.set_nullable(true);
+        cols.emplace_back(col);
+    }
+    ASSERT_TRUE(IndexKeyUtils::isFullString(cols[0]));
+
+    auto null = Value(NullType::__NULL__);
+    std::string longStr(300, 'x');
+    std::vector<std::pair<VertexID, std::vector<Value>>> vertices = {
+        {"1", {Value(longStr), Value(1L)}},
+        {"2", {Value(std::string("a\0b", 3)), Value(2L)}},
+        {"3", {Value(""), null}},
+        {"4", {null, Value(4L)}},
+    };
+    for (auto& row : vertices) {
+        auto values = IndexKeyUtils::encodeValues(std::vector<Value>(row.second), cols);
+        auto key = IndexKeyUtils::vertexIndexKey(vIdLen, 1, 1, row.first, std::move(values));
+        EXPECT_EQ(row.second[0], IndexKeyUtils::getValueFromIndexKey(
+            vIdLen, key, "col_string", cols, false, true));
+        EXPECT_EQ(row.second[1], IndexKeyUtils::getValueFromIndexKey(
+            vIdLen, key, "col_int", cols, false, true));
+    }
+}
+
 }   // namespace nebula
 
 int main(int argc, char** argv) {